@@ -105,7 +105,7 @@ public:
     /// Wait for a incoming connection to port_
     void accept() throw(SocketException);
 
-    void send(const std::vector<unsigned char>) throw(SocketException);
+    void send(const std::vector<unsigned char>&) throw(SocketException);
     void sendExact(const Storage&) throw(SocketException);
     std::vector<unsigned char> receive(int bufSize = 2048) throw(SocketException);
     bool receiveExact(Storage&) throw(SocketException);
@@ -131,6 +131,8 @@ private:
 #endif
     bool atoaddr(std::string, struct in_addr& addr);
     bool datawaiting(int sock) const throw();
+    void sendBytes(const unsigned char* buf, size_t numbytes);
+    void receiveBytes(unsigned char* buf, int numbytes, const char* where);
 
     std::string host_;
     int port_;
@@ -139,6 +141,8 @@ private:
     bool blocking_;
 
     bool verbose_;
+    /// Length header and message of sendExact, reused from one message to the next
+    std::vector<unsigned char> sendBuffer_;
 #ifdef WIN32
     static bool init_windows_sockets_;
     static bool windows_sockets_initialized_;
@@ -0,0 +1,284 @@
+/*
+ * This file is part of the iTETRIS Control System (https://github.com/DLR-TS/ics-transaid)
+ * Copyright (c) 2008-2021 iCS development team and contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+/****************************************************************************************
+ * Micro-benchmark of the encode/decode throughput of tcpip::Storage against the previous
+ * implementation (iterator based storage written byte by byte, with a new[] buffer for
+ * every received message).
+ *
+ * Every message carries the state of a set of nodes, as the mobility updates exchanged
+ * with iCS: identifier, name, position, speed, heading and a list of float samples.
+ * The bytes written by both implementations are compared, the benchmark fails if the
+ * wire format differs.
+ *
+ * Usage: storage-benchmark [nodes per message] [messages]
+ ***************************************************************************************/
+
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "storage.h"
+
+using namespace std;
+
+namespace legacy {
+
+class Storage {
+public:
+    typedef std::vector<unsigned char> StorageType;
+
+    Storage() {
+        iter_ = store.begin();
+        short a = 0x0102;
+        bigEndian_ = (reinterpret_cast<unsigned char*>(&a)[0] == 0x01);
+    }
+    void reset() {
+        store.clear();
+        iter_ = store.begin();
+    }
+    size_t size() const {
+        return store.size();
+    }
+    StorageType::const_iterator begin() const {
+        return store.begin();
+    }
+    StorageType::const_iterator end() const {
+        return store.end();
+    }
+    void writePacket(unsigned char* packet, int length) {
+        store.insert(store.end(), &(packet[0]), &(packet[length]));
+        iter_ = store.begin();
+    }
+    void writeInt(int value) {
+        writeByEndianess(reinterpret_cast<unsigned char*>(&value), 4);
+    }
+    int readInt() {
+        int value = 0;
+        readByEndianess(reinterpret_cast<unsigned char*>(&value), 4);
+        return value;
+    }
+    void writeFloat(float value) {
+        writeByEndianess(reinterpret_cast<unsigned char*>(&value), 4);
+    }
+    float readFloat() {
+        float value = 0;
+        readByEndianess(reinterpret_cast<unsigned char*>(&value), 4);
+        return value;
+    }
+    void writeDouble(double value) {
+        writeByEndianess(reinterpret_cast<unsigned char*>(&value), 8);
+    }
+    double readDouble() {
+        double value = 0;
+        readByEndianess(reinterpret_cast<unsigned char*>(&value), 8);
+        return value;
+    }
+    void writeString(const std::string& s) {
+        writeInt(static_cast<int>(s.length()));
+        store.insert(store.end(), s.begin(), s.end());
+        iter_ = store.begin();
+    }
+    std::string readString() {
+        int len = readInt();
+        StorageType::const_iterator end = iter_;
+        std::advance(end, len);
+        const string tmp(iter_, end);
+        iter_ = end;
+        return tmp;
+    }
+
+private:
+    void writeByEndianess(const unsigned char* begin, unsigned int size) {
+        const unsigned char* end = &(begin[size]);
+        if (bigEndian_) {
+            store.insert(store.end(), begin, end);
+        } else
+            store.insert(store.end(), std::reverse_iterator<const unsigned char*>(end),
+                         std::reverse_iterator<const unsigned char*>(begin));
+        iter_ = store.begin();
+    }
+    void readByEndianess(unsigned char* array, int size) {
+        if (store.end() - iter_ < size) {
+            throw std::invalid_argument("legacy::Storage: not enough bytes");
+        }
+        if (bigEndian_) {
+            for (int i = 0; i < size; ++i) {
+                array[i] = *iter_++;
+            }
+        } else {
+            for (int i = size - 1; i >= 0; --i) {
+                array[i] = *iter_++;
+            }
+        }
+    }
+
+    StorageType store;
+    StorageType::const_iterator iter_;
+    bool bigEndian_;
+};
+
+} /* namespace legacy */
+
+// Float samples carried by every node
+static const int SAMPLES = 16;
+
+struct NodeState {
+    int id;
+    std::string name;
+    double x;
+    double y;
+    float speed;
+    float heading;
+    float samples[SAMPLES];
+};
+
+static void Encode(legacy::Storage& out, const vector<NodeState>& nodes) {
+    out.reset();
+    out.writeInt(static_cast<int>(nodes.size()));
+    for (vector<NodeState>::const_iterator it = nodes.begin(); it != nodes.end(); ++it) {
+        out.writeInt(it->id);
+        out.writeString(it->name);
+        out.writeDouble(it->x);
+        out.writeDouble(it->y);
+        out.writeFloat(it->speed);
+        out.writeFloat(it->heading);
+        for (int i = 0; i < SAMPLES; ++i) {
+            out.writeFloat(it->samples[i]);
+        }
+    }
+}
+
+static void Encode(tcpip::Storage& out, const vector<NodeState>& nodes) {
+    out.reset();
+    out.writeInt(static_cast<int>(nodes.size()));
+    for (vector<NodeState>::const_iterator it = nodes.begin(); it != nodes.end(); ++it) {
+        out.writeInt(it->id);
+        out.writeString(it->name);
+        out.writeDouble(it->x);
+        out.writeDouble(it->y);
+        out.writeFloat(it->speed);
+        out.writeFloat(it->heading);
+        out.writeFloatArray(it->samples, SAMPLES);
+    }
+}
+
+/// Receives the bytes as the previous ServerSocket::receiveExact did, then decodes them
+static double Decode(legacy::Storage& in, const unsigned char* wire, int length) {
+    unsigned char* buf = new unsigned char[length];
+    memcpy(buf, wire, length);
+    in.reset();
+    in.writePacket(buf, length);
+    delete[] buf;
+
+    double checksum = 0;
+    int count = in.readInt();
+    for (int n = 0; n < count; ++n) {
+        checksum += in.readInt();
+        checksum += in.readString().size();
+        checksum += in.readDouble() + in.readDouble();
+        checksum += in.readFloat() + in.readFloat();
+        for (int i = 0; i < SAMPLES; ++i) {
+            checksum += in.readFloat();
+        }
+    }
+    return checksum;
+}
+
+/// Receives the bytes in the reused buffer of the storage, then decodes them
+static double Decode(tcpip::Storage& in, const unsigned char* wire, int length) {
+    memcpy(in.prepareReceive(length), wire, length);
+
+    double checksum = 0;
+    float samples[SAMPLES];
+    const char* name;
+    unsigned int nameLength;
+    int count = in.readInt();
+    for (int n = 0; n < count; ++n) {
+        checksum += in.readInt();
+        in.readStringData(name, nameLength);
+        checksum += nameLength;
+        checksum += in.readDouble() + in.readDouble();
+        checksum += in.readFloat() + in.readFloat();
+        in.readFloatArray(samples, SAMPLES);
+        for (int i = 0; i < SAMPLES; ++i) {
+            checksum += samples[i];
+        }
+    }
+    return checksum;
+}
+
+template<class Storage>
+static double Measure(const char* name, const vector<NodeState>& nodes, int messages, vector<unsigned char>& wire) {
+    Storage out;
+    Storage in;
+    double checksum = 0;
+    clock_t start = clock();
+    for (int m = 0; m < messages; ++m) {
+        Encode(out, nodes);
+        wire.assign(out.begin(), out.end());
+        checksum += Decode(in, &wire[0], static_cast<int>(wire.size()));
+    }
+    double seconds = double(clock() - start) / CLOCKS_PER_SEC;
+    double megabytes = double(wire.size()) * messages / (1024 * 1024);
+    cout << name << ": " << messages << " messages of " << wire.size() << " bytes in " << seconds << " s";
+    if (seconds > 0) {
+        cout << " (" << megabytes / seconds << " MB/s)";
+    }
+    cout << ", checksum " << checksum << endl;
+    return seconds;
+}
+
+int main(int argc, char** argv) {
+    int nodeCount = argc > 1 ? atoi(argv[1]) : 500;
+    int messages = argc > 2 ? atoi(argv[2]) : 2000;
+    if (nodeCount <= 0 || messages <= 0) {
+        cerr << "Usage: " << argv[0] << " [nodes per message] [messages]" << endl;
+        return EXIT_FAILURE;
+    }
+    srand(1);
+    vector<NodeState> nodes(nodeCount);
+    for (int n = 0; n < nodeCount; ++n) {
+        NodeState& node = nodes[n];
+        node.id = n;
+        node.name = "veh" + to_string(n);
+        node.x = rand() % 100000 / 10.0;
+        node.y = rand() % 100000 / 10.0;
+        node.speed = rand() % 400 / 10.0f;
+        node.heading = rand() % 3600 / 10.0f;
+        for (int i = 0; i < SAMPLES; ++i) {
+            node.samples[i] = rand() % 1000 / 7.0f - 50;
+        }
+    }
+    cout << nodeCount << " nodes per message, " << messages << " messages" << endl;
+    vector<unsigned char> legacyWire;
+    vector<unsigned char> wire;
+    double legacySeconds = Measure<legacy::Storage>("iterator storage", nodes, messages, legacyWire);
+    double seconds = Measure<tcpip::Storage>("reusable storage", nodes, messages, wire);
+    if (wire != legacyWire) {
+        cerr << "The encoded messages differ" << endl;
+        return EXIT_FAILURE;
+    }
+    if (seconds > 0) {
+        cout << "speed-up: " << legacySeconds / seconds << endl;
+    }
+    return EXIT_SUCCESS;
+}
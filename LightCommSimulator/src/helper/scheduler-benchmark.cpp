@@ -0,0 +1,216 @@
+/*
+ * This file is part of the iTETRIS Control System (https://github.com/DLR-TS/ics-transaid)
+ * Copyright (c) 2008-2021 iCS development team and contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+/****************************************************************************************
+ * Micro-benchmark of the LightComm scheduler against the previous implementation
+ * (multiset of events with linear Cancel and IsRunning).
+ *
+ * The workload mimics the periodic CAMs of the server: every sender reschedules its
+ * transmission each period and, at every simulation step, some senders are stopped
+ * (Cancel) and restarted, as done by StopSendingCam and StartSendingCam.
+ *
+ * Usage: scheduler-benchmark [senders] [steps]
+ ***************************************************************************************/
+
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <set>
+#include <vector>
+#include "scheduler.h"
+
+using namespace std;
+
+namespace legacy {
+
+typedef unsigned event_id;
+
+class EventCallBack {
+public:
+    virtual ~EventCallBack() {
+    }
+    virtual void invoke() = 0;
+};
+
+template<class Class, class Parameter>
+class EventCallBackImpl : public EventCallBack {
+    typedef void (Class::*Method)(Parameter);
+public:
+    EventCallBackImpl(Class* instance, Method method, Parameter arg) {
+        m_instance = instance;
+        m_method = method;
+        m_arg = arg;
+    }
+    void invoke() {
+        (m_instance->*m_method)(m_arg);
+    }
+protected:
+    Class* m_instance;
+    Method m_method;
+    Parameter m_arg;
+};
+
+class Event {
+public:
+    Event(double time, EventCallBack* callBack) :
+        m_id(++CurrentId), m_time(time), m_callBack(callBack) {
+    }
+    ~Event() {
+        delete m_callBack;
+    }
+    event_id m_id;
+    double m_time;
+    EventCallBack* m_callBack;
+    static event_id CurrentId;
+};
+
+event_id Event::CurrentId = 0;
+
+struct EventOrdering {
+    bool operator()(const Event* left, const Event* right) {
+        return left->m_time < right->m_time;
+    }
+};
+
+class Scheduler {
+public:
+    static void Cancel(event_id& id) {
+        if (id == 0) {
+            return;
+        }
+        for (multiset<Event*>::iterator it = m_list.begin(); it != m_list.end(); ++it) {
+            if ((*it)->m_id == id) {
+                if (id != m_currentInvoke) {
+                    delete *it;
+                    m_list.erase(it);
+                }
+                id = 0;
+                return;
+            }
+        }
+    }
+    static int Notify(int currentTime) {
+        int number = 0;
+        for (multiset<Event*>::iterator it = m_list.begin(); it != m_list.end();) {
+            Event* e = *it;
+            if (currentTime >= e->m_time) {
+                m_currentInvoke = e->m_id;
+                e->m_callBack->invoke();
+                ++number;
+                delete e;
+                m_list.erase(it++);
+            } else {
+                break;
+            }
+        }
+        m_currentInvoke = 0;
+        return number;
+    }
+    template<typename Method, class Class, typename Parameter>
+    static event_id Schedule(double time, Method function, Class* instance, Parameter arg) {
+        EventCallBack* cb = new EventCallBackImpl<Class, Parameter>(instance, function, arg);
+        Event* e = new Event(time, cb);
+        m_list.insert(e);
+        return e->m_id;
+    }
+private:
+    static multiset<Event*, EventOrdering> m_list;
+    static event_id m_currentInvoke;
+};
+
+multiset<Event*, EventOrdering> Scheduler::m_list;
+event_id Scheduler::m_currentInvoke = 0;
+
+} /* namespace legacy */
+
+// Step of the simulation and period of the transmissions, in the units of the scheduler
+static const int STEP = 100;
+static const int PERIOD = 1000;
+// Senders stopped and restarted at each step, per thousand
+static const int RESTARTS_PER_THOUSAND = 10;
+
+/**
+ * @brief Periodic senders driven by the scheduler given as template argument
+ */
+template<class Scheduler, typename EventId>
+class CamWorkload {
+public:
+    CamWorkload(int senders) : m_now(0), m_transmissions(0), m_events(senders, 0) {
+    }
+
+    void Start(int sender) {
+        m_events[sender] = Scheduler::Schedule(m_now + 1 + rand() % PERIOD, &CamWorkload::Transmit, this, sender);
+    }
+
+    void Transmit(int sender) {
+        ++m_transmissions;
+        m_events[sender] = Scheduler::Schedule(m_now + PERIOD, &CamWorkload::Transmit, this, sender);
+    }
+
+    long Run(int steps) {
+        int senders = m_events.size();
+        for (int sender = 0; sender < senders; ++sender) {
+            Start(sender);
+        }
+        int restarts = senders * RESTARTS_PER_THOUSAND / 1000;
+        for (int step = 0; step < steps; ++step) {
+            m_now += STEP;
+            Scheduler::Notify(m_now);
+            for (int i = 0; i < restarts; ++i) {
+                int sender = rand() % senders;
+                Scheduler::Cancel(m_events[sender]);
+                Start(sender);
+            }
+        }
+        for (int sender = 0; sender < senders; ++sender) {
+            Scheduler::Cancel(m_events[sender]);
+        }
+        return m_transmissions;
+    }
+
+private:
+    int m_now;
+    long m_transmissions;
+    std::vector<EventId> m_events;
+};
+
+template<class Scheduler, typename EventId>
+static double Measure(const char* name, int senders, int steps) {
+    srand(1);
+    CamWorkload<Scheduler, EventId> workload(senders);
+    clock_t start = clock();
+    long transmissions = workload.Run(steps);
+    double seconds = double(clock() - start) / CLOCKS_PER_SEC;
+    cout << name << ": " << transmissions << " transmissions in " << seconds << " s" << endl;
+    return seconds;
+}
+
+int main(int argc, char** argv) {
+    int senders = argc > 1 ? atoi(argv[1]) : 5000;
+    int steps = argc > 2 ? atoi(argv[2]) : 100;
+    if (senders <= 0 || steps <= 0) {
+        cerr << "Usage: " << argv[0] << " [senders] [steps]" << endl;
+        return EXIT_FAILURE;
+    }
+    cout << senders << " senders, " << steps << " steps" << endl;
+    double legacySeconds = Measure<legacy::Scheduler, legacy::event_id>("multiset scheduler", senders, steps);
+    double heapSeconds = Measure<lightcomm::Scheduler, lightcomm::event_id>("indexed heap scheduler", senders, steps);
+    if (heapSeconds > 0) {
+        cout << "speed-up: " << legacySeconds / heapSeconds << endl;
+    }
+    return EXIT_SUCCESS;
+}
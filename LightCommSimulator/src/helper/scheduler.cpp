@@ -26,11 +26,38 @@ using namespace std;
 
 namespace lightcomm {
 
+//  EventPool
+// Granularity of the block sizes, enough for the alignment of any event or callback
+static const size_t BLOCK_ALIGNMENT = 16;
+
+vector<vector<void*> > EventPool::m_freeBlocks;
+
+void* EventPool::Allocate(size_t size) {
+    size_t units = (size + BLOCK_ALIGNMENT - 1) / BLOCK_ALIGNMENT;
+    if (units < m_freeBlocks.size() && !m_freeBlocks[units].empty()) {
+        void* block = m_freeBlocks[units].back();
+        m_freeBlocks[units].pop_back();
+        return block;
+    }
+    return ::operator new(units * BLOCK_ALIGNMENT);
+}
+
+void EventPool::Release(void* block, size_t size) {
+    if (block == NULL) {
+        return;
+    }
+    size_t units = (size + BLOCK_ALIGNMENT - 1) / BLOCK_ALIGNMENT;
+    if (units >= m_freeBlocks.size()) {
+        m_freeBlocks.resize(units + 1);
+    }
+    m_freeBlocks[units].push_back(block);
+}
+
 //  Event
 event_id Event::CurrentId = 0;
 
 Event::Event(double time, EventCallBack* callBack) :
-    m_id(++CurrentId), m_time(time), m_callBack(callBack) {
+    m_id(++CurrentId), m_time(time), m_callBack(callBack), m_heapIndex(0) {
 }
 
 Event::~Event() {
@@ -39,11 +66,15 @@ Event::~Event() {
 
 //  EventOrdering
 bool EventOrdering::operator()(const Event* left, const Event* right) {
-    return left->m_time < right->m_time;
+    if (left->m_time != right->m_time) {
+        return left->m_time < right->m_time;
+    }
+    return left->m_id < right->m_id;
 }
 
 //  Scheduler
-multiset<Event*, EventOrdering> Scheduler::m_list;
+vector<Event*> Scheduler::m_heap;
+map<event_id, Event*> Scheduler::m_events;
 event_id Scheduler::m_currentInvoke = 0;
 double Scheduler::m_currentTime = 0;
 
@@ -51,45 +82,39 @@ void Scheduler::Cancel(event_id& id) {
     if (id == 0) {
         return;
     }
-    for (multiset<Event*>::iterator it = m_list.begin(); it != m_list.end(); ++it) {
-        if ((*it)->m_id == id) {
-            //Can't cancel the current invocation here. Will be removed at the end of the invocation by the Notify
-            if (id != m_currentInvoke) {
-                delete *it;
-                m_list.erase(it);
-            }
-            //Set it to zero so subsequent calls will avoid entering the loop
-            id = 0;
-            return;
+    map<event_id, Event*>::iterator it = m_events.find(id);
+    if (it != m_events.end()) {
+        //Can't cancel the current invocation here. Will be removed at the end of the invocation by the Notify
+        if (id != m_currentInvoke) {
+            Event* e = it->second;
+            m_events.erase(it);
+            Remove(e);
+            delete e;
         }
+        //Set it to zero so subsequent calls will avoid the lookup
+        id = 0;
     }
 }
 
 int Scheduler::Notify(int currentTime) {
 
     int number = 0;
-    for (multiset<Event*>::iterator it = m_list.begin(); it != m_list.end();) {
-        Event* e = *it;
-        if (currentTime >= e->m_time) {
-            //I need to save the id of the current invocation so I don't remove it in Cancel
-            m_currentInvoke = e->m_id;
-            m_currentTime = e->m_time;
-            e->m_callBack->invoke();
-            ++number;
-            delete e;
-            m_list.erase(it++);
-        } else {
-            //The elements are ordered by time so I can exit the loop the first time the condition is not satisfied
-            break;
-        }
+    //The top of the heap is the next event, stop at the first one in the future
+    while (!m_heap.empty() && currentTime >= m_heap.front()->m_time) {
+        Event* e = m_heap.front();
+        Remove(e);
+        //I need to save the id of the current invocation so I don't remove it in Cancel
+        m_currentInvoke = e->m_id;
+        m_currentTime = e->m_time;
+        e->m_callBack->invoke();
+        ++number;
+        m_events.erase(e->m_id);
+        delete e;
     }
     //Zero is invalid as Id
     m_currentInvoke = 0;
     m_currentTime = currentTime;
 
-    if (m_list.size() > 0) {
-        Event* begin = *(m_list.begin());
-    }
     return number;
 }
 
@@ -97,16 +122,69 @@ bool Scheduler::IsRunning(event_id id) {
     if (id == 0) {
         return false;
     }
-    for (multiset<Event*>::iterator it = m_list.begin(); it != m_list.end(); ++it) {
-        if ((*it)->m_id == id) {
-            return true;
-        }
-    }
-    return false;
+    return m_events.find(id) != m_events.end();
 }
 
 double Scheduler::GetCurrentTime() {
     return m_currentTime;
 }
 
+void Scheduler::Insert(Event* e) {
+    m_events[e->m_id] = e;
+    m_heap.push_back(e);
+    SiftUp(m_heap.size() - 1);
+}
+
+void Scheduler::Remove(Event* e) {
+    size_t index = e->m_heapIndex;
+    Event* last = m_heap.back();
+    m_heap.pop_back();
+    if (last != e) {
+        //Move the last event to the hole and restore the heap order in the direction it is violated
+        Place(last, index);
+        SiftUp(index);
+        SiftDown(last->m_heapIndex);
+    }
+}
+
+void Scheduler::SiftUp(size_t index) {
+    Event* e = m_heap[index];
+    EventOrdering before;
+    while (index > 0) {
+        size_t parent = (index - 1) / 2;
+        if (!before(e, m_heap[parent])) {
+            break;
+        }
+        Place(m_heap[parent], index);
+        index = parent;
+    }
+    Place(e, index);
+}
+
+void Scheduler::SiftDown(size_t index) {
+    Event* e = m_heap[index];
+    EventOrdering before;
+    size_t size = m_heap.size();
+    while (true) {
+        size_t child = 2 * index + 1;
+        if (child >= size) {
+            break;
+        }
+        if (child + 1 < size && before(m_heap[child + 1], m_heap[child])) {
+            ++child;
+        }
+        if (!before(m_heap[child], e)) {
+            break;
+        }
+        Place(m_heap[child], index);
+        index = child;
+    }
+    Place(e, index);
+}
+
+void Scheduler::Place(Event* e, size_t index) {
+    m_heap[index] = e;
+    e->m_heapIndex = index;
+}
+
 } /* namespace lightcomm */
@@ -22,7 +22,8 @@
 #ifndef SCHEDULER_H_
 #define SCHEDULER_H_
 
-#include <set>
+#include <cstddef>
+#include <map>
 #include <vector>
 #include "current-time.h"
 #include "log/log.h"
@@ -30,11 +31,31 @@
 namespace lightcomm {
 typedef unsigned event_id;
 
+/**
+ * @brief Fixed-size blocks recycled between the events and the callbacks, so that scheduling does not hit the heap
+ */
+class EventPool {
+public:
+    static void* Allocate(std::size_t size);
+    static void Release(void* block, std::size_t size);
+private:
+    // Free blocks by size in units of the alignment
+    static std::vector<std::vector<void*> > m_freeBlocks;
+};
+
 class EventCallBack {
 public:
     virtual ~EventCallBack() {
     }
     virtual void invoke() = 0;
+
+    static void* operator new(std::size_t size) {
+        return EventPool::Allocate(size);
+    }
+    // The destructor is virtual, size is the one of the derived callback
+    static void operator delete(void* block, std::size_t size) {
+        EventPool::Release(block, size);
+    }
 };
 
 template<class Class, class Parameter = void>
@@ -76,13 +97,25 @@ public:
     Event(double time, EventCallBack* callBack);
     virtual ~Event();
 
+    static void* operator new(std::size_t size) {
+        return EventPool::Allocate(size);
+    }
+    static void operator delete(void* block, std::size_t size) {
+        EventPool::Release(block, size);
+    }
+
     event_id m_id;
     double m_time;
     EventCallBack* m_callBack;
+    // Position of the event in the heap of the scheduler
+    std::size_t m_heapIndex;
 private:
     static event_id CurrentId;
 };
 
+/**
+ * @brief Orders the events by time, and the events with the same time by scheduling order
+ */
 struct EventOrdering {
     bool operator()(const Event* left, const Event* right);
 };
@@ -99,7 +132,7 @@ public:
 
         EventCallBack* cb = new EventCallBackImpl<Class>(instance, function);
         Event* e = new Event(time, cb);
-        m_list.insert(e);
+        Insert(e);
         return e->m_id;
     }
     template<typename Method, class Class, typename Parameter>
@@ -108,17 +141,26 @@ public:
 
         EventCallBack* cb = new EventCallBackImpl<Class, Parameter>(instance, function, arg);
         Event* e = new Event(time, cb);
-        m_list.insert(e);
+        Insert(e);
         return e->m_id;
     }
 private:
-    static std::multiset<Event*, EventOrdering> m_list;
+    // Binary min-heap of the pending events
+    static std::vector<Event*> m_heap;
+    // Pending events by id, to cancel them in logarithmic time
+    static std::map<event_id, Event*> m_events;
     static event_id m_currentInvoke;
     static double m_currentTime;
 
     Scheduler();
     ~Scheduler();
     static void updateAfterNotify();
+
+    static void Insert(Event* e);
+    static void Remove(Event* e);
+    static void SiftUp(std::size_t index);
+    static void SiftDown(std::size_t index);
+    static void Place(Event* e, std::size_t index);
 };
 
 } /* namespace lightcomm */
@@ -120,6 +120,9 @@
 // command: get all the messages from all the active nodes
 #define CMD_GET_ALL_RECEIVED_MESSAGES 0x17
 
+// command: update position, speed, heading and lane of several nodes with a single message
+#define CMD_UPDATENODES2 0x18
+
 // command: close
 #define CMD_CLOSE 0x7F
 
@@ -45,6 +45,9 @@ namespace server {
 using namespace std;
 using namespace tcpip;
 
+// Transmission range of vehicles and RSUs, increased to assure all messages are received. It is also the size of the cells of the grid of nodes
+const float TX_RANGE = 1500;
+
 Server* Server::m_instance;
 bool Server::m_closeConnection;
 
@@ -135,6 +138,10 @@ int Server::dispatchCommand() {
 
             success = UpdateNodePosition2();
             break;
+        case CMD_UPDATENODES2:
+
+            success = UpdateNodePositions2();
+            break;
         case CMD_CREATENODE:
 
             success = CreateNode();
@@ -266,7 +273,7 @@ bool Server::CreateNode(void) {
 
     nodeId++;
 
-    m_NodeMap.operator [](nodeId)  = nodeData;
+    SetNodePosition(nodeId, nodeData.posX, nodeData.posY).type = nodeData.type;
 
     writeStatusCmd(CMD_CREATENODE, RTYPE_OK, "CreateNode()");
     m_outputStorage.writeUnsignedByte(1 + 1 + 4);
@@ -289,7 +296,7 @@ bool Server::CreateNode2(void) {
 
     nodeId++;
 
-    m_NodeMap.operator [](nodeId)  = nodeData;
+    SetNodePosition(nodeId, nodeData.posX, nodeData.posY).type = nodeData.type;
 
     writeStatusCmd(CMD_CREATENODE2, RTYPE_OK, "CreateNode2()");
     m_outputStorage.writeUnsignedByte(1 + 1 + 4);
@@ -306,7 +313,7 @@ bool Server::UpdateNodePosition() {
     nodeData.posX = m_inputStorage.readFloat();
     nodeData.posY = m_inputStorage.readFloat();
 
-    m_NodeMap.operator [](nodeId)  = nodeData;
+    SetNodePosition(nodeId, nodeData.posX, nodeData.posY);
 
     writeStatusCmd(CMD_UPDATENODE, RTYPE_OK, "UpdateNodePosition()");
 
@@ -323,13 +330,33 @@ bool Server::UpdateNodePosition2() {
     m_inputStorage.readFloat(); // read heading
     m_inputStorage.readString(); // read laneId
 
-    m_NodeMap.operator [](nodeId)  = nodeData;
+    SetNodePosition(nodeId, nodeData.posX, nodeData.posY);
 
     writeStatusCmd(CMD_UPDATENODE2, RTYPE_OK, "UpdateNodePosition2()");
 
     return true;
 }
 
+bool Server::UpdateNodePositions2() {
+    int number = m_inputStorage.readInt();
+    for (int i = 0; i < number; ++i) {
+        int nodeId = m_inputStorage.readInt();
+        NodeData nodeData;
+        nodeData.posX = m_inputStorage.readFloat();
+        nodeData.posY = m_inputStorage.readFloat();
+
+        m_inputStorage.readFloat(); // read speed
+        m_inputStorage.readFloat(); // read heading
+        m_inputStorage.readString(); // read laneId
+
+        SetNodePosition(nodeId, nodeData.posX, nodeData.posY);
+    }
+
+    writeStatusCmd(CMD_UPDATENODES2, RTYPE_OK, "UpdateNodePositions2()");
+
+    return true;
+}
+
 bool Server::ActivateNode(void) {
     int number = m_inputStorage.readInt();
     for (int i = 0; i < number; ++i) {
@@ -344,7 +371,7 @@ bool Server::DeactivateNode(void) {
     int number = m_inputStorage.readInt();
     for (int i = 0; i < number; ++i) {
         int nodeId = m_inputStorage.readInt();
-        m_NodeMap.erase(nodeId);
+        RemoveNode(nodeId);
 
     }
     writeStatusCmd(CMD_DEACTIVATE_NODE, RTYPE_OK, "DeactivateNode()");
@@ -426,7 +453,7 @@ bool Server::GetAllReceivedMessages() {
 
 
 
-    std::map<int, std::vector<Server::Message> >::iterator rx_it;
+    std::map<int, std::vector<int> >::iterator rx_it;
     for (rx_it = m_GeneralReceivedMessageMap.begin(); rx_it != m_GeneralReceivedMessageMap.end(); rx_it++) {
 
         int numMessages = rx_it->second.size();
@@ -434,12 +461,12 @@ bool Server::GetAllReceivedMessages() {
         messageStorage.writeInt(rx_it->first);
         messageStorage.writeInt(numMessages);
 
-        std::vector<Message>* receivedMessages = &rx_it->second;
-        for (std::vector<Server::Message>::iterator receivedIterator = receivedMessages->begin();
+        std::vector<int>* receivedMessages = &rx_it->second;
+        for (std::vector<int>::iterator receivedIterator = receivedMessages->begin();
                 receivedIterator != receivedMessages->end(); ++receivedIterator) {
 
 
-            Server::Message receivedMessage = *receivedIterator;
+            const Server::Message& receivedMessage = m_MessageStore[*receivedIterator];
 
             messageStorage.writeInt(receivedMessage.senderId);
 
@@ -451,18 +478,14 @@ bool Server::GetAllReceivedMessages() {
 
             messageStorage.writeInt(receivedMessage.sequenceNumber);
 
-            receivedMessage.packetTagContainer =  new tcpip::Storage();
-
-            messageStorage.writeShort(receivedMessage.packetTagContainer->size());
-
-            messageStorage.writeStorage(*receivedMessage.packetTagContainer);
-
-            delete receivedMessage.packetTagContainer;
+            // The messages carry no packet tags, an empty container is sent
+            messageStorage.writeShort(0);
         }
 
     }
 
     m_GeneralReceivedMessageMap.clear();
+    m_MessageStore.clear();
 
     writeStatusCmd(CMD_GET_ALL_RECEIVED_MESSAGES, RTYPE_OK, "GetReceivedMessages()");
     m_outputStorage.writeInt(4 + 1 + 4 + messageStorage.size());
@@ -509,14 +532,16 @@ void Server::ScheduleMessageTx(Message msg) {
 
     msg.timeStep = CurrentTimeStep();
 
-    std::vector<int> receivers;
-    receivers = GetReceivers(msg.senderId);
-
+    GetReceivers(msg.senderId, m_receivers);
 
-    for (vector<int>::iterator receivedIterator = receivers.begin(); receivedIterator != receivers.end(); ++receivedIterator) {
-        int node = *receivedIterator;
-        m_GeneralReceivedMessageMap.operator[](node).push_back(msg);
+    if (!m_receivers.empty()) {
+        int messageIndex = m_MessageStore.size();
+        m_MessageStore.push_back(msg);
+        for (vector<int>::iterator receivedIterator = m_receivers.begin(); receivedIterator != m_receivers.end(); ++receivedIterator) {
+            int node = *receivedIterator;
+            m_GeneralReceivedMessageMap.operator[](node).push_back(messageIndex);
 
+        }
     }
 
     if (msg.frequency > 0 && msg.messageType == "CAM") { // Before was set to O for the CAM transmission
@@ -527,35 +552,90 @@ void Server::ScheduleMessageTx(Message msg) {
 }
 
 
-std::vector<int> Server::GetReceivers(int nodeId) {
-
-    std::vector<int> receivers;
+void Server::GetReceivers(int nodeId, std::vector<int>& receivers) {
 
-    NodeData txData;
-    txData = m_NodeMap[nodeId];
+    receivers.clear();
 
-    float range;
-    if (txData.type == "RSU") {
-        range = 1500; // increased to assure all message from RSU are received
-    } else {
-        range = 1500; // increased to assure all messages are received
+    std::map<int, NodeData>::iterator txIt = m_NodeMap.find(nodeId);
+    if (txIt == m_NodeMap.end()) {
+        // The sender has been deactivated
+        return;
     }
+    const NodeData& txData = txIt->second;
 
-    float distance;
+    // The range is not larger than the cell size, the receivers are in the cell of the sender or in its neighbours
+    float range = TX_RANGE;
+    float rangeSquared = range * range;
 
-    for (std::map<int, NodeData>::iterator nodeIt = m_NodeMap.begin(); nodeIt != m_NodeMap.end(); ++nodeIt) {
+    for (int column = txData.cell.first - 1; column <= txData.cell.first + 1; ++column) {
+        for (int row = txData.cell.second - 1; row <= txData.cell.second + 1; ++row) {
+            std::map<CellId, std::vector<int> >::const_iterator cellIt = m_Grid.find(CellId(column, row));
+            if (cellIt == m_Grid.end()) {
+                continue;
+            }
+            for (std::vector<int>::const_iterator nodeIt = cellIt->second.begin(); nodeIt != cellIt->second.end(); ++nodeIt) {
 
-        if (nodeIt->first != nodeId) {
+                if (*nodeIt != nodeId) {
 
-            distance = sqrt(pow(txData.posX - nodeIt->second.posX, 2) + pow(txData.posY - nodeIt->second.posY, 2));
+                    const NodeData& rxData = m_NodeMap[*nodeIt];
+                    float dx = txData.posX - rxData.posX;
+                    float dy = txData.posY - rxData.posY;
 
-            if (distance <= range) {
-                receivers.push_back(nodeIt->first);
+                    if (dx * dx + dy * dy <= rangeSquared) {
+                        receivers.push_back(*nodeIt);
+                    }
+                }
             }
         }
     }
+}
+
+Server::NodeData& Server::SetNodePosition(int nodeId, float posX, float posY) {
+    CellId cell = GetCell(posX, posY);
+    std::map<int, NodeData>::iterator nodeIt = m_NodeMap.find(nodeId);
+    if (nodeIt == m_NodeMap.end()) {
+        NodeData nodeData;
+        nodeData.cell = cell;
+        nodeIt = m_NodeMap.insert(std::make_pair(nodeId, nodeData)).first;
+        m_Grid[cell].push_back(nodeId);
+    } else if (nodeIt->second.cell != cell) {
+        RemoveFromCell(nodeId, nodeIt->second.cell);
+        nodeIt->second.cell = cell;
+        m_Grid[cell].push_back(nodeId);
+    }
+    nodeIt->second.posX = posX;
+    nodeIt->second.posY = posY;
+    return nodeIt->second;
+}
+
+void Server::RemoveNode(int nodeId) {
+    std::map<int, NodeData>::iterator nodeIt = m_NodeMap.find(nodeId);
+    if (nodeIt != m_NodeMap.end()) {
+        RemoveFromCell(nodeId, nodeIt->second.cell);
+        m_NodeMap.erase(nodeIt);
+    }
+}
 
-    return receivers;
+Server::CellId Server::GetCell(float posX, float posY) const {
+    return CellId((int) floor(posX / TX_RANGE), (int) floor(posY / TX_RANGE));
+}
+
+void Server::RemoveFromCell(int nodeId, const CellId& cell) {
+    std::map<CellId, std::vector<int> >::iterator cellIt = m_Grid.find(cell);
+    if (cellIt == m_Grid.end()) {
+        return;
+    }
+    std::vector<int>& nodes = cellIt->second;
+    for (std::vector<int>::iterator it = nodes.begin(); it != nodes.end(); ++it) {
+        if (*it == nodeId) {
+            *it = nodes.back();
+            nodes.pop_back();
+            break;
+        }
+    }
+    if (nodes.empty()) {
+        m_Grid.erase(cellIt);
+    }
 }
 
 
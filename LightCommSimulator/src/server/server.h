@@ -28,6 +28,8 @@
 #include "tcpip/server-socket.h"
 #include "tcpip/storage.h"
 #include "scheduler.h"
+#include <map>
+#include <vector>
 
 
 
@@ -73,6 +75,11 @@ private:
      */
     bool UpdateNodePosition2();
 
+    /**
+     * @brief Update position, speed, heading and laneId of a list of nodes, answered with a single status
+     */
+    bool UpdateNodePositions2();
+
 
     /**
      * @brief Activate a node and all its communication modules, e.g. PHY layer
@@ -184,23 +191,45 @@ private:
     } typedef Message;
 
 
+    // Cell of the grid of nodes (column, row)
+    typedef std::pair<int, int> CellId;
+
     struct NodeData {
         float posX;
         float posY;
         std::string type;
+        CellId cell;
     };
 
-    // Table that stores all the received messages
-    std::map<int, std::vector<Message> > m_GeneralReceivedMessageMap;
+    // Messages transmitted since the last retrieval, stored once and referenced by their index from the receivers
+    std::vector<Message> m_MessageStore;
+
+    // Table that stores the indexes in m_MessageStore of the messages received by each node
+    std::map<int, std::vector<int> > m_GeneralReceivedMessageMap;
 
     // Table that stores the nodeId and the position of the node
     std::map<int, NodeData> m_NodeMap;
 
+    // Uniform grid of the nodes with cells of the size of the transmission range, so that the receivers
+    // of a transmission are searched only in the cell of the sender and in its neighbours
+    std::map<CellId, std::vector<int> > m_Grid;
+
     // Table that stores the event_id of the CAM scheduled
     std::map<int, event_id> m_CAMeventIDMap;
 
+    // Buffer for the receivers of the current transmission
+    std::vector<int> m_receivers;
+
     void ScheduleMessageTx(Message msg);
-    std::vector<int> GetReceivers(int nodeId);
+    void GetReceivers(int nodeId, std::vector<int>& receivers);
+
+    /**
+     * @brief Set the position of a node, creating it if it does not exist, and keep the grid up to date
+     */
+    NodeData& SetNodePosition(int nodeId, float posX, float posY);
+    void RemoveNode(int nodeId);
+    CellId GetCell(float posX, float posY) const;
+    void RemoveFromCell(int nodeId, const CellId& cell);
 };
 
 } /* namespace server */
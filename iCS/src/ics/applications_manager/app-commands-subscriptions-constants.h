@@ -54,6 +54,9 @@
 // command: inform app about current simulation step
 #define CMD_NEW_SIMSTEP 0x16 // 22
 
+// command: negotiate the batched protocol mode (the commands of several nodes are sent in a single message)
+#define CMD_BATCH_MODE 0x1A // 26
+
 // command create new node
 #define CMD_CREATE_MOBILE_NODE 0x01
 
@@ -94,6 +94,8 @@ namespace ics {
 
 AppMessageManager::AppMessageManager(SyncManager* syncManager) {
     this->m_syncManager = syncManager;
+    m_batchMode = false;
+    m_batchOpen = false;
 }
 
 // ===========================================================================
@@ -108,6 +110,7 @@ bool AppMessageManager::Connect(string host, int port) {
         try {
             cout << "iCS --> Trying " << i << " to connect Application on port " << port << "..." << endl;
             m_socket->connect();
+            m_batchMode = NegotiateBatchMode();
             return true;
         } catch (exception& e) {
             cout << "iCS --> No connection to Application; waiting..." << endl;
@@ -339,19 +342,7 @@ bool AppMessageManager::CommandGetNewSubscriptions(int nodeId, int appId, vector
         cout << "Node id 0" << endl;
     }
 
-    // send request message
-    try {
-        m_socket->sendExact(outMsg);
-    } catch (SocketException& e) {
-        cout << "iCS --> #Error while sending command to Application: " << e.what() << endl;
-        return false;
-    }
-
-    // receive answer message
-    try {
-        m_socket->receiveExact(inMsg);
-    } catch (SocketException& e) {
-        cout << "iCS --> #Error while receiving response from Application: " << e.what() << endl;
+    if (!SendAndReceive(outMsg, inMsg)) {
         return false;
     }
 
@@ -360,6 +351,11 @@ bool AppMessageManager::CommandGetNewSubscriptions(int nodeId, int appId, vector
         return false;
     }
 
+    return ReadNewSubscription(inMsg, nodeId, appId, subscriptions, noMoreSubs);
+}
+
+bool AppMessageManager::ReadNewSubscription(tcpip::Storage& inMsg, int nodeId, int appId,
+        vector<Subscription*>* subscriptions, bool& noMoreSubs) {
     int cmdLength;
     int cmdStart;
     int subscriptionCode;
@@ -775,6 +771,68 @@ bool AppMessageManager::CommandGetNewSubscriptions(int nodeId, int appId, vector
     return true;
 }
 
+bool AppMessageManager::CommandGetNewSubscriptions(const vector<int>& nodeIds, int appId,
+        vector<vector<Subscription*>*>& subscriptions, vector<bool>& noMoreSubs) {
+    if (nodeIds.size() != subscriptions.size() || nodeIds.size() != noMoreSubs.size()) {
+        cout << "iCS --> #Error while sending command: nodes and subscriptions do not match" << endl;
+        return false;
+    }
+
+    if (!m_batchMode) {
+        for (unsigned int i = 0; i < nodeIds.size(); ++i) {
+            bool noMore = false;
+            if (!CommandGetNewSubscriptions(nodeIds[i], appId, subscriptions[i], noMore)) {
+                return false;
+            }
+            noMoreSubs[i] = noMore;
+        }
+        return true;
+    }
+
+    if (m_socket == NULL) {
+        cout << "iCS --> #Error while sending command: Socket is off" << endl;
+        return false;
+    }
+
+    tcpip::Storage outMsg;
+    tcpip::Storage inMsg;
+
+    // every node is proposed its own subscription id, as if the nodes were asked one after the other
+    int firstId = Subscription::m_subscriptionCounter + 1;
+    for (unsigned int i = 0; i < nodeIds.size(); ++i) {
+        // command length
+        outMsg.writeInt(4 + 1 + 4 + 4);
+        // command id
+        outMsg.writeUnsignedByte(CMD_ASK_FOR_SUBSCRIPTION);
+        // node identifier
+        outMsg.writeInt(nodeIds[i]);
+        // subscription will have this id
+        outMsg.writeInt(firstId + i);
+    }
+
+    if (!SendAndReceive(outMsg, inMsg)) {
+        return false;
+    }
+
+    bool success = true;
+    for (unsigned int i = 0; i < nodeIds.size() && success; ++i) {
+        if (!ReportResultState(inMsg, CMD_ASK_FOR_SUBSCRIPTION)) {
+            cout << "iCS --> #Error CommandGetNewSubscriptions: ReportResultState" << endl;
+            success = false;
+            break;
+        }
+        // the subscription created for the node takes the id proposed to it
+        Subscription::m_subscriptionCounter = firstId + i - 1;
+        bool noMore = false;
+        success = ReadNewSubscription(inMsg, nodeIds[i], appId, subscriptions[i], noMore);
+        noMoreSubs[i] = noMore;
+    }
+    // the ids proposed to the nodes that did not subscribe are not reused
+    Subscription::m_subscriptionCounter = firstId + nodeIds.size() - 1;
+
+    return success;
+}
+
 bool AppMessageManager::CommandUnsubscribe(int nodeId, vector<Subscription*>* subscriptions, bool& noMoreUnSubs) {
     tcpip::Storage outMsg;
     tcpip::Storage inMsg;
@@ -858,6 +916,69 @@ int AppMessageManager::CommandUnsubscribe(int nodeId, Subscription* subscription
     log << "AppMessageManager::CommandUnsubcribe - ### Subscription id " << subscription->m_id;
     IcsLog::LogLevel((log.str()).c_str(), kLogLevelInfo);
 #endif
+    WriteUnsubscribeCommand(outMsg, nodeId, subscription);
+
+    if (!SendAndReceive(outMsg, inMsg)) {
+        return -1;
+    }
+
+    // check out the status of the primitive
+    if (!ReportResultState(inMsg, CMD_END_SUBSCRIPTION)) {
+        return -1;
+    }
+
+    // check out the subscription status requested by the app
+    return ValidateUnsubscriptions(inMsg);
+}
+
+bool AppMessageManager::CommandUnsubscribe(const vector<int>& nodeIds, const vector<Subscription*>& subscriptions,
+        vector<int>& status) {
+    if (nodeIds.size() != subscriptions.size()) {
+        cout << "iCS --> #Error while sending command: nodes and subscriptions do not match" << endl;
+        return false;
+    }
+
+    status.assign(subscriptions.size(), -1);
+
+    if (!m_batchMode) {
+        for (unsigned int i = 0; i < subscriptions.size(); ++i) {
+            status[i] = CommandUnsubscribe(nodeIds[i], subscriptions[i]);
+        }
+        return true;
+    }
+
+    if (m_socket == NULL) {
+        cout << "iCS --> #Error while sending command: Socket is off" << endl;
+        return false;
+    }
+
+    tcpip::Storage outMsg;
+    tcpip::Storage inMsg;
+
+    for (unsigned int i = 0; i < subscriptions.size(); ++i) {
+        if (subscriptions[i] == NULL) {
+            cerr << "iCS --> [ERROR] CommandUnsubscribe() node " << nodeIds[i] << " - subscription NULL!" << endl;
+            return false;
+        }
+        WriteUnsubscribeCommand(outMsg, nodeIds[i], subscriptions[i]);
+    }
+
+    if (!SendAndReceive(outMsg, inMsg)) {
+        return false;
+    }
+
+    // the answers come in the same order as the commands
+    for (unsigned int i = 0; i < subscriptions.size(); ++i) {
+        if (!ReportResultState(inMsg, CMD_END_SUBSCRIPTION)) {
+            return false;
+        }
+        status[i] = ValidateUnsubscriptions(inMsg);
+    }
+
+    return true;
+}
+
+void AppMessageManager::WriteUnsubscribeCommand(tcpip::Storage& outMsg, int nodeId, Subscription* subscription) {
     // command length
     outMsg.writeInt(4 + 1 + 4 + 1 + 4);
     // command id
@@ -897,29 +1018,6 @@ int AppMessageManager::CommandUnsubscribe(int nodeId, Subscription* subscription
     // the id of the subscription
     outMsg.writeInt(subscription->m_id);
 
-    // send request message
-    try {
-        m_socket->sendExact(outMsg);
-    } catch (SocketException& e) {
-        cout << "iCS --> #Error while sending command to Application: " << e.what() << endl;
-        return -1;
-    }
-
-    // receive answer message
-    try {
-        m_socket->receiveExact(inMsg);
-    } catch (SocketException& e) {
-        cout << "iCS --> #Error while receiving response from Application: " << e.what() << endl;
-        return -1;
-    }
-
-    // check out the status of the primitive
-    if (!ReportResultState(inMsg, CMD_END_SUBSCRIPTION)) {
-        return -1;
-    }
-
-    // check out the subscription status requested by the app
-    return ValidateUnsubscriptions(inMsg);
 }
 
 bool AppMessageManager::CommandSendSubscriptionCarsInZone(vector<VehicleNode*>* carsInZone, int nodeId, int m_id) {
@@ -928,7 +1026,6 @@ bool AppMessageManager::CommandSendSubscriptionCarsInZone(vector<VehicleNode*>*
     }
 
     tcpip::Storage outMsg;
-    tcpip::Storage inMsg;
 
     if (m_socket == NULL) {
         cout << "iCS --> #Error while sending command: Socket is off" << endl;
@@ -977,23 +1074,7 @@ bool AppMessageManager::CommandSendSubscriptionCarsInZone(vector<VehicleNode*>*
 #endif
     }
 
-    // send request message
-    try {
-        m_socket->sendExact(outMsg);
-    } catch (SocketException& e) {
-        cout << "iCS --> #Error while sending command to Application: " << e.what() << endl;
-        return false;
-    }
-
-    // receive answer message
-    try {
-        m_socket->receiveExact(inMsg);
-    } catch (SocketException& e) {
-        cout << "iCS --> #Error while receiving response from Application: " << e.what() << endl;
-        return false;
-    }
-
-    if (!ReportResultState(inMsg, CMD_CARS_IN_ZONE)) {
+    if (!Exchange(outMsg, CMD_CARS_IN_ZONE)) {
         return false;
     }
 
@@ -1002,7 +1083,6 @@ bool AppMessageManager::CommandSendSubscriptionCarsInZone(vector<VehicleNode*>*
 
 int AppMessageManager::CommandSendSubcriptionCalculateTravelTimeFlags(int nodeId, int startStation, int stopStation) {
     tcpip::Storage outMsg;
-    tcpip::Storage inMsg;
 
     if (m_socket == NULL) {
         cout << "iCS --> #Error while sending command: Socket is off" << endl;
@@ -1024,28 +1104,12 @@ int AppMessageManager::CommandSendSubcriptionCalculateTravelTimeFlags(int nodeId
     // stop station
     outMsg.writeInt(stopStation);
 
-    // send request message
-    try {
-        m_socket->sendExact(outMsg);
-    } catch (SocketException& e) {
-        cout << "iCS --> #Error while sending command to Application: " << e.what() << endl;
-        return EXIT_FAILURE;
-    }
-
 #ifdef LOG_ON
     stringstream log;
     log << "Start and stop station info: " << startStation << " | " << stopStation;
     IcsLog::LogLevel((log.str()).c_str(), kLogLevelInfo);
 #endif
-    // receive answer message
-    try {
-        m_socket->receiveExact(inMsg);
-    } catch (SocketException& e) {
-        cout << "iCS --> #Error while receiving response from Application: " << e.what() << endl;
-        return EXIT_FAILURE;
-    }
-
-    if (!ReportResultState(inMsg, CMD_TRAVEL_TIME_ESTIMATION)) {
+    if (!Exchange(outMsg, CMD_TRAVEL_TIME_ESTIMATION)) {
         return EXIT_FAILURE;
     }
 
@@ -1063,7 +1127,6 @@ bool AppMessageManager::CommandSendSubscriptionReceivedCamInfo(vector<TCamInform
     }
 
     tcpip::Storage outMsg;
-    tcpip::Storage inMsg;
 
     if (m_socket == NULL) {
         cout << "iCS --> #Error while sending command: Socket is off" << endl;
@@ -1120,23 +1183,7 @@ bool AppMessageManager::CommandSendSubscriptionReceivedCamInfo(vector<TCamInform
         outMsg.writeString(currCamInfo.junctionID);        // junctionID
     }
 
-    // send request message
-    try {
-        m_socket->sendExact(outMsg);
-    } catch (SocketException& e) {
-        cout << "iCS --> #Error while sending command to Application: " << e.what() << endl;
-        return false;
-    }
-
-    // receive answer message
-    try {
-        m_socket->receiveExact(inMsg);
-    } catch (SocketException& e) {
-        cout << "iCS --> #Error while receiving response from Application: " << e.what() << endl;
-        return false;
-    }
-
-    if (!ReportResultState(inMsg, CMD_RECEIVED_CAM_INFO)) {
+    if (!Exchange(outMsg, CMD_RECEIVED_CAM_INFO)) {
         return false;
     }
 
@@ -1150,7 +1197,6 @@ bool AppMessageManager::CommandSendSubscriptionFacilitiesInfo(tcpip::Storage* fa
     }
 
     tcpip::Storage outMsg;
-    tcpip::Storage inMsg;
 
     if (m_socket == NULL) {
         cout << "iCS --> #Error while sending command: Socket is off" << endl;
@@ -1181,33 +1227,16 @@ bool AppMessageManager::CommandSendSubscriptionFacilitiesInfo(tcpip::Storage* fa
     if (facInfo->size() > 0) {
         outMsg.writeStorage(*facInfo); // bytes: 13-(13+facInfo.size())
     }
-    // send request message
-    try {
-        m_socket->sendExact(outMsg);
-    } catch (SocketException& e) {
-        cout << "iCS --> #Error while sending command to Application: " << e.what() << endl;
-        return false;
-    }
-
-    // receive answer message
-    try {
-        m_socket->receiveExact(inMsg);
-    } catch (SocketException& e) {
-        cout << "iCS --> #Error while receiving response from Application: " << e.what() << endl;
+    if (!Exchange(outMsg, CMD_FACILITIES_INFORMATION)) {
         cout << "iCS --> #Error sent " << totalLengthPacket << " bytes to application" << endl;
         return false;
     }
 
-    if (!ReportResultState(inMsg, CMD_FACILITIES_INFORMATION)) {
-        return false;
-    }
-
     return true;
 }
 
 int AppMessageManager::NotifyMessageStatus(int nodeId, vector<pair<int, stationID_t> >& receivedMessages) {
     tcpip::Storage outMsg;
-    tcpip::Storage inMsg;
 
     if (m_socket == NULL) {
         cout << "iCS --> #Error while sending command: Socket is off" << endl;
@@ -1246,23 +1275,7 @@ int AppMessageManager::NotifyMessageStatus(int nodeId, vector<pair<int, stationI
 #endif
     }
 
-    // send request message
-    try {
-        m_socket->sendExact(outMsg);
-    } catch (SocketException& e) {
-        cout << "iCS --> #Error while sending command to Application: " << e.what() << endl;
-        return EXIT_FAILURE;
-    }
-
-    // receive answer message
-    try {
-        m_socket->receiveExact(inMsg);
-    } catch (SocketException& e) {
-        cout << "iCS --> #Error while receiving response from Application: " << e.what() << endl;
-        return EXIT_FAILURE;
-    }
-
-    if (!ReportResultState(inMsg, CMD_NOTIFY_APP_MESSAGE_STATUS)) {
+    if (!Exchange(outMsg, CMD_NOTIFY_APP_MESSAGE_STATUS)) {
         return EXIT_FAILURE;
     }
 
@@ -1280,7 +1293,6 @@ bool AppMessageManager::SendStatus(int command, bool status, int nodeId, int sub
     }
 
     tcpip::Storage outMsg;
-    tcpip::Storage inMsg;
 
     if (m_socket == NULL) {
         cout << "iCS --> #Error while sending command: Socket is off" << endl;
@@ -1303,23 +1315,7 @@ bool AppMessageManager::SendStatus(int command, bool status, int nodeId, int sub
     outMsg.writeUnsignedByte(status);                               // bytes: 13
     // the subscription id
     outMsg.writeInt(subscriptionId);
-    // send request message
-    try {
-        m_socket->sendExact(outMsg);
-    } catch (SocketException& e) {
-        cout << "iCS --> #Error while sending command to Application: " << e.what() << endl;
-        return false;
-    }
-
-    // receive answer message
-    try {
-        m_socket->receiveExact(inMsg);
-    } catch (SocketException& e) {
-        cout << "iCS --> #Error while receiving response from Application: " << e.what() << endl;
-        return false;
-    }
-
-    if (!ReportResultState(inMsg, command)) {
+    if (!Exchange(outMsg, command)) {
         return false;
     }
 
@@ -1330,7 +1326,6 @@ bool AppMessageManager::CommandSendSubscriptionAppMessageReceive(
     std::vector<std::pair<Message, stationID_t> >& msgInfo) {
 
     tcpip::Storage outMsg;
-    tcpip::Storage inMsg;
     tcpip::Storage tmpMsg;
 
     int rcvMsg = 0;
@@ -1377,23 +1372,7 @@ bool AppMessageManager::CommandSendSubscriptionAppMessageReceive(
     // the tmp storage
     outMsg.writeStorage(tmpMsg);
 
-    // send request message
-    try {
-        m_socket->sendExact(outMsg);
-    } catch (SocketException& e) {
-        cout << "iCS --> #Error while sending command to Application: " << e.what() << endl;
-        return EXIT_FAILURE;
-    }
-
-    // receive answer message
-    try {
-        m_socket->receiveExact(inMsg);
-    } catch (SocketException& e) {
-        cout << "iCS --> #Error while receiving response from Application: " << e.what() << endl;
-        return EXIT_FAILURE;
-    }
-
-    if (!ReportResultState(inMsg, CMD_APP_MSG_RECEIVE)) {
+    if (!Exchange(outMsg, CMD_APP_MSG_RECEIVE)) {
         cout << "iCS --> #Error while checking response state from Application: " << endl;
         //return false;
         return EXIT_FAILURE;
@@ -1410,7 +1389,6 @@ bool AppMessageManager::CommandSendSubscriptionAppResultTraffSim(vector<unsigned
     }
 
     tcpip::Storage outMsg;
-    tcpip::Storage inMsg;
 
     if (m_socket == NULL) {
         cout << "iCS --> #Error while sending command: Socket is off" << endl;
@@ -1435,23 +1413,7 @@ bool AppMessageManager::CommandSendSubscriptionAppResultTraffSim(vector<unsigned
     // facilities information (expressed according to the Type-Length-Value syntax)
     outMsg.writePacket(tsInfo); // bytes: 17-(17+tsInfo.size())
 
-    // send request message
-    try {
-        m_socket->sendExact(outMsg);
-    } catch (SocketException& e) {
-        cout << "iCS --> #Error while sending command to Application: " << e.what() << endl;
-        return false;
-    }
-
-    // receive answer message
-    try {
-        m_socket->receiveExact(inMsg);
-    } catch (SocketException& e) {
-        cout << "iCS --> #Error while receiving response from Application: " << e.what() << endl;
-        return false;
-    }
-
-    if (!ReportResultState(inMsg, CMD_APP_RESULT_TRAFF_SIM)) {
+    if (!Exchange(outMsg, CMD_APP_RESULT_TRAFF_SIM)) {
         return false;
     }
 
@@ -1466,7 +1428,6 @@ bool AppMessageManager::CommandSendSubscriptionXApplicationData(vector<unsigned
     }
 
     tcpip::Storage outMsg;
-    tcpip::Storage inMsg;
 
     if (m_socket == NULL) {
         cout << "iCS --> #Error while sending command: Socket is off" << endl;
@@ -1491,23 +1452,7 @@ bool AppMessageManager::CommandSendSubscriptionXApplicationData(vector<unsigned
     // facilities information (expressed according to the Type-Length-Value syntax)
     outMsg.writePacket(xAppData); // bytes: 13-(13+tsInfo.size())
 
-    // send request message
-    try {
-        m_socket->sendExact(outMsg);
-    } catch (SocketException& e) {
-        cout << "iCS --> #Error while sending command to Application: " << e.what() << endl;
-        return false;
-    }
-
-    // receive answer message
-    try {
-        m_socket->receiveExact(inMsg);
-    } catch (SocketException& e) {
-        cout << "iCS --> #Error while receiving response from Application: " << e.what() << endl;
-        return false;
-    }
-
-    if (!ReportResultState(inMsg, CMD_X_APPLICATION_DATA)) {
+    if (!Exchange(outMsg, CMD_X_APPLICATION_DATA)) {
         return false;
     }
 
@@ -1533,39 +1478,76 @@ bool AppMessageManager::CommandApplicationToExecute(int nodeId, ResultContainer*
         cout << "Node id 0" << endl;
     }
 
-    // send request message
-    try {
-        m_socket->sendExact(outMsg);
-    } catch (SocketException& e) {
-        cout << "iCS --> #Error while sending command to Application: " << e.what() << endl;
+    if (!SendAndReceive(outMsg, inMsg)) {
         return false;
     }
 
-    // receive answer message
-    try {
-        m_socket->receiveExact(inMsg);
+    if (!ReportResultState(inMsg, CMD_NOTIFY_APP_EXECUTE)) {
+        return false;
+    }
 
-    } catch (SocketException& e) {
-        cout << "iCS --> #Error while receiving response from Application: " << e.what() << endl;
+    if (!resultContainer->ProcessResult(inMsg)) {
+        cout << "iCS --> #Error processing the result." << endl;
         return false;
     }
 
-    if (!ReportResultState(inMsg, CMD_NOTIFY_APP_EXECUTE)) {
+    return true;
+}
+
+bool AppMessageManager::CommandApplicationToExecute(const vector<int>& nodeIds,
+        const vector<ResultContainer*>& resultContainers) {
+    if (nodeIds.size() != resultContainers.size()) {
+        cout << "iCS --> #Error while sending command: nodes and result containers do not match" << endl;
         return false;
     }
 
-    if (!resultContainer->ProcessResult(inMsg)) {
-        cout << "iCS --> #Error processing the result." << endl;
+    if (!m_batchMode) {
+        for (unsigned int i = 0; i < nodeIds.size(); ++i) {
+            if (!CommandApplicationToExecute(nodeIds[i], resultContainers[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    if (m_socket == NULL) {
+        cout << "iCS --> #Error while sending command: Socket is off" << endl;
         return false;
     }
 
+    tcpip::Storage outMsg;
+    tcpip::Storage inMsg;
+
+    for (unsigned int i = 0; i < nodeIds.size(); ++i) {
+        // command length
+        outMsg.writeInt(4 + 1 + 4);
+        // command id
+        outMsg.writeUnsignedByte(CMD_NOTIFY_APP_EXECUTE);
+        // the node in which the applications is running
+        outMsg.writeInt(nodeIds[i]);
+    }
+
+    if (!SendAndReceive(outMsg, inMsg)) {
+        return false;
+    }
+
+    // the answers come in the same order as the commands, every result container reads its own answer
+    for (unsigned int i = 0; i < nodeIds.size(); ++i) {
+        if (!ReportResultState(inMsg, CMD_NOTIFY_APP_EXECUTE)) {
+            return false;
+        }
+        if (!resultContainers[i]->ProcessResult(inMsg)) {
+            cout << "iCS --> #Error processing the result." << endl;
+            return false;
+        }
+    }
+
     return true;
 }
 
 int AppMessageManager::CommandSendSubscriptionMobilityInfo(std::vector<TMobileStationDynamicInfo>* information,
         int nodeId) {
     tcpip::Storage outMsg;
-    tcpip::Storage inMsg;
     tcpip::Storage tmpMsg;
 
     int messNum = 0;
@@ -1617,23 +1599,7 @@ int AppMessageManager::CommandSendSubscriptionMobilityInfo(std::vector<TMobileSt
     // the tmp storage
     outMsg.writeStorage(tmpMsg);
 
-    // send request message
-    try {
-        m_socket->sendExact(outMsg);
-    } catch (SocketException& e) {
-        cout << "iCS --> #Error while sending command to Application: " << e.what() << endl;
-        return EXIT_FAILURE;
-    }
-
-    // receive answer message
-    try {
-        m_socket->receiveExact(inMsg);
-    } catch (SocketException& e) {
-        cout << "iCS --> #Error while receiving response from Application: " << e.what() << endl;
-        return EXIT_FAILURE;
-    }
-
-    if (!ReportResultState(inMsg, CMD_MOBILITY_INFORMATION)) {
+    if (!Exchange(outMsg, CMD_MOBILITY_INFORMATION)) {
         cout << "iCS --> #Error while checking response state from Application: " << endl;
         //return false;
         return EXIT_FAILURE;
@@ -1645,7 +1611,6 @@ int AppMessageManager::CommandSendSubscriptionMobilityInfo(std::vector<TMobileSt
 
 int AppMessageManager::CommandSendSubscriptionControlTraCI(int m_id, tcpip::Storage& proxyMsg, int nodeId) {
     tcpip::Storage outMsg;
-    tcpip::Storage inMsg;
 
     int messNum = 0;
 
@@ -1671,23 +1636,7 @@ int AppMessageManager::CommandSendSubscriptionControlTraCI(int m_id, tcpip::Stor
     // the tmp storage (returned data from TraCI, without any interpretation
     outMsg.writeStorage(proxyMsg);
 
-    // send request message
-    try {
-        m_socket->sendExact(outMsg);
-    } catch (SocketException& e) {
-        cout << "iCS --> #Error while sending immediate command to Application: " << e.what() << endl;
-        return EXIT_FAILURE;
-    }
-
-    // receive answer message
-    try {
-        m_socket->receiveExact(inMsg);
-    } catch (SocketException& e) {
-        cout << "iCS --> #Error while receiving immediate response from Application: " << e.what() << endl;
-        return EXIT_FAILURE;
-    }
-
-    if (!ReportResultState(inMsg, CMD_CONTROL_TRACI)) {
+    if (!Exchange(outMsg, CMD_CONTROL_TRACI)) {
         cout << "iCS --> #Error while checking response state from Application: " << endl;
         return EXIT_FAILURE;
     }
@@ -1700,7 +1649,6 @@ int AppMessageManager::CommandSendSubscriptionControlTraCI(int m_id, tcpip::Stor
 int AppMessageManager::CommandSendSubscriptionTrafficLightInfo(std::vector<std::string>& data, int nodeId,
         bool error) {
     tcpip::Storage outMsg;
-    tcpip::Storage inMsg;
     tcpip::Storage tmpMsg;
 
     if (m_socket == NULL) {
@@ -1728,12 +1676,87 @@ int AppMessageManager::CommandSendSubscriptionTrafficLightInfo(std::vector<std::
     // the tmp storage
     outMsg.writeStorage(tmpMsg);
 
+    if (!Exchange(outMsg, CMD_TRAFFIC_LIGHT_INFORMATION)) {
+        cout << "iCS --> #Error while checking response state from Application: " << endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+bool AppMessageManager::IsBatchModeEnabled() const {
+    return m_batchMode;
+}
+
+void AppMessageManager::BeginBatch() {
+    if (!m_batchMode) {
+        return;
+    }
+    m_batchRequest.reset();
+    m_batchCommands.clear();
+    m_batchOpen = true;
+}
+
+bool AppMessageManager::FlushBatch() {
+    if (!m_batchOpen) {
+        return true;
+    }
+    m_batchOpen = false;
+
+    if (m_batchCommands.empty()) {
+        return true;
+    }
+
+    tcpip::Storage inMsg;
+    bool success = SendAndReceive(m_batchRequest, inMsg);
+    for (vector<int>::const_iterator it = m_batchCommands.begin(); success && it != m_batchCommands.end(); ++it) {
+        success = ReportResultState(inMsg, *it);
+    }
+
+    m_batchRequest.reset();
+    m_batchCommands.clear();
+    return success;
+}
+
+bool AppMessageManager::NegotiateBatchMode() {
+    tcpip::Storage outMsg;
+    tcpip::Storage inMsg;
+
+    // command length
+    outMsg.writeInt(4 + 1);
+    // command id
+    outMsg.writeUnsignedByte(CMD_BATCH_MODE);
+
+    if (!SendAndReceive(outMsg, inMsg)) {
+        return false;
+    }
+
+    // the status is read here since an application not knowing the command is not an error
+    try {
+        inMsg.readUnsignedByte();
+        if (inMsg.readUnsignedByte() != CMD_BATCH_MODE) {
+            return false;
+        }
+        if (inMsg.readUnsignedByte() != APP_RTYPE_OK) {
+            cout << "iCS --> Application does not support the batched protocol mode." << endl;
+            return false;
+        }
+    } catch (std::invalid_argument& e) {
+        cout << "App --> iCS #Error: an exception was thrown while reading the batched protocol mode answer." << endl;
+        return false;
+    }
+
+    cout << "iCS --> Application supports the batched protocol mode." << endl;
+    return true;
+}
+
+bool AppMessageManager::SendAndReceive(tcpip::Storage& outMsg, tcpip::Storage& inMsg) {
     // send request message
     try {
         m_socket->sendExact(outMsg);
     } catch (SocketException& e) {
         cout << "iCS --> #Error while sending command to Application: " << e.what() << endl;
-        return EXIT_FAILURE;
+        return false;
     }
 
     // receive answer message
@@ -1741,15 +1764,26 @@ int AppMessageManager::CommandSendSubscriptionTrafficLightInfo(std::vector<std::
         m_socket->receiveExact(inMsg);
     } catch (SocketException& e) {
         cout << "iCS --> #Error while receiving response from Application: " << e.what() << endl;
-        return EXIT_FAILURE;
+        return false;
     }
 
-    if (!ReportResultState(inMsg, CMD_TRAFFIC_LIGHT_INFORMATION)) {
-        cout << "iCS --> #Error while checking response state from Application: " << endl;
-        return EXIT_FAILURE;
+    return true;
+}
+
+bool AppMessageManager::Exchange(tcpip::Storage& outMsg, int command) {
+    if (m_batchOpen) {
+        // the answer is checked by FlushBatch()
+        m_batchRequest.writeStorage(outMsg);
+        m_batchCommands.push_back(command);
+        return true;
     }
 
-    return EXIT_SUCCESS;
+    tcpip::Storage inMsg;
+    if (!SendAndReceive(outMsg, inMsg)) {
+        return false;
+    }
+
+    return ReportResultState(inMsg, command);
 }
 
 bool AppMessageManager::ReportResultState(tcpip::Storage& inMsg, int command) {
@@ -1946,7 +1980,6 @@ int AppMessageManager::ValidateUnsubscriptions(Storage& inMsg) {
 int AppMessageManager::CommandSendSubscriptionSumoTraciCommand(const int nodeId, const int subscriptionId,
         const int executionId, tcpip::Storage& result) {
     tcpip::Storage outMsg;
-    tcpip::Storage inMsg;
 
     if (m_socket == NULL) {
         cerr << "iCS --> #Error while sending command: Socket is off" << endl;
@@ -1971,23 +2004,7 @@ int AppMessageManager::CommandSendSubscriptionSumoTraciCommand(const int nodeId,
     // the result storage
     outMsg.writeStorage(result);
 
-    // send request message
-    try {
-        m_socket->sendExact(outMsg);
-    } catch (SocketException& e) {
-        cerr << "iCS --> #Error while sending command to Application: " << e.what() << endl;
-        return EXIT_FAILURE;
-    }
-
-    // receive answer message
-    try {
-        m_socket->receiveExact(inMsg);
-    } catch (SocketException& e) {
-        cerr << "iCS --> #Error while receiving response from Application: " << e.what() << endl;
-        return EXIT_FAILURE;
-    }
-
-    if (!ReportResultState(inMsg, CMD_SUMO_TRACI_COMMAND)) {
+    if (!Exchange(outMsg, CMD_SUMO_TRACI_COMMAND)) {
         cerr << "iCS --> #Error while checking response state from Application: " << endl;
         return EXIT_FAILURE;
     }
@@ -155,6 +155,19 @@ public:
      */
     bool CommandUnsubscribe(int nodeId, std::vector<Subscription*>* subscriptionsToDrop, bool& noMoreUnSubs);
 
+    /**
+     * @brief Asks the application of several nodes if they want to subscribe to a new data, using a single message
+     * in batched protocol mode (one message per node otherwise).
+     * @param[in] nodeIds The identifiers of the nodes the application is running on top of.
+     * @param[in] appId The identifier of the application.
+     * @param[in,out] subscriptions Collection of subscriptions of each node (same order as nodeIds).
+     * @param[in,out] noMoreSubs True for the nodes whose application stopped asking for subscriptions.
+     * @return True: If the function executes successfully
+     * @return False: If an error occurs
+     */
+    bool CommandGetNewSubscriptions(const std::vector<int>& nodeIds, int appId,
+                                    std::vector<std::vector<Subscription*>*>& subscriptions, std::vector<bool>& noMoreSubs);
+
     /**
      * @brief Asks the application whether it wants to unsubscribe for current subscription. (V 2.O)
      * @param[in] nodeId iCS identifier of the node.
@@ -165,6 +178,18 @@ public:
      */
     int CommandUnsubscribe(int nodeId, Subscription* subscription);
 
+    /**
+     * @brief Asks the application whether it wants to unsubscribe for several subscriptions, using a single message
+     * in batched protocol mode (one message per subscription otherwise).
+     * @param[in] nodeIds iCS identifier of the node owning each subscription.
+     * @param[in] subscriptions The subscription candidates to unsubscription (same order as nodeIds).
+     * @param[out] status The answer for each subscription, as returned by CommandUnsubscribe(int, Subscription*).
+     * @return True: If the function executes successfully
+     * @return False: If an error occurs
+     */
+    bool CommandUnsubscribe(const std::vector<int>& nodeIds, const std::vector<Subscription*>& subscriptions,
+                            std::vector<int>& status);
+
     /**
      * @brief Sends to the application the corresponding data of the subscripiton to Return Cars In Zone.
      * @param[in] carsInZone The vehicles in the current zone.
@@ -255,6 +280,34 @@ public:
      */
     bool CommandApplicationToExecute(int nodeId, ResultContainer* resultContainer);
 
+    /**
+     * @brief Command Application to execute its main functionality/algorithm in several nodes, using a single message
+     * in batched protocol mode (one message per node otherwise).
+     * @param[in] nodeIds The identifiers of the nodes the application is running on top of.
+     * @param[in,out] resultContainers The objects in which the results will be stored in (same order as nodeIds).
+     * @return True: If the execution finishes successfully.
+     * @return False: If an error occurs.
+     */
+    bool CommandApplicationToExecute(const std::vector<int>& nodeIds, const std::vector<ResultContainer*>& resultContainers);
+
+    /**
+     * @brief Tells whether the application accepted the batched protocol mode when the connection was established.
+     */
+    bool IsBatchModeEnabled() const;
+
+    /**
+     * @brief Starts collecting the commands that are only acknowledged by the application (data of the subscriptions,
+     * message status...) instead of exchanging them one by one. Has no effect out of batched protocol mode.
+     */
+    void BeginBatch();
+
+    /**
+     * @brief Sends the commands collected since BeginBatch() in a single message and checks the status of every answer.
+     * @return True: If all the commands were acknowledged by the application
+     * @return False: If an error occurs
+     */
+    bool FlushBatch();
+
     /**
      * @brief Notifies the status of the scheduled messages.
      * @param[in] nodeId The identifier of the node the application is running on top of.
@@ -304,6 +357,63 @@ public:
 
 private:
 
+    /// @brief True if the application accepted the batched protocol mode.
+    bool m_batchMode;
+
+    /// @brief True between BeginBatch() and FlushBatch().
+    bool m_batchOpen;
+
+    /// @brief The commands collected since BeginBatch().
+    tcpip::Storage m_batchRequest;
+
+    /// @brief The IDs of the commands collected since BeginBatch(), in the order they were collected.
+    std::vector<int> m_batchCommands;
+
+    /**
+     * @brief Asks the application whether it supports the batched protocol mode.
+     * @return True: If the application accepted the batched protocol mode
+     * @return False: Otherwise (applications that do not know the command answer it is not implemented)
+     */
+    bool NegotiateBatchMode();
+
+    /**
+     * @brief Sends a message to the application and receives its answer.
+     * @return True: If the exchange finishes successfully
+     * @return False: If an error occurs
+     */
+    bool SendAndReceive(tcpip::Storage& outMsg, tcpip::Storage& inMsg);
+
+    /**
+     * @brief Sends a command that is only acknowledged by the application and validates the answer. The command is
+     * deferred until FlushBatch() if a batch was started.
+     * @param[in] outMsg The command to send.
+     * @param[in] command The ID of the command.
+     * @return True: In the operation finishes successfully
+     * @return False: If an error occurs
+     */
+    bool Exchange(tcpip::Storage& outMsg, int command);
+
+    /**
+     * @brief Reads the answer of the application to a CMD_ASK_FOR_SUBSCRIPTION command and creates the subscription.
+     * @param[in,out] &inMsg Object storing the reply from the application.
+     * @param[in] nodeId The identifier of the node the application is running on top of.
+     * @param[in] appId The identifier of the application.
+     * @param[in,out] subscriptions Collection of subscriptions of the node.
+     * @param[in,out] &noMoreSubs True if application stopped asking for subscriptions.
+     * @return True: If the function executes successfully
+     * @return False: If an error occurs
+     */
+    bool ReadNewSubscription(tcpip::Storage& inMsg, int nodeId, int appId, std::vector<Subscription*>* subscriptions,
+                             bool& noMoreSubs);
+
+    /**
+     * @brief Writes the CMD_END_SUBSCRIPTION command for a subscription.
+     * @param[in,out] &outMsg Object to store the command in.
+     * @param[in] nodeId iCS identifier of the node.
+     * @param[in] subscription The subscription candidate to unbsubscription.
+     */
+    void WriteUnsubscribeCommand(tcpip::Storage& outMsg, int nodeId, Subscription* subscription);
+
     /**
      * @brief Reports the result of a command execution.
      * @param[in,out] &inMsg Object to stored the reply from the application.
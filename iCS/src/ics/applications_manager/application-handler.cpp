@@ -49,6 +49,7 @@
 #include <config.h>
 #endif
 
+#include <set>
 #include <typeinfo>
 
 #include <utils/common/RandHelper.h>
@@ -157,6 +158,35 @@ bool ApplicationHandler::AskForNewSubscriptions(int nodeId, vector<Subscription*
     return true;
 }
 
+bool ApplicationHandler::AskForNewSubscriptions(const vector<int>& nodeIds, vector<vector<Subscription*>*>& subscriptions) {
+    if (nodeIds.size() != subscriptions.size()) {
+        return false;
+    }
+
+    vector<int> askedIds(nodeIds);
+    vector<vector<Subscription*>*> askedSubs(subscriptions);
+
+    // Ask for subscriptions until all the nodes request to stop
+    while (!askedIds.empty()) {
+        vector<bool> noMoreSubscriptions(askedIds.size(), false);
+        if (!m_appMessageManager->CommandGetNewSubscriptions(askedIds, m_id, askedSubs, noMoreSubscriptions)) {
+            return false;
+        }
+        unsigned int kept = 0;
+        for (unsigned int i = 0; i < askedIds.size(); ++i) {
+            if (!noMoreSubscriptions[i]) {
+                askedIds[kept] = askedIds[i];
+                askedSubs[kept] = askedSubs[i];
+                ++kept;
+            }
+        }
+        askedIds.resize(kept);
+        askedSubs.resize(kept);
+    }
+
+    return true;
+}
+
 bool ApplicationHandler::AskForUnsubscriptions(int nodeId, vector<Subscription*>* subscriptions) {
     if (subscriptions == NULL) {
         return false;
@@ -207,6 +237,76 @@ bool ApplicationHandler::AskForUnsubscriptions(int nodeId, vector<Subscription*>
     return true;
 }
 
+bool ApplicationHandler::AskForUnsubscriptions(const vector<int>& nodeIds, vector<vector<Subscription*>*>& subscriptions) {
+    if (nodeIds.size() != subscriptions.size()) {
+        return false;
+    }
+
+    vector<int> candidateNodes;
+    vector<Subscription*> candidates;
+    for (unsigned int i = 0; i < nodeIds.size(); ++i) {
+        if (subscriptions[i] == NULL) {
+            return false;
+        }
+        for (vector<Subscription*>::iterator it = subscriptions[i]->begin(); it != subscriptions[i]->end(); ++it) {
+            if (m_id == (*it)->m_appId) {
+                candidateNodes.push_back(nodeIds[i]);
+                candidates.push_back(*it);
+            }
+        }
+    }
+
+    if (candidates.empty()) {
+        return true;
+    }
+
+    vector<int> status;
+    if (!m_appMessageManager->CommandUnsubscribe(candidateNodes, candidates, status)) {
+        return false;
+    }
+
+    set<Subscription*> dropped;
+    for (unsigned int i = 0; i < candidates.size(); ++i) {
+        switch (status[i]) {
+            case 0:
+                break;
+            case 1:
+                dropped.insert(candidates[i]);
+                break;
+            case -1:
+                cerr << "iCS --> [ERROR] AskForUnsubscriptions() unsubscribing node [iCS-ID] [" << candidateNodes[i] << "]" << endl;
+                return false;
+            default:
+                IcsLog::LogLevel("AskForUnsubscriptions() Unknown error code.", kLogLevelWarning);
+                break;
+        }
+    }
+
+    if (dropped.empty()) {
+        return true;
+    }
+
+    // Performs the removal of the dropped subscriptions from the collections
+    for (unsigned int i = 0; i < nodeIds.size(); ++i) {
+        vector<Subscription*>* nodeSubs = subscriptions[i];
+        for (vector<Subscription*>::iterator it = nodeSubs->begin(); it != nodeSubs->end();) {
+            if (dropped.count(*it) > 0) {
+#ifdef LOG_ON
+                stringstream log;
+                log << "AskForUnsubscriptions() unsubscribing " << (*it)->m_id << " in node [iCS-ID] [" << nodeIds[i] << "]";
+                IcsLog::LogLevel((log.str()).c_str(), kLogLevelInfo);
+#endif
+                delete *it;
+                it = nodeSubs->erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    return true;
+}
+
 int ApplicationHandler::SendSubscribedData(int nodeId, Subscription* subscription, NodeMap* nodes) {
     if (subscription == NULL || nodes == NULL) {
         IcsLog::LogLevel("SendSubscribedData() Subscription or nodes are NULL.", kLogLevelError);
@@ -521,6 +621,16 @@ bool ApplicationHandler::ExecuteApplication(int nodeId, ResultContainer* resultC
     return true;
 }
 
+bool ApplicationHandler::ExecuteApplication(const vector<int>& nodeIds, const vector<ResultContainer*>& resultContainers) {
+    for (vector<ResultContainer*>::const_iterator it = resultContainers.begin(); it != resultContainers.end(); ++it) {
+        if (*it == NULL) {
+            return false;
+        }
+    }
+
+    return m_appMessageManager->CommandApplicationToExecute(nodeIds, resultContainers);
+}
+
 int ApplicationHandler::SendMessageStatus(int nodeId, ResultContainer* result) {
     if (result == NULL) {
         cerr << "iCS --> [ERROR] SendMessageStatus() The result is NULL for node " << nodeId << endl;
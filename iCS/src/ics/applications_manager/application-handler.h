@@ -168,6 +168,15 @@ public:
     */
     bool AskForNewSubscriptions(int nodeId, std::vector<Subscription*>* subscriptions);
 
+    /**
+    * @brief Asks several nodes if they want more subscriptions, all the nodes being asked with a single message.
+    * @param[in] nodeIds Node identifiers.
+    * @param[in] subscriptions Collection of subscriptions associated to each node (same order as nodeIds).
+    * @return True: If the function executes successfully.
+    * @return False: If an error occurs.
+    */
+    bool AskForNewSubscriptions(const std::vector<int>& nodeIds, std::vector<std::vector<Subscription*>*>& subscriptions);
+
     /**
      * @brief Informs the applications of the creation of a new node.
      * @param[in] node The node created.
@@ -191,6 +200,16 @@ public:
     */
     bool AskForUnsubscriptions(int nodeId, std::vector<Subscription*>* subscriptions);
 
+    /**
+    * @brief Asks several nodes if they want to execute an unsubscription, all the subscriptions being asked with a
+    * single message.
+    * @param[in] nodeIds iCS identifiers of the nodes.
+    * @param[in] subscriptions Collection of subscriptions associated to each node (same order as nodeIds).
+    * @return True: If it ends successfully.
+    * @return False: If an error occurs.
+    */
+    bool AskForUnsubscriptions(const std::vector<int>& nodeIds, std::vector<std::vector<Subscription*>*>& subscriptions);
+
     /**
     * @brief Sends the information about the subscription to the application.
     * @param[in] nodeId Node identifier.
@@ -209,6 +228,15 @@ public:
     */
     bool ExecuteApplication(int nodeId, ResultContainer* resultContainer);
 
+    /**
+    * @brief Executes the application in several nodes with a single message.
+    * @param[in] nodeIds Node identifiers.
+    * @param[in] resultContainers Objects that contain the result of the execution (same order as nodeIds).
+    * @return True: If the function finishes successfully.
+    * @return False: If an error occurs
+    */
+    bool ExecuteApplication(const std::vector<int>& nodeIds, const std::vector<ResultContainer*>& resultContainers);
+
     /**
     * @brief Tells the Application about the status of the messages delivering resutls.
     * @param[in] nodeId Node identifier.
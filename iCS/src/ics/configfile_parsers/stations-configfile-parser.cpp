@@ -82,6 +82,9 @@ StationsGetConfig::StationsGetConfig() {
     TAG_RATseed                     = XMLString::transcode("RATseed");
     ATTR_RATseedValue               = XMLString::transcode("value");
 
+    TAG_MobilityHistory             = XMLString::transcode("mobilityHistory");
+    ATTR_MobilityHistoryRetention   = XMLString::transcode("retention");
+
     TAG_MobileSta                   = XMLString::transcode("mobileSta");
     ATTR_MobRATtype                 = XMLString::transcode("RAT-type");
     ATTR_PenetrationRate            = XMLString::transcode("penetration-rate");
@@ -97,6 +100,9 @@ StationsGetConfig::StationsGetConfig() {
     ATTR_FixedCommunicationProfile  = XMLString::transcode("communication-profile");
 
     m_ConfigFileParser = new XercesDOMParser;
+
+    // By default the whole mobility history is kept
+    mobilityHistoryRetention = 0;
 }
 
 /**
@@ -110,6 +116,8 @@ StationsGetConfig::~StationsGetConfig() {
     XMLString::release(&TAG_MobileStas);
     XMLString::release(&TAG_RATseed);
     XMLString::release(&ATTR_RATseedValue);
+    XMLString::release(&TAG_MobilityHistory);
+    XMLString::release(&ATTR_MobilityHistoryRetention);
     XMLString::release(&TAG_MobileSta);
     XMLString::release(&ATTR_MobRATtype);
     XMLString::release(&ATTR_PenetrationRate);
@@ -204,6 +212,14 @@ throw(std::runtime_error) {
                         XMLString::release(&stringRATseed_ch);
                     }
 
+                    // parse "mobilityHistory"
+                    if (XMLString::equals(_element->getTagName(), TAG_MobilityHistory)) {
+                        const XMLCh* xmlch_stringRetention = _element->getAttribute(ATTR_MobilityHistoryRetention);
+                        char* stringRetention_ch = XMLString::transcode(xmlch_stringRetention);
+                        sscanf(stringRetention_ch, "%d", &mobilityHistoryRetention);
+                        XMLString::release(&stringRetention_ch);
+                    }
+
                     // parse "mobileStas"
                     if (XMLString::equals(_element->getTagName(), TAG_MobileStas)) {
                         DOMNodeList* children2 = _element->getChildNodes();
@@ -310,6 +326,10 @@ unsigned int                StationsGetConfig::getRATseed() {
     return RATseed;
 }
 
+int                         StationsGetConfig::getMobilityHistoryRetention() {
+    return mobilityHistoryRetention;
+}
+
 map <int, float>           StationsGetConfig::getDefaultPenetrationRates() {
     return defaultPenetrationRates;
 }
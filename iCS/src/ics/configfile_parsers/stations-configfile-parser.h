@@ -88,6 +88,7 @@ public:
     void readConfigFile(std::string&) throw(std::runtime_error);
 
     unsigned int                getRATseed();
+    int                         getMobilityHistoryRetention();
     map <int, float>            getDefaultPenetrationRates();
     vector<FixedStationStr>     getFixedStationCollection();
     map <int, string>           getMobileCommunicationProfiles();
@@ -97,6 +98,7 @@ private:
 
     // variables
     unsigned int                RATseed;
+    int                         mobilityHistoryRetention;
     map <int, float>            defaultPenetrationRates;
     map <int, string>           mobileCommunicationProfiles;
     vector<FixedStationStr>     m_FixedStationCollection;
@@ -106,6 +108,9 @@ private:
     XMLCh* TAG_RATseed;
     XMLCh* ATTR_RATseedValue;
 
+    XMLCh* TAG_MobilityHistory;
+    XMLCh* ATTR_MobilityHistoryRetention;
+
     XMLCh* TAG_MobileStas;
 
     XMLCh* TAG_MobileSta;
@@ -51,6 +51,8 @@
 #include <set>
 #include <cstdlib>
 #include <cfloat>
+#include <cmath>
+#include <algorithm>
 using namespace std;
 
 namespace ics_facilities {
@@ -59,6 +61,9 @@ MapFacilities::MapFacilities() {
     originLatitude = 0;
     originLongitude = 0;
     originAltitude = 0;
+    laneGridCellSize = 0;
+    laneGridCols = 0;
+    laneGridRows = 0;
 }
 
 MapFacilities::~MapFacilities() {
@@ -164,6 +169,50 @@ Lane* MapFacilities::convertPoint2Map(Point2D& pos) {
         abort();
     }
 
+    if (!laneGrid.empty()) {
+        // Visit the grid cells ring by ring around the point, until the cells left cannot contain a closer segment.
+        // The projection of the point on the grid is never farther from a segment than the point itself, so the
+        // rings are centered on it. Ties are solved as the full scan does: the first segment in the lanes order wins.
+        float qx = min(max(pos.x(), laneGridOrigin.x()), laneGridOrigin.x() + laneGridCols * laneGridCellSize);
+        float qy = min(max(pos.y(), laneGridOrigin.y()), laneGridOrigin.y() + laneGridRows * laneGridCellSize);
+        int col = getLaneGridCol(qx);
+        int row = getLaneGridRow(qy);
+        int maxRing = max(max(col, laneGridCols - 1 - col), max(row, laneGridRows - 1 - row));
+        unsigned int resultOrder = 0;
+        for (int ring = 0; ring <= maxRing; ring++) {
+            for (int r = max(row - ring, 0); r <= min(row + ring, laneGridRows - 1); r++) {
+                // inner rows only have the two cells at the ends of the ring
+                bool fullRow = (r == row - ring) || (r == row + ring);
+                int colStep = fullRow ? 1 : 2 * ring;
+                for (int c = col - ring; c <= col + ring; c += colStep) {
+                    if (c < 0 || c >= laneGridCols) {
+                        continue;
+                    }
+                    const vector<unsigned int>& cell = laneGrid[r * laneGridCols + c];
+                    for (vector<unsigned int>::const_iterator itS = cell.begin(); itS != cell.end(); itS++) {
+                        const LaneSegment& segment = laneSegments[*itS];
+                        newDistance = closestDistancePointLine(pos, segment.start, segment.end, intersection);
+                        if (newDistance < minDistance || (newDistance == minDistance && segment.order < resultOrder)) {
+                            minDistance = newDistance;
+                            result = segment.lane;
+                            resultOrder = segment.order;
+                        }
+                    }
+                }
+            }
+            // distance from the projected point to the border of the cells visited so far,
+            // with a margin for the rounding of the distances
+            float reach = min(min(qx - (laneGridOrigin.x() + (col - ring) * laneGridCellSize),
+                                  laneGridOrigin.x() + (col + ring + 1) * laneGridCellSize - qx),
+                              min(qy - (laneGridOrigin.y() + (row - ring) * laneGridCellSize),
+                                  laneGridOrigin.y() + (row + ring + 1) * laneGridCellSize - qy));
+            if (result != NULL && minDistance + 1.0f < reach) {
+                break;
+            }
+        }
+        return result;
+    }
+
     map<roadElementID_t, Lane>::iterator itL;
     for (itL = lanes.begin(); itL != lanes.end(); itL++) {
         Lane* currLane = (Lane*) &itL->second;
@@ -561,6 +610,8 @@ bool MapFacilities::mapParser(string mapFilename) {
         }
     }
 
+    buildLaneGrid();
+
     configFlag = true;
 
 #elif VANETMOBISIM_ON
@@ -577,6 +628,81 @@ bool MapFacilities::mapParser(string mapFilename) {
     return configFlag;
 }
 
+void MapFacilities::buildLaneGrid() {
+    laneSegments.clear();
+    laneGrid.clear();
+
+    float minX = HUGE_VAL;
+    float minY = HUGE_VAL;
+    float maxX = -HUGE_VAL;
+    float maxY = -HUGE_VAL;
+    unsigned int order = 0;
+    map<roadElementID_t, Lane>::iterator itL;
+    for (itL = lanes.begin(); itL != lanes.end(); itL++) {
+        const vector<Point2D>& currLaneShape = itL->second.getShape();
+        for (unsigned int i = 0; i + 1 < currLaneShape.size(); i++, order++) {
+            const Point2D& lineStart = currLaneShape[i];
+            const Point2D& lineEnd = currLaneShape[i + 1];
+            // a segment without length is never closer than the other segments found by the full scan
+            if (lineStart == lineEnd) {
+                continue;
+            }
+            LaneSegment segment;
+            segment.lane = &itL->second;
+            segment.order = order;
+            segment.start = lineStart;
+            segment.end = lineEnd;
+            laneSegments.push_back(segment);
+            minX = min(minX, min(lineStart.x(), lineEnd.x()));
+            minY = min(minY, min(lineStart.y(), lineEnd.y()));
+            maxX = max(maxX, max(lineStart.x(), lineEnd.x()));
+            maxY = max(maxY, max(lineStart.y(), lineEnd.y()));
+        }
+    }
+
+    if (laneSegments.empty()) {
+        return;
+    }
+
+    // about one segment per cell, cells not smaller than a few lane widths
+    float width = maxX - minX;
+    float height = maxY - minY;
+    laneGridCellSize = max(10.0f, (float) sqrt(width * height / laneSegments.size()));
+    laneGridCols = (int)(width / laneGridCellSize) + 1;
+    laneGridRows = (int)(height / laneGridCellSize) + 1;
+    laneGridOrigin.set(minX, minY);
+    laneGrid.assign(laneGridCols * laneGridRows, vector<unsigned int>());
+
+    // every segment is stored in all the cells its bounding box overlaps
+    for (unsigned int i = 0; i < laneSegments.size(); i++) {
+        const LaneSegment& segment = laneSegments[i];
+        int colStart = getLaneGridCol(min(segment.start.x(), segment.end.x()));
+        int colEnd = getLaneGridCol(max(segment.start.x(), segment.end.x()));
+        int rowStart = getLaneGridRow(min(segment.start.y(), segment.end.y()));
+        int rowEnd = getLaneGridRow(max(segment.start.y(), segment.end.y()));
+        for (int r = rowStart; r <= rowEnd; r++) {
+            for (int c = colStart; c <= colEnd; c++) {
+                laneGrid[r * laneGridCols + c].push_back(i);
+            }
+        }
+    }
+
+#ifdef _DEBUG_MAP
+    cout << "[facilities] DEB: Lane grid of " << laneGridCols << "x" << laneGridRows << " cells of " << laneGridCellSize
+         << "m for " << laneSegments.size() << " segments" << endl;
+#endif // _DEBUG
+}
+
+int MapFacilities::getLaneGridCol(float x) const {
+    int col = (int) floor((x - laneGridOrigin.x()) / laneGridCellSize);
+    return min(max(col, 0), laneGridCols - 1);
+}
+
+int MapFacilities::getLaneGridRow(float y) const {
+    int row = (int) floor((y - laneGridOrigin.y()) / laneGridCellSize);
+    return min(max(row, 0), laneGridRows - 1);
+}
+
 float MapFacilities::closestDistancePointLine(const Point2D& point, /**< Coordinates of the point (x,y). */
         const Point2D& lineStart, /**< Coordinates of the first point of the line. */
         const Point2D& lineEnd, /**< Coordinates of the last point of the line. */
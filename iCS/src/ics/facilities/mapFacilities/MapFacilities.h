@@ -263,6 +263,54 @@ private:
     /// @brief Altitude of the origin coordinate.
     altitude_t originAltitude;
 
+    /**
+    * @struct LaneSegment
+    * @brief Segment of a lane shape, as indexed by the lane grid.
+    */
+    struct LaneSegment {
+        /// @brief Lane the segment belongs to.
+        Lane* lane;
+        /// @brief Position of the segment in the order convertPoint2Map() scans the lanes.
+        unsigned int order;
+        /// @brief First point of the segment.
+        Point2D start;
+        /// @brief Last point of the segment.
+        Point2D end;
+    };
+
+    /// @brief All the lane segments with a non-zero length.
+    vector<LaneSegment> laneSegments;
+
+    /// @brief Uniform grid over the map: for every cell, the indexes (in laneSegments) of the segments crossing it.
+    vector<vector<unsigned int> > laneGrid;
+
+    /// @brief Lower left corner of the lane grid.
+    Point2D laneGridOrigin;
+
+    /// @brief Side of the (square) cells of the lane grid.
+    float laneGridCellSize;
+
+    /// @brief Number of columns of the lane grid.
+    int laneGridCols;
+
+    /// @brief Number of rows of the lane grid.
+    int laneGridRows;
+
+    /**
+    * @brief Indexes the segments of all the lane shapes in a uniform grid, used by convertPoint2Map().
+    */
+    void buildLaneGrid();
+
+    /**
+    * @brief Returns the column of the lane grid containing a x coordinate (clamped to the grid).
+    */
+    int getLaneGridCol(float x) const;
+
+    /**
+    * @brief Returns the row of the lane grid containing a y coordinate (clamped to the grid).
+    */
+    int getLaneGridRow(float y) const;
+
     /**
     * @brief Finds the distance of a point from a line.
     * @param[in] &point Reference to the point.
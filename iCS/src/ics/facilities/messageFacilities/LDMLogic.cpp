@@ -99,6 +99,9 @@ LDMLogic::~LDMLogic() {
         }
         iFMT.clear();
     }
+    receiverIndex.clear();
+    senderIndex.clear();
+    typeIndex.clear();
     if (!stationsSeqNoRecord.empty()) {
         stationsSeqNoRecord.clear();
     }
@@ -108,6 +111,7 @@ LDMLogic::~LDMLogic() {
     if (!deletionList.empty()) {
         deletionList.clear();
     }
+    payloadBuckets.clear();
     if (!relevantArea.empty()) {
         for (vector<Area2D*>::iterator it = relevantArea.begin(); it != relevantArea.end(); it++) {
             delete *it;
@@ -145,15 +149,12 @@ FacilityMessagePayload* LDMLogic::getReceivedMessagePayload(actionID_t actionID)
 
 map<actionID_t, ReceivedMessage*>* LDMLogic::getLDM(stationID_t stationID) {
     map<actionID_t, ReceivedMessage*>* LDM = new map<actionID_t, ReceivedMessage*>();
-    map<actionID_t, ReceivedMessage*>::iterator it;
-    for (it = iFMT.begin(); it != iFMT.end(); it++) {
-        ReceivedMessage* currMessage = it->second;
-        vector<Receiver> receivers = currMessage->getReceiversList();
-
-        for (vector<Receiver>::iterator itV = receivers.begin(); itV != receivers.end(); itV++) {
-            if (itV->receiverID == stationID) {
-                LDM->insert(pair<actionID_t, ReceivedMessage*>(it->first, currMessage));
-            }
+    map<stationID_t, map<messageType_t, map<actionID_t, ReceivedMessage*> > >::const_iterator itRec =
+        receiverIndex.find(stationID);
+    if (itRec != receiverIndex.end()) {
+        map<messageType_t, map<actionID_t, ReceivedMessage*> >::const_iterator itType;
+        for (itType = itRec->second.begin(); itType != itRec->second.end(); itType++) {
+            LDM->insert(itType->second.begin(), itType->second.end());
         }
     }
     return LDM;
@@ -163,7 +164,7 @@ map<actionID_t, ReceivedMessage*>* LDMLogic::getLastMessages(icstime_t startTime
     map<actionID_t, ReceivedMessage*>* lastMessages = new map<actionID_t, ReceivedMessage*>();
     map<actionID_t, ReceivedMessage*>::iterator it;
     for (it = iFMT.begin(); it != iFMT.end(); it++) {
-        vector<Receiver> receiversList = it->second->getReceiversList();
+        const vector<Receiver>& receiversList = it->second->getReceiversList();
         if ((receiversList.size() > 0) && (receiversList[0].receptionTime >= startTime)) {
             lastMessages->insert(pair<actionID_t, ReceivedMessage*>(it->first, it->second));
         }
@@ -172,28 +173,19 @@ map<actionID_t, ReceivedMessage*>* LDMLogic::getLastMessages(icstime_t startTime
 }
 
 map<actionID_t, ReceivedMessage*>* LDMLogic::getAllSpecificMessages(messageType_t type) {
-    map<actionID_t, ReceivedMessage*>* specificMessages = new map<actionID_t, ReceivedMessage*>();
-    map<actionID_t, ReceivedMessage*>::iterator it;
-    for (it = iFMT.begin(); it != iFMT.end(); it++) {
-        ReceivedMessage* currMessage = it->second;
-        if (currMessage->getMessageType() == type) {
-            specificMessages->insert(pair<actionID_t, ReceivedMessage*>(it->first, currMessage));
-        }
+    map<messageType_t, map<actionID_t, ReceivedMessage*> >::const_iterator it = typeIndex.find(type);
+    if (it == typeIndex.end()) {
+        return new map<actionID_t, ReceivedMessage*>();
     }
-    return specificMessages;
+    return new map<actionID_t, ReceivedMessage*>(it->second);
 }
 
 map<actionID_t, ReceivedMessage*>* LDMLogic::getMessagesFromSender(stationID_t stationID) {
-    map<actionID_t, ReceivedMessage*>* senderMessages = new map<actionID_t, ReceivedMessage*>();
-    map<actionID_t, ReceivedMessage*>::iterator it;
-    for (it = iFMT.begin(); it != iFMT.end(); it++) {
-        ReceivedMessage* currMessage = it->second;
-        const FacilityMessagePayload* messagePayload = currMessage->getPayload();
-        if (messagePayload->getSenderID() == stationID) {
-            senderMessages->insert(pair<actionID_t, ReceivedMessage*>(it->first, currMessage));
-        }
+    map<stationID_t, map<actionID_t, ReceivedMessage*> >::const_iterator it = senderIndex.find(stationID);
+    if (it == senderIndex.end()) {
+        return new map<actionID_t, ReceivedMessage*>();
     }
-    return senderMessages;
+    return new map<actionID_t, ReceivedMessage*>(it->second);
 }
 
 CAMPayloadGeneral* LDMLogic::getLastGeneratedCAM(stationID_t stationID) {
@@ -251,7 +243,7 @@ map<stationID_t, Point2D>* LDMLogic::getClassifiedStationsPositionsAroundStation
     map<stationID_t, Point2D>* result = new map<stationID_t, Point2D>();
     vector<ReceivedMessage*> interestingReceivedMessages = getReceivedTypeMessagesFromStation(receiverID, CAM);
     for (unsigned int i = 0; i < interestingReceivedMessages.size(); i++) {
-        vector<Receiver> receiversList = (interestingReceivedMessages[i])->getReceiversList();
+        const vector<Receiver>& receiversList = (interestingReceivedMessages[i])->getReceiversList();
         if ((receiversList.size() > 0) && (receiversList[0].receptionTime >= start)
                 && (receiversList[0].receptionTime <= start)) {
             const FacilityMessagePayload* payload = (interestingReceivedMessages[i])->getPayload();
@@ -978,6 +970,7 @@ bool LDMLogic::storeMessage(actionID_t actionID, vector<stationID_t> receivers)
         if (entry_found_in_iFMT) {
             // Add the receiver to the receivers' vector
             recMsg->addReceivers(relevantReceivers);
+            indexReceivers(recMsg, relevantReceivers);
         }
 
         // If the payload is still in the iFPT
@@ -985,6 +978,8 @@ bool LDMLogic::storeMessage(actionID_t actionID, vector<stationID_t> receivers)
             // Create a new entry in the iFMT for the message
             recMsg->setReceivers(relevantReceivers);
             iFMT.insert(pair<actionID_t, ReceivedMessage*>(actionID, recMsg));
+            indexMessage(recMsg);
+            indexReceivers(recMsg, relevantReceivers);
             // Delete the entry from the iFPT without deleting the payload itself that has been now stored in the iFMT
             iFPT.erase(it_iFPT);
         }
@@ -1064,10 +1059,16 @@ void LDMLogic::scheduleMessageRemoval(actionID_t actionID, icstime_t deletionTim
 int LDMLogic::iFPTCleanup(icstime_t deletionTime) {
     int number = 0;
     const int refTime = deletionTime - defaultMessageLifeInterval;
-    for (map<actionID_t, ReceivedMessage*>::iterator it = iFPT.begin(); it != iFPT.end();) {
-        int time = it->second->getPayload()->getTimeStamp();
-        //Use greater so they will stay one step longer
-        if (refTime > time) {
+    //Use greater so they will stay one step longer
+    map<icstime_t, vector<actionID_t> >::iterator itBucket = payloadBuckets.begin();
+    while (itBucket != payloadBuckets.end() && refTime > itBucket->first) {
+        const int time = itBucket->first;
+        for (vector<actionID_t>::iterator itID = itBucket->second.begin(); itID != itBucket->second.end(); itID++) {
+            map<actionID_t, ReceivedMessage*>::iterator it = iFPT.find(*itID);
+            // The payload was already moved to the iFMT or discarded, or its actionID has been reused since
+            if (it == iFPT.end() || it->second->getPayload()->getTimeStamp() != time) {
+                continue;
+            }
 
 #ifdef _DEBUG_MESSAGE_STORAGE
             {
@@ -1084,10 +1085,9 @@ int LDMLogic::iFPTCleanup(icstime_t deletionTime) {
             }
             delete it->second->getPayload();
             delete it->second;
-            iFPT.erase(it++);
-        } else {
-            ++it;
+            iFPT.erase(it);
         }
+        payloadBuckets.erase(itBucket++);
     }
     return number;
 }
@@ -1131,12 +1131,69 @@ bool LDMLogic::deleteMessage(actionID_t actionID) {
     if (payload != NULL) {
         payload->getDestination().DeleteAreas();
     }
+    unindexMessage(it->second);
     delete it->second->getPayload();
     delete it->second;
     iFMT.erase(it);
     return true;
 }
 
+void LDMLogic::indexMessage(ReceivedMessage* message) {
+    const actionID_t actionID = message->getActionID();
+    senderIndex[message->getPayload()->getSenderID()][actionID] = message;
+    typeIndex[message->getMessageType()][actionID] = message;
+}
+
+void LDMLogic::indexReceivers(ReceivedMessage* message, const vector<Receiver>& receivers) {
+    const actionID_t actionID = message->getActionID();
+    const messageType_t type = message->getMessageType();
+    for (vector<Receiver>::const_iterator it = receivers.begin(); it != receivers.end(); it++) {
+        receiverIndex[it->receiverID][type][actionID] = message;
+    }
+}
+
+void LDMLogic::unindexMessage(ReceivedMessage* message) {
+    const actionID_t actionID = message->getActionID();
+    const messageType_t type = message->getMessageType();
+
+    const vector<Receiver>& receivers = message->getReceiversList();
+    for (vector<Receiver>::const_iterator it = receivers.begin(); it != receivers.end(); it++) {
+        map<stationID_t, map<messageType_t, map<actionID_t, ReceivedMessage*> > >::iterator itRec =
+            receiverIndex.find(it->receiverID);
+        if (itRec == receiverIndex.end()) {
+            continue;
+        }
+        map<messageType_t, map<actionID_t, ReceivedMessage*> >::iterator itType = itRec->second.find(type);
+        if (itType == itRec->second.end()) {
+            continue;
+        }
+        itType->second.erase(actionID);
+        if (itType->second.empty()) {
+            itRec->second.erase(itType);
+            if (itRec->second.empty()) {
+                receiverIndex.erase(itRec);
+            }
+        }
+    }
+
+    map<stationID_t, map<actionID_t, ReceivedMessage*> >::iterator itSender =
+        senderIndex.find(message->getPayload()->getSenderID());
+    if (itSender != senderIndex.end()) {
+        itSender->second.erase(actionID);
+        if (itSender->second.empty()) {
+            senderIndex.erase(itSender);
+        }
+    }
+
+    map<messageType_t, map<actionID_t, ReceivedMessage*> >::iterator itType = typeIndex.find(type);
+    if (itType != typeIndex.end()) {
+        itType->second.erase(actionID);
+        if (itType->second.empty()) {
+            typeIndex.erase(itType);
+        }
+    }
+}
+
 // ===============================================================
 // ====================== Table Maintenance ======================
 // ===============================================================
@@ -1188,6 +1245,8 @@ bool LDMLogic::storePayload(actionID_t actionID, FacilityMessagePayload* payload
     check = iFPT.insert(pair<actionID_t, ReceivedMessage*>(actionID, message));
     if (!check.second) {
         delete (message);
+    } else {
+        payloadBuckets[payload->getTimeStamp()].push_back(actionID);
     }
     return check.second;
 }
@@ -1352,28 +1411,35 @@ bool LDMLogic::isMessageRelevant(const ReceivedMessage& message) {
 
 vector<ReceivedMessage*> LDMLogic::getReceivedMessagesFromStation(stationID_t receiverID) {
     vector<ReceivedMessage*> interestingReceivedMessages;
-    for (map<actionID_t, ReceivedMessage*>::iterator it = iFMT.begin(); it != iFMT.end(); it++) {
-        if (it->second->isStationAmongReceivers(receiverID)) {
-            interestingReceivedMessages.push_back(it->second);
-        }
+    map<actionID_t, ReceivedMessage*>* LDM = getLDM(receiverID);
+    for (map<actionID_t, ReceivedMessage*>::iterator it = LDM->begin(); it != LDM->end(); it++) {
+        interestingReceivedMessages.push_back(it->second);
     }
+    delete LDM;
     return interestingReceivedMessages;
 }
 
 vector<ReceivedMessage*> LDMLogic::getReceivedTypeMessagesFromStation(stationID_t receiverID, messageType_t type) {
     vector<ReceivedMessage*> interestingReceivedMessages;
-    for (map<actionID_t, ReceivedMessage*>::iterator it = iFMT.begin(); it != iFMT.end(); it++) {
-        if ((it->second->getMessageType() == type) && (it->second->isStationAmongReceivers(receiverID))) {
-            interestingReceivedMessages.push_back(it->second);
-        }
+    map<stationID_t, map<messageType_t, map<actionID_t, ReceivedMessage*> > >::const_iterator itRec =
+        receiverIndex.find(receiverID);
+    if (itRec == receiverIndex.end()) {
+        return interestingReceivedMessages;
+    }
+    map<messageType_t, map<actionID_t, ReceivedMessage*> >::const_iterator itType = itRec->second.find(type);
+    if (itType == itRec->second.end()) {
+        return interestingReceivedMessages;
+    }
+    interestingReceivedMessages.reserve(itType->second.size());
+    for (map<actionID_t, ReceivedMessage*>::const_iterator it = itType->second.begin(); it != itType->second.end(); it++) {
+        interestingReceivedMessages.push_back(it->second);
     }
     return interestingReceivedMessages;
 }
 
 icstime_t LDMLogic::getMessageReceptionTimeByReceiver(stationID_t receiverID, ReceivedMessage* message) {
-    vector<Receiver> receivers = message->getReceiversList();
-    vector<Receiver>::iterator it = receivers.begin();
-    for (vector<Receiver>::iterator it = receivers.begin(); it != receivers.end(); it++) {
+    const vector<Receiver>& receivers = message->getReceiversList();
+    for (vector<Receiver>::const_iterator it = receivers.begin(); it != receivers.end(); it++) {
         if (it->receiverID == receiverID) {
             return it->receptionTime;
         }
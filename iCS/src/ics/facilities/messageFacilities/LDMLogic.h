@@ -150,6 +150,19 @@ private:
     /// @brief Structure that keeps track of the message sequence number of each station
     map<stationID_t, seqNo_t> stationsSeqNoRecord;
 
+    //***********************
+    //**** iFMT Index structures ****
+    //***********************
+
+    /// @brief Messages of the iFMT received by each station, grouped by message type.
+    map<stationID_t, map<messageType_t, map<actionID_t, ReceivedMessage*> > > receiverIndex;
+
+    /// @brief Messages of the iFMT generated by each station.
+    map<stationID_t, map<actionID_t, ReceivedMessage*> > senderIndex;
+
+    /// @brief Messages of the iFMT of each message type.
+    map<messageType_t, map<actionID_t, ReceivedMessage*> > typeIndex;
+
     //***********************
     //**** iFMT Cleanup structures ****
     //***********************
@@ -160,6 +173,10 @@ private:
     /// @brief Dictionary that for each time step reports the vector of messages (actionID) to be deleted.
     map<icstime_t, vector<actionID_t> > deletionList;
 
+    /// @brief Dictionary that for each payload timestamp reports the vector of payloads (actionID) stored in the iFPT.
+    /// Entries whose payload already left the iFPT are skipped during the cleanup.
+    map<icstime_t, vector<actionID_t> > payloadBuckets;
+
     //***********************
     //**** Relevance variables ****
     //***********************
@@ -231,6 +248,25 @@ private:
      */
     bool deleteMessage(actionID_t actionID);
 
+    /**
+     * @brief Add a message of the iFMT to the sender and type indexes.
+     * @param[in] message Pointer to the message.
+     */
+    void indexMessage(ReceivedMessage* message);
+
+    /**
+     * @brief Add the receivers of a message of the iFMT to the receiver index.
+     * @param[in] message Pointer to the message.
+     * @param[in] receivers Receivers to be indexed.
+     */
+    void indexReceivers(ReceivedMessage* message, const vector<Receiver>& receivers);
+
+    /**
+     * @brief Remove a message of the iFMT from all the indexes.
+     * @param[in] message Pointer to the message.
+     */
+    void unindexMessage(ReceivedMessage* message);
+
     //***********************
     //**** Table Maintenance Methods ****
     //***********************
@@ -63,6 +63,7 @@ StationFacilities::StationFacilities(MapFacilities* mapFac) {
     this->mapFac = mapFac;
 
     recordMobilityHistory = true;
+    mobilityHistoryRetention = 0;
     mobilityHistoryFilename = "position-log.txt";
 
 }
@@ -96,6 +97,8 @@ bool StationFacilities::configure(string stationConfigFilename) {
 
     RandHelper::initRand(&staFacRand, false, staConfig.getRATseed());
 
+    mobilityHistoryRetention = staConfig.getMobilityHistoryRetention();
+
     map<int, float> penRates = staConfig.getDefaultPenetrationRates();
     map<int, float>::iterator itPenRates;
     for (itPenRates = penRates.begin(); itPenRates != penRates.end(); itPenRates++) {
@@ -626,87 +629,93 @@ bool StationFacilities::isStationOfType(stationID_t stationID, icsstationtype_t
 
 void StationFacilities::updateMobilityHistory(stationID_t vehicleId, icstime_t time, Point2D pos) {
 
-    map<icstime_t, vector<pair<stationID_t, Point2D> > >::iterator it;
+    map<icstime_t, MobilityHistoryStep>::iterator it;
     it = mobilityHistory.find(time);
     if (it != mobilityHistory.end()) {
-        it->second.push_back(pair<stationID_t, Point2D>(vehicleId, pos));
 #ifdef _DEBUG_STATIONS
         std::cout << "[StationFacilities][updateMobilityHistory] UPDATE Time " << time << ", pos x " << pos.x() << ", y " << pos.y() << std::endl;
 #endif
     } else {
-        vector<pair<stationID_t, Point2D> > posHistory;
-        posHistory.push_back(pair<stationID_t, Point2D>(vehicleId, pos));
-        mobilityHistory.insert(pair<icstime_t, vector<pair<stationID_t, Point2D> > >(time, posHistory));
+        it = mobilityHistory.insert(pair<icstime_t, MobilityHistoryStep>(time, MobilityHistoryStep())).first;
 #ifdef _DEBUG_STATIONS
         std::cout << "[StationFacilities][updateMobilityHistory] INSERT Time " << time << ", pos x " << pos.x() << ", y " << pos.y() << std::endl;
 #endif
+        dropOldMobilityHistory(time);
     }
+    it->second.lastPosition[vehicleId] = it->second.positions.size();
+    it->second.positions.push_back(pair<stationID_t, Point2D>(vehicleId, pos));
 
 #ifdef _DEBUG_STATIONS
-    map<stationID_t, Point2D > posMobility = getPositionFromMobilityHistory();
-    std::map<stationID_t, Point2D >::iterator itPos = posMobility.find(vehicleId);
-    if (itPos != posMobility.end()) {
-        std::cout << "[StationFacilities][updateMobileStationDynamicInformation] node id " << vehicleId << ", x " << itPos->second.x() << ", y " << itPos->second.y() << std::endl;
-    }
+    Point2D posMobility = getNodePositionFromMobilityHistory(time, vehicleId);
+    std::cout << "[StationFacilities][updateMobileStationDynamicInformation] node id " << vehicleId << ", x " << posMobility.x() << ", y " << posMobility.y() << std::endl;
 #endif
 
     return;
 }
 
+void StationFacilities::dropOldMobilityHistory(icstime_t time) {
+    if (mobilityHistoryRetention <= 0) {
+        return;
+    }
+    map<icstime_t, MobilityHistoryStep>::iterator it = mobilityHistory.begin();
+    while (it != mobilityHistory.end() && it->first < time - mobilityHistoryRetention) {
+        if (openMobilityHistoryFile()) {
+            writeMobilityHistoryStep(it->first, it->second);
+        }
+        mobilityHistory.erase(it++);
+    }
+}
+
+bool StationFacilities::openMobilityHistoryFile() {
+    if (!mobilityHistoryFile.is_open()) {
+        mobilityHistoryFile.open(mobilityHistoryFilename.c_str());
+    }
+    if (mobilityHistoryFile.bad()) {
+        cerr << "[facilities] Impossible to write the mobility history file." << endl;
+        return false;
+    }
+    return true;
+}
+
+void StationFacilities::writeMobilityHistoryStep(icstime_t time, const MobilityHistoryStep& step) {
+    for (unsigned int i = 0; i < step.positions.size(); i++) {
+        // line-format: NODEID TIME (X, Y)
+        mobilityHistoryFile << step.positions[i].first << "\t" << time << "\t" <<
+                            "(" << step.positions[i].second.x() << ", " <<  step.positions[i].second.y() << ")" << "\n";
+    }
+}
+
 void StationFacilities::createMobilityHistoryFile() {
 
     cout << "[facilities] Write the mobility history file." << endl;
 
-    ofstream outfile;
-    outfile.open(mobilityHistoryFilename.c_str());
-    if (outfile.bad()) {
-        cerr << "[facilities] Impossible to write the mobility history file." << endl;
+    if (!openMobilityHistoryFile()) {
         return;
     }
-    map<icstime_t, vector<pair<stationID_t, Point2D> > >::iterator it;
+    map<icstime_t, MobilityHistoryStep>::iterator it;
     for (it = mobilityHistory.begin(); it != mobilityHistory.end(); it++) {
-        icstime_t currTimeStep = it->first;
-        for (unsigned int i = 0; i < it->second.size(); i++) {
-            // line-format: NODEID TIME (X, Y)
-            outfile << it->second[i].first << "\t" << currTimeStep << "\t" <<
-                    "(" << it->second[i].second.x() << ", " <<  it->second[i].second.y() << ")" << endl;
-        }
+        writeMobilityHistoryStep(it->first, it->second);
     }
-    outfile.close();
+    mobilityHistory.clear();
+    mobilityHistoryFile.close();
 }
 
 
 Point2D StationFacilities::getNodePositionFromMobilityHistory(icstime_t time, stationID_t stationId) {
-    map<icstime_t, vector<pair<stationID_t, Point2D> > >::reverse_iterator rit;
     Point2D  pos(-101.0, -101.0);
 
-    int i = 0;
-    if (!mobilityHistory.empty()) {
-        for (rit = mobilityHistory.rbegin(); rit != mobilityHistory.rend(); ++rit) {
-            i = i + 1;
-            if (time == rit->first) {
-                for (int unsigned it = (rit->second.size() - 1); it > 0 ; --it) {
-                    if (stationId == rit->second[it].first) {
-#ifdef _DEBUG_STATIONS
-                        std::cout << "[StationFacilities][getPositionFromMobilityHistory] timestep " << rit->first << ", id " << rit->second[it].first << ", pos x " << rit->second[it].second.x() << std::endl;
-#endif
-                        return rit->second[it].second;
-                    }
-                }
-
-                if (stationId == rit->second[0].first) {
+    map<icstime_t, MobilityHistoryStep>::const_iterator itStep = mobilityHistory.find(time);
+    if (itStep != mobilityHistory.end()) {
+        unordered_map<stationID_t, unsigned int>::const_iterator itPos = itStep->second.lastPosition.find(stationId);
+        if (itPos != itStep->second.lastPosition.end()) {
 #ifdef _DEBUG_STATIONS
-                    std::cout << "[StationFacilities][getPositionFromMobilityHistory] item 0 timestep " << rit->first << ", id " << rit->second[0].first << ", pos x" << rit->second[0].second.x() << std::endl;
+            std::cout << "[StationFacilities][getPositionFromMobilityHistory] timestep " << time << ", id " << stationId << ", pos x " << itStep->second.positions[itPos->second].second.x() << std::endl;
 #endif
-                    return  rit->second[0].second;
-                }
-            }
-
+            return itStep->second.positions[itPos->second].second;
         }
     }
     return pos;
 }
 
 
-
 }
@@ -39,8 +39,10 @@
 #endif
 
 #include <map>
+#include <unordered_map>
 #include <string>
 #include <random>
+#include <fstream>
 using namespace std;
 
 #include "../mapFacilities/MapFacilities.h"
@@ -249,12 +251,26 @@ private:
     ///@brief This variable allows to generate a trace file containing the position history of all the vehicles.
     bool recordMobilityHistory;
 
+    ///@brief Positions recorded in a time step.
+    struct MobilityHistoryStep {
+        ///@brief Positions in the order they were received (used for the trace file).
+        vector<pair<stationID_t, Point2D> > positions;
+        ///@brief For each station, the index of its last position in 'positions'.
+        unordered_map<stationID_t, unsigned int> lastPosition;
+    };
+
     ///@brief This data structure stores for all the vehicles their position history. This data structure is used ONLY 'recordMobilityHistory' is true.
-    map<icstime_t, vector<pair<stationID_t, Point2D> > > mobilityHistory;
+    map<icstime_t, MobilityHistoryStep> mobilityHistory;
+
+    ///@brief Time (in ms) a step is kept in the mobility history after a newer step has been recorded. 0 keeps the whole history.
+    icstime_t mobilityHistoryRetention;
 
     ///@brief This variable contains the trace file containing the position history of all the vehicles. The file is generated when the class destructor is called.
     string mobilityHistoryFilename;
 
+    ///@brief Trace file the steps dropped from the mobility history are written to. It is opened on the first drop.
+    ofstream mobilityHistoryFile;
+
     /**
     * @brief Given a pointer to a Lane object, it returns which stations are on that lane.
     * @param[in] lane Pointer to a Lane object.
@@ -286,6 +302,23 @@ private:
     */
     void createMobilityHistoryFile();
 
+    /**
+    * @brief Write the steps older than the retention horizon to the trace file and remove them from the mobility history.
+    * @param[in] time Most recent time step of the mobility history.
+    */
+    void dropOldMobilityHistory(icstime_t time);
+
+    /**
+    * @brief Open the mobility history trace file, if it is not open yet.
+    * @return True if the file can be written.
+    */
+    bool openMobilityHistoryFile();
+
+    /**
+    * @brief Write the positions of a time step to the mobility history trace file.
+    */
+    void writeMobilityHistoryStep(icstime_t time, const MobilityHistoryStep& step);
+
 };
 
 }
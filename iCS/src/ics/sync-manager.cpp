@@ -574,6 +574,12 @@ int SyncManager::RunOneSumoTimeStep() {
 #endif
             }
 
+            // Subscribe the vehicle's dynamic variables, they are then received with every simulation step
+            if (!m_trafficSimCommunicator->SubscribeVehicleVariables(*vehicle)) {
+                IcsLog::LogLevel("RunOneSumoTimeStep() Could not subscribe vehicle variables, falling back to single queries.",
+                                 kLogLevelWarning);
+            }
+
             // Get additional info from SUMO and Create the new station in the facilities
             std::pair<float, float> pos = m_trafficSimCommunicator->GetPosition(*vehicle);
             float speed = m_trafficSimCommunicator->GetSpeed(*vehicle);
@@ -659,10 +665,18 @@ int SyncManager::RunOneSumoTimeStep() {
         }
         VehicleNode* vehicle = (VehicleNode*) it->second;
 
-        // Get additional info from SUMO and Create the new station in the facilities
-        std::pair<float, float> pos = m_trafficSimCommunicator->GetPosition(*vehicle);
+        // Get additional info from SUMO (subscribed with the simulation step) and update the station in the facilities
+        std::pair<float, float> pos;
+        float speed;
+        const TSubscribedVehicleState* state = m_trafficSimCommunicator->GetSubscribedVehicleState(*vehicle);
+        if (state != NULL) {
+            pos = make_pair(state->positionX, state->positionY);
+            speed = state->speed;
+        } else {
+            pos = m_trafficSimCommunicator->GetPosition(*vehicle);
+            speed = m_trafficSimCommunicator->GetSpeed(*vehicle);
+        }
         vehicle->CheckPosition(pos);
-        float speed = m_trafficSimCommunicator->GetSpeed(*vehicle);
 
         TMobileStationDynamicInfo info;
         fillDynamicInfo(info, vehicle, pos, speed);
@@ -725,6 +739,15 @@ int SyncManager::SendSimStepToApplications() {
 int SyncManager::RunApplicationLogic() {
     bool success = true;
 
+    bool batchMode = !m_applicationHandlerCollection->empty();
+    for (vector<ApplicationHandler*>::iterator appsIt = m_applicationHandlerCollection->begin();
+            appsIt != m_applicationHandlerCollection->end(); ++appsIt) {
+        batchMode = batchMode && (*appsIt)->m_appMessageManager->IsBatchModeEnabled();
+    }
+    if (batchMode) {
+        return RunApplicationLogicBatched();
+    }
+
     for (NodeMap::iterator nodeIt = m_iTetrisNodeMap->begin(); nodeIt != m_iTetrisNodeMap->end(); ++nodeIt) {
         ITetrisNode* currentNode = nodeIt->second;
         if (currentNode->m_applicationHandlerInstalled->size() != 0) {
@@ -733,33 +756,7 @@ int SyncManager::RunApplicationLogic() {
                 return EXIT_FAILURE;
             }
 
-            map<stationID_t, icstime_t >::iterator itTime = m_firstTimeOutOfZone.find(currentNode->m_icsId);
-            if (itTime != m_firstTimeOutOfZone.end()) {
-                if ((itTime->second != m_simStep) && (itTime->second / 1000) == (m_simStep / 1000)) {
-                    //get position from mobility history
-#ifdef _DEBUG_MOBILITY
-                    std::cout << "m_firstTimeOutOfZone timestep " << itTime->second << ", current timestep " << m_simStep << std::endl;
-#endif
-                    Point2D pos = m_facilitiesManager->getStationPositionsFromMobilityHistory(itTime->second, currentNode->m_icsId);
-                    //If position is correct, send information to NS-3
-                    if ((pos.x() > -100.0) || (pos.y() > -100.0)) {
-                        VehicleNode* vehicle = dynamic_cast<VehicleNode*>(currentNode);
-                        std::pair<float, float> posFromSUMO = m_trafficSimCommunicator->GetPosition(*vehicle);
-                        //if the same pos as from SUMO -> do nothing
-                        if ((pos.x() != posFromSUMO.first) || (pos.y() != posFromSUMO.second)) {
-                            // Get additional info from SUMO, Create the new station in the facilities and update...
-                            float speed = m_trafficSimCommunicator->GetSpeed(*vehicle);
-                            TMobileStationDynamicInfo info;
-                            fillDynamicInfo(info, vehicle, make_pair(pos.x(), pos.y()), speed);
-                            m_facilitiesManager->updateMobileStationDynamicInformation(vehicle->m_icsId, info);
-#ifdef _DEBUG_MOBILITY
-                            cout << "iCS -->SubsAppControlTraci  Updated node's position: (node " << currentNode->m_icsId << "), SUMO - pos (" << posFromSUMO.first << "," << posFromSUMO.second << ")" << ", New pos (" << pos.x() << "," << pos.y() << ") " <<  " at TS " << m_simStep << " " << endl;
-#endif
-                        }
-                    }
-
-                }
-            }
+            UpdatePositionFromMobilityHistory(currentNode);
 
             if (DropSubscriptions(currentNode) == EXIT_FAILURE) {
                 cout << "iCS --> [ERROR] RunApplicationLogic() in DropSubscriptions." << endl;
@@ -792,16 +789,115 @@ int SyncManager::RunApplicationLogic() {
 }
 
 
+int SyncManager::RunApplicationLogicBatched() {
+    vector<ITetrisNode*> nodes;
+    for (NodeMap::iterator nodeIt = m_iTetrisNodeMap->begin(); nodeIt != m_iTetrisNodeMap->end(); ++nodeIt) {
+        if (nodeIt->second->m_applicationHandlerInstalled->size() != 0) {
+            nodes.push_back(nodeIt->second);
+        }
+    }
+
+    if (NewSubscriptions(nodes) == EXIT_FAILURE) {
+        cout << "iCS --> [ERROR] RunApplicationLogic() in NewSubscriptions." << endl;
+        return EXIT_FAILURE;
+    }
+
+    for (vector<ITetrisNode*>::iterator nodeIt = nodes.begin(); nodeIt != nodes.end(); ++nodeIt) {
+        UpdatePositionFromMobilityHistory(*nodeIt);
+    }
+
+    if (DropSubscriptions(nodes) == EXIT_FAILURE) {
+        cout << "iCS --> [ERROR] RunApplicationLogic() in DropSubscriptions." << endl;
+        return EXIT_FAILURE;
+    }
+
+    // The subscribed data and the message status are only acknowledged by the applications,
+    // they are sent in a single message per application
+    for (vector<ApplicationHandler*>::iterator appsIt = m_applicationHandlerCollection->begin();
+            appsIt != m_applicationHandlerCollection->end(); ++appsIt) {
+        (*appsIt)->m_appMessageManager->BeginBatch();
+    }
+
+    bool success = true;
+    for (vector<ITetrisNode*>::iterator nodeIt = nodes.begin(); nodeIt != nodes.end() && success; ++nodeIt) {
+        if (ForwardSubscribedDataToApplication(*nodeIt) == EXIT_FAILURE) {
+            cout << "iCS --> [ERROR] RunApplicationLogic() in ForwardSubscribedDataToApplication." << endl;
+            success = false;
+        } else if (DeliverMessageStatus(*nodeIt) == EXIT_FAILURE) {
+            cout << "iCS --> [ERROR] RunApplicationLogic() in DeliverMessageStatus." << endl;
+            success = false;
+        }
+    }
+
+    for (vector<ApplicationHandler*>::iterator appsIt = m_applicationHandlerCollection->begin();
+            appsIt != m_applicationHandlerCollection->end(); ++appsIt) {
+        if (!(*appsIt)->m_appMessageManager->FlushBatch() && success) {
+            cout << "iCS --> [ERROR] RunApplicationLogic() in ForwardSubscribedDataToApplication." << endl;
+            success = false;
+        }
+    }
+
+    if (!success) {
+        return EXIT_FAILURE;
+    }
+
+    if (ExecuteApplicationMainFunction(nodes) == EXIT_FAILURE) {
+        cout << "iCS --> [ERROR] RunApplicationLogic() in ExecuteApplicationMainFunction." << endl;
+        return EXIT_FAILURE;
+    }
+
+    cout << endl;
+    return EXIT_SUCCESS;
+}
+
+void SyncManager::UpdatePositionFromMobilityHistory(ITetrisNode* node) {
+    map<stationID_t, icstime_t >::iterator itTime = m_firstTimeOutOfZone.find(node->m_icsId);
+    if (itTime != m_firstTimeOutOfZone.end()) {
+        if ((itTime->second != m_simStep) && (itTime->second / 1000) == (m_simStep / 1000)) {
+            //get position from mobility history
+#ifdef _DEBUG_MOBILITY
+            std::cout << "m_firstTimeOutOfZone timestep " << itTime->second << ", current timestep " << m_simStep << std::endl;
+#endif
+            Point2D pos = m_facilitiesManager->getStationPositionsFromMobilityHistory(itTime->second, node->m_icsId);
+            //If position is correct, send information to NS-3
+            if ((pos.x() > -100.0) || (pos.y() > -100.0)) {
+                VehicleNode* vehicle = dynamic_cast<VehicleNode*>(node);
+                std::pair<float, float> posFromSUMO = m_trafficSimCommunicator->GetPosition(*vehicle);
+                //if the same pos as from SUMO -> do nothing
+                if ((pos.x() != posFromSUMO.first) || (pos.y() != posFromSUMO.second)) {
+                    // Get additional info from SUMO, Create the new station in the facilities and update...
+                    float speed = m_trafficSimCommunicator->GetSpeed(*vehicle);
+                    TMobileStationDynamicInfo info;
+                    fillDynamicInfo(info, vehicle, make_pair(pos.x(), pos.y()), speed);
+                    m_facilitiesManager->updateMobileStationDynamicInformation(vehicle->m_icsId, info);
+#ifdef _DEBUG_MOBILITY
+                    cout << "iCS -->SubsAppControlTraci  Updated node's position: (node " << node->m_icsId << "), SUMO - pos (" << posFromSUMO.first << "," << posFromSUMO.second << ")" << ", New pos (" << pos.x() << "," << pos.y() << ") " <<  " at TS " << m_simStep << " " << endl;
+#endif
+                }
+            }
+
+        }
+    }
+}
+
 void SyncManager::fillDynamicInfo(TMobileStationDynamicInfo& info, VehicleNode* vehicle, const pair<double, double>& pos, const double speed) {
     info.speed = speed;
     info.acceleration = vehicle->ChangeSpeed(speed);
-    info.direction = m_trafficSimCommunicator->GetDirection(*vehicle);
     info.exteriorLights = m_trafficSimCommunicator->GetExteriorLights(*vehicle);
     info.positionX = pos.first;
     info.positionY = pos.second;
-    info.length = m_trafficSimCommunicator->GetVehicleLength(*vehicle);
-    info.width = m_trafficSimCommunicator->GetVehicleWidth(*vehicle);
-    info.lane = m_trafficSimCommunicator->GetLane(*vehicle);
+    const TSubscribedVehicleState* state = m_trafficSimCommunicator->GetSubscribedVehicleState(*vehicle);
+    if (state != NULL) {
+        info.direction = state->direction;
+        info.length = state->length;
+        info.width = state->width;
+        info.lane = state->lane;
+    } else {
+        info.direction = m_trafficSimCommunicator->GetDirection(*vehicle);
+        info.length = m_trafficSimCommunicator->GetVehicleLength(*vehicle);
+        info.width = m_trafficSimCommunicator->GetVehicleWidth(*vehicle);
+        info.lane = m_trafficSimCommunicator->GetLane(*vehicle);
+    }
     info.timeStep = m_simStep;
 }
 
@@ -972,21 +1068,31 @@ int SyncManager::UpdatePositionsInNs3() {
         }
     }
 
-    // Update the position of the vehicles.
+    // Update the position of the vehicles, all of them in one message to the wireless simulator
+    vector<NodePositionUpdate> updates;
     for (NodeMap::iterator nodeIt = m_iTetrisNodeMap->begin(); nodeIt != m_iTetrisNodeMap->end(); ++nodeIt) {
         // Discard the node that are not mobile
         if (nodeIt->second->m_type == staType_CAR) {
             VehicleNode* vehicle = static_cast<VehicleNode*>(nodeIt->second);
             if (vehicle->m_moved) {
-                if (m_wirelessComSimCommunicator->CommandUpdateNodePosition2(vehicle->m_nsId, vehicle->GetPositionX(),
-                        vehicle->GetPositionY(), vehicle->GetSpeed(), vehicle->GetHeading(), vehicle->GetLane()) == EXIT_FAILURE) {
-                    return EXIT_FAILURE;
-                }
+                NodePositionUpdate update;
+                update.nodeId = vehicle->m_nsId;
+                update.x = vehicle->GetPositionX();
+                update.y = vehicle->GetPositionY();
+                update.speed = vehicle->GetSpeed();
+                update.heading = vehicle->GetHeading();
+                update.laneId = vehicle->GetLane();
+                updates.push_back(update);
                 // Reset the moved info value
                 vehicle->m_moved = false;
             }
         }
     }
+    if (updates.size() > 0) {
+        if (m_wirelessComSimCommunicator->CommandUpdateNodePositions2(updates) == EXIT_FAILURE) {
+            return EXIT_FAILURE;
+        }
+    }
 
     return EXIT_SUCCESS;
 
@@ -1001,6 +1107,11 @@ ITetrisNode* SyncManager::GetNodeByNs3Id(int nodeId) {
 
 }
 
+bool SyncManager::IsNs3IdReassigned(int nodeId, icstime_t timeStep) const {
+    NS3IdAssignmentStepMap::const_iterator it = m_NS3IdAssignmentStep.find(nodeId);
+    return it != m_NS3IdAssignmentStep.end() && timeStep < it->second;
+}
+
 ITetrisNode* SyncManager::GetNodeBySumoId(const std::string& nodeId) {
     SumoIdToIcsIdMap::iterator node = m_SumoIdToIcsIdMap->find(nodeId);
     if (node != m_SumoIdToIcsIdMap->end()) {
@@ -1181,9 +1292,51 @@ int SyncManager::NewSubscriptions(ITetrisNode* node) {
         return EXIT_SUCCESS;
     }
 
+    LinkNewSubscriptions(node, *newSubs);
+
+    delete newSubs;
+
+    return EXIT_SUCCESS;
+}
+
+int SyncManager::NewSubscriptions(const vector<ITetrisNode*>& nodes) {
+    vector<vector<Subscription*> > newSubs(nodes.size());
+
+    // Ask every application for the subscriptions of all the nodes it is installed in at once
+    for (vector<ApplicationHandler*>::iterator appsIt = m_applicationHandlerCollection->begin();
+            appsIt != m_applicationHandlerCollection->end(); ++appsIt) {
+        ApplicationHandler* appHandler = (*appsIt);
+        vector<int> nodeIds;
+        vector<vector<Subscription*>*> subscriptions;
+        for (unsigned int i = 0; i < nodes.size(); ++i) {
+            vector<ApplicationHandler*>* apps = nodes[i]->m_applicationHandlerInstalled;
+            if (find(apps->begin(), apps->end(), appHandler) != apps->end()) {
+                nodeIds.push_back(nodes[i]->m_icsId);
+                subscriptions.push_back(&newSubs[i]);
+            }
+        }
+        if (nodeIds.empty()) {
+            continue;
+        }
+        if (!appHandler->AskForNewSubscriptions(nodeIds, subscriptions)) {
+            cerr << "iCS --> Error occurred when asking for new subscriptions (application " << appHandler->m_name << ")" << endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    for (unsigned int i = 0; i < nodes.size(); ++i) {
+        if (!newSubs[i].empty()) {
+            LinkNewSubscriptions(nodes[i], newSubs[i]);
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
+
+void SyncManager::LinkNewSubscriptions(ITetrisNode* node, vector<Subscription*>& newSubs) {
     // Loop the new subscription, linked them and process if needed (for example, creating CAM areas)
     bool controlTraci = false;
-    for (vector<Subscription*>::iterator subIt = newSubs->begin(); subIt < newSubs->end(); subIt++) {
+    for (vector<Subscription*>::iterator subIt = newSubs.begin(); subIt < newSubs.end(); subIt++) {
 
         Subscription* subscription = *subIt;
         node->m_subscriptionCollection->push_back(subscription);
@@ -1244,10 +1397,6 @@ int SyncManager::NewSubscriptions(ITetrisNode* node) {
             //subAppControlTraci->printGetSpeedMessage();
         }
     }
-
-    delete newSubs;
-
-    return EXIT_SUCCESS;
 }
 
 int SyncManager::DropSubscriptions(ITetrisNode* node) {
@@ -1280,6 +1429,33 @@ int SyncManager::DropSubscriptions(ITetrisNode* node) {
     return EXIT_SUCCESS;
 }
 
+int SyncManager::DropSubscriptions(const vector<ITetrisNode*>& nodes) {
+    // Ask every application for the unsubscriptions of all the nodes it is installed in at once
+    for (vector<ApplicationHandler*>::iterator appsIt = m_applicationHandlerCollection->begin();
+            appsIt != m_applicationHandlerCollection->end(); ++appsIt) {
+        ApplicationHandler* appHandler = *appsIt;
+        vector<int> nodeIds;
+        vector<vector<Subscription*>*> subscriptions;
+        for (vector<ITetrisNode*>::const_iterator nodeIt = nodes.begin(); nodeIt != nodes.end(); ++nodeIt) {
+            vector<ApplicationHandler*>* apps = (*nodeIt)->m_applicationHandlerInstalled;
+            if ((*nodeIt)->m_subscriptionCollection->size() != 0
+                    && find(apps->begin(), apps->end(), appHandler) != apps->end()) {
+                nodeIds.push_back((*nodeIt)->m_icsId);
+                subscriptions.push_back((*nodeIt)->m_subscriptionCollection);
+            }
+        }
+        if (nodeIds.empty()) {
+            continue;
+        }
+        if (!appHandler->AskForUnsubscriptions(nodeIds, subscriptions)) {
+            cout << "iCS --> Error occurred when asking to drop subscriptions (application " << appHandler->m_name << ")" << endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
+
 int SyncManager::ExecuteApplicationMainFunction(ITetrisNode* node) {
     if (node == NULL) {
         return EXIT_FAILURE;
@@ -1314,6 +1490,39 @@ int SyncManager::ExecuteApplicationMainFunction(ITetrisNode* node) {
     return EXIT_SUCCESS;
 }
 
+int SyncManager::ExecuteApplicationMainFunction(const vector<ITetrisNode*>& nodes) {
+    // Ask every application to execute in all the nodes it is installed in at once
+    for (vector<ApplicationHandler*>::iterator appsIt = m_applicationHandlerCollection->begin();
+            appsIt != m_applicationHandlerCollection->end(); ++appsIt) {
+        ApplicationHandler* appHandler = *appsIt;
+        vector<int> nodeIds;
+        vector<ResultContainer*> resultContainers;
+        for (vector<ITetrisNode*>::const_iterator nodeIt = nodes.begin(); nodeIt != nodes.end(); ++nodeIt) {
+            ITetrisNode* node = *nodeIt;
+            vector<ApplicationHandler*>* apps = node->m_applicationHandlerInstalled;
+            if (find(apps->begin(), apps->end(), appHandler) == apps->end()) {
+                continue;
+            }
+            // Look for the appropriated result container of the application
+            for (vector<ResultContainer*>::iterator resultIt = node->m_resultContainerCollection->begin();
+                    resultIt < node->m_resultContainerCollection->end(); resultIt++) {
+                if (appHandler->m_id == (*resultIt)->m_applicationHandlerId) {
+                    nodeIds.push_back(node->m_icsId);
+                    resultContainers.push_back(*resultIt);
+                }
+            }
+        }
+        if (nodeIds.empty()) {
+            continue;
+        }
+        if (!appHandler->ExecuteApplication(nodeIds, resultContainers)) {
+            cout << "iCS --> Error occurred when asking to execute application " << appHandler->m_name << endl;
+            return EXIT_FAILURE;
+        }
+    }
+    return EXIT_SUCCESS;
+}
+
 int SyncManager::DeliverMessageStatus(ITetrisNode* node) {
     // Loop applications installed in the node
     for (vector<ApplicationHandler*>::iterator appsIt = node->m_applicationHandlerInstalled->begin();
@@ -1440,6 +1649,7 @@ int SyncManager::GetDataFromNs3() {
     // STEP 1 GET RECEIVED MESSAGES FROM NS-3
 
     bool camMessageReceived = false; // Flag to know if any of the received messages is CAM
+    vector<CamMessageKey> receivedCamKeys; // Scheduled CAM messages received in this step
     std::map<int, std::vector<Message> >* nodeMessages = new std::map<int, std::vector<Message> >();
     if (!m_wirelessComSimCommunicator->CommandGetAllReceivedMessages(nodeMessages, m_timeResolution)) {
 #ifdef LOG_ON
@@ -1482,6 +1692,11 @@ int SyncManager::GetDataFromNs3() {
         for (vector<Message>::iterator receivedIterator = receivedMessages->begin();
                 receivedIterator != receivedMessages->end(); ++receivedIterator) {
             Message receivedMessage = *receivedIterator;
+            if (IsNs3IdReassigned(messageIt->first, receivedMessage.timeStep)) {
+                // Sent before the ns-3 node was recycled for this station, it was addressed to the previous one
+                delete receivedMessage.packetTagContainer;
+                continue;
+            }
             receivedMessage.receiverIcsId = node->m_icsId;
             // Check received message type
             switch (receivedMessage.messageType) {
@@ -1499,20 +1714,25 @@ int SyncManager::GetDataFromNs3() {
                     rcvMessage.sequenceNumber = receivedMessage.sequenceNumber;
                     rcvMessage.received = true;
 
-                    if (ScheduledCamMessageTable.size() > 0) {
-                        // Loop the scheduled message table to get the action ID associated
-                        for (vector<ScheduledCamMessageData>::iterator messageIterator = ScheduledCamMessageTable.begin();
-                                messageIterator != ScheduledCamMessageTable.end(); messageIterator++) {
-                            if (m_v2xMessageTracker->CompareCamRows(rcvMessage, (*messageIterator))) {
-                                rcvMessage.actionID = (*messageIterator).actionID;
-
-                                // Groups the receivers that received the same message
-                                // Facilities function needs all the receivers associated with the same Action ID
-                                m_v2xMessageTracker->UpdateIdentifiersTable(IdentifiersStorageTable, messageIterator->actionID,
-                                        messageIterator->senderIcsID, node->m_icsId);
-
-                                // Change the status of the message (marks as received but more nodes could receive it)
-                                messageIterator->received = true;
+                    if (ScheduledCamMessageTable.messages.size() > 0) {
+                        // Look up the scheduled message to get the action ID associated
+                        ScheduledCamMessageData* scheduledMessage = m_v2xMessageTracker->FindCamRow(ScheduledCamMessageTable, rcvMessage);
+                        if (scheduledMessage != NULL) {
+                            rcvMessage.actionID = scheduledMessage->actionID;
+
+                            // Groups the receivers that received the same message
+                            // Facilities function needs all the receivers associated with the same Action ID
+                            m_v2xMessageTracker->UpdateIdentifiersTable(IdentifiersStorageTable, scheduledMessage->actionID,
+                                    scheduledMessage->senderIcsID, node->m_icsId);
+
+                            // Change the status of the message (marks as received but more nodes could receive it)
+                            if (!scheduledMessage->received) {
+                                scheduledMessage->received = true;
+                                CamMessageKey key;
+                                key.senderNs3ID = scheduledMessage->senderNs3ID;
+                                key.timeStep = scheduledMessage->timeStep;
+                                key.sequenceNumber = scheduledMessage->sequenceNumber;
+                                receivedCamKeys.push_back(key);
                             }
                         }
                     } else {
@@ -1546,14 +1766,15 @@ int SyncManager::GetDataFromNs3() {
                     receivedMessage.received = true;
 
                     ITetrisNode* sender = GetNodeByNs3Id(receivedMessage.senderNs3Id);
-                    if (sender == NULL) {
+                    if (sender == NULL || IsNs3IdReassigned(receivedMessage.senderNs3Id, receivedMessage.timeStep)) {
 #ifdef LOG_ON
                         stringstream log;
                         log << "iCS --> ProcessGeoBroadcastMessages() The sender is NULL. It has probably left the simulation."
                             << toString(receivedMessage.messageType);
                         IcsLog::LogLevel((log.str()).c_str(), kLogLevelWarning);
-                        continue;
 #endif
+                        delete receivedMessage.packetTagContainer;
+                        continue;
                     }
                     receivedMessage.senderIcsId = sender->m_icsId;
 #ifdef LOG_ON
@@ -1605,24 +1826,14 @@ int SyncManager::GetDataFromNs3() {
     // If at least one message is CAM trigger the CAM message process
     if (camMessageReceived) {
         // Loop received Action IDs to get
-        if (IdentifiersStorageTable.size() > 0) {
-            vector<IdentifiersStorageStruct>::iterator idIterator = IdentifiersStorageTable.begin();
-            while (idIterator != IdentifiersStorageTable.end()) {
-                if ((*idIterator).stored) {
-                    idIterator = IdentifiersStorageTable.erase(idIterator);
-                } else {
-                    vector<stationID_t> vReceivers;
-                    vReceivers = m_v2xMessageTracker->GroupReceivers(IdentifiersStorageTable, (*idIterator).actionID,
-                                 (*idIterator).senderID);
-
-                    if (vReceivers.size() != 0) {
-                        m_facilitiesManager->storeMessage((*idIterator).actionID, vReceivers);
-                    } else {
-                        cout << "[GetDataFromNs3] ERROR: There isn't any receiver for this message" << endl;
-                        return EXIT_FAILURE;
-                    }
-                    ++idIterator; // Go to next identifier
-                }
+        for (IdentifiersStorageMap::iterator idIterator = IdentifiersStorageTable.begin();
+                idIterator != IdentifiersStorageTable.end(); ++idIterator) {
+            const vector<stationID_t>& vReceivers = idIterator->second.receiverIDs;
+            if (vReceivers.size() != 0) {
+                m_facilitiesManager->storeMessage(idIterator->first, vReceivers);
+            } else {
+                cout << "[GetDataFromNs3] ERROR: There isn't any receiver for this message" << endl;
+                return EXIT_FAILURE;
             }
         }
 
@@ -1632,22 +1843,18 @@ int SyncManager::GetDataFromNs3() {
         }
 
         // Erase from the CAM scheduling table in case there is no more receivers (received)
-        if (ScheduledCamMessageTable.size() > 0) {
-            vector<ScheduledCamMessageData>::iterator mIterator = ScheduledCamMessageTable.begin();
-            while (mIterator != ScheduledCamMessageTable.end()) {
-                if ((*mIterator).received) {
+        if (ScheduledCamMessageTable.messages.size() > 0) {
+            for (vector<CamMessageKey>::iterator keyIterator = receivedCamKeys.begin();
+                    keyIterator != receivedCamKeys.end(); ++keyIterator) {
 #ifdef LOG_ON
-                    stringstream log;
-                    log
-                            << "GetDataFromNs3() A received message has been erased from Scheduled CAM Message Table [senderID|time|seqN]: "
-                            << "[" << (*mIterator).senderNs3ID << "|" << (*mIterator).timeStep << "|" << (*mIterator).sequenceNumber
-                            << "]";
-                    IcsLog::LogLevel((log.str()).c_str(), kLogLevelInfo);
+                stringstream log;
+                log
+                        << "GetDataFromNs3() A received message has been erased from Scheduled CAM Message Table [senderID|time|seqN]: "
+                        << "[" << keyIterator->senderNs3ID << "|" << keyIterator->timeStep << "|" << keyIterator->sequenceNumber
+                        << "]";
+                IcsLog::LogLevel((log.str()).c_str(), kLogLevelInfo);
 #endif
-                    mIterator = ScheduledCamMessageTable.erase(mIterator);
-                } else {
-                    ++mIterator; // Go to the next schedule message
-                }
+                m_v2xMessageTracker->EraseCamRow(ScheduledCamMessageTable, *keyIterator);
             }
         } else {
 #ifdef LOG_ON
@@ -2467,15 +2674,10 @@ int SyncManager::ScheduleV2xGeobroadcastMessages(ics_types::stationID_t sender,
 }
 
 int SyncManager::RefreshScheduledCamMessageTable() {
-    if (ScheduledCamMessageTable.size() > 0) {
-        vector<ScheduledCamMessageData>::iterator messageIterator = ScheduledCamMessageTable.begin();
-        while (messageIterator != ScheduledCamMessageTable.end()) {
-            if (m_simStep >= ((*messageIterator).timeStep + ITetrisSimulationConfig::m_scheduleMessageCleanUp)) {
-                messageIterator = ScheduledCamMessageTable.erase(messageIterator);
-            } else {
-                ++messageIterator;
-            }
-        }
+    if (ScheduledCamMessageTable.messages.size() > 0) {
+        // The messages are bucketed by timestep, only the expired buckets are visited
+        m_v2xMessageTracker->RefreshCamRows(ScheduledCamMessageTable,
+                                            m_simStep - ITetrisSimulationConfig::m_scheduleMessageCleanUp);
     } else {
 //#ifdef LOG_ON
 //		stringstream log;
@@ -2654,7 +2856,7 @@ bool SyncManager::AddNode(ITetrisNode* node, bool assingToOtherTables) {
             return false;
         } else {
             m_SumoIdToIcsIdMap->operator[](node->m_tsId) = node->m_icsId;
-            m_NS3IdToIcsIdMap->operator[](node->m_nsId) = node->m_icsId;
+            AssignNs3Id(node);
         }
     }
 #ifdef LOG_ON
@@ -2666,9 +2868,27 @@ bool SyncManager::AddNode(ITetrisNode* node, bool assingToOtherTables) {
     return true;
 }
 
+void SyncManager::AssignNs3Id(ITetrisNode* node) {
+    NS3IdToIcsIdMap::iterator it = m_NS3IdToIcsIdMap->find(node->m_nsId);
+    if (it != m_NS3IdToIcsIdMap->end() && it->second != node->m_icsId) {
+#ifdef LOG_ON
+        stringstream log;
+        log << "AssignNs3Id() ns3Id=" << node->m_nsId << " is still assigned to node " << it->second
+            << ". Reassigning it to node " << node->m_icsId;
+        IcsLog::LogLevel((log.str()).c_str(), kLogLevelWarning);
+#endif
+    }
+    m_NS3IdToIcsIdMap->operator[](node->m_nsId) = node->m_icsId;
+    m_NS3IdAssignmentStep[node->m_nsId] = m_simStep;
+}
+
 void SyncManager::DeleteNode(ITetrisNode* node) {
     m_iTetrisNodeMap->erase(node->m_icsId);
-    m_NS3IdToIcsIdMap->erase(node->m_nsId);
+    // The ns-3 ID may already belong to another node if ns-3 recycled it
+    NS3IdToIcsIdMap::iterator it = m_NS3IdToIcsIdMap->find(node->m_nsId);
+    if (it != m_NS3IdToIcsIdMap->end() && it->second == node->m_icsId) {
+        m_NS3IdToIcsIdMap->erase(it);
+    }
     m_SumoIdToIcsIdMap->erase(node->m_tsId);
     delete node;
 }
@@ -2699,7 +2919,7 @@ void SyncManager::UpdateNodeId(ITetrisNode* node, bool addNs3, bool addSumo) {
     log << "UpdateNodeId() Update node " << node->m_icsId;
 #endif
     if (addNs3) {
-        m_NS3IdToIcsIdMap->operator[](node->m_nsId) = node->m_icsId;
+        AssignNs3Id(node);
 #ifdef LOG_ON
         log << ". Added ns3Id=" << node->m_nsId;
 #endif
@@ -87,6 +87,8 @@ class FacilitiesManager;
 typedef std::map<int, ITetrisNode*> NodeMap;
 //			Associates a ns3id to a icsid. To speedup the node lockup
 typedef std::map<int, int> NS3IdToIcsIdMap;
+//			Associates a ns3id to the time step it was last assigned to a node. ns-3 may recycle the nodes of departed vehicles
+typedef std::map<int, ics_types::icstime_t> NS3IdAssignmentStepMap;
 //			Associates a sumoid to a icsid. To speedup the node lockup
 typedef std::map<std::string, int> SumoIdToIcsIdMap;
 //			Map of in flight messages
@@ -106,11 +108,13 @@ public:
 //			Properties
     NodeMap* m_iTetrisNodeMap;
     NS3IdToIcsIdMap* m_NS3IdToIcsIdMap;
+    NS3IdAssignmentStepMap m_NS3IdAssignmentStep;
     SumoIdToIcsIdMap* m_SumoIdToIcsIdMap;
     MessageMap m_messageMap;
 
     bool AddNode(ITetrisNode* node, bool assingToOtherTables = true);
     void UpdateNodeId(ITetrisNode* node, bool addNs3, bool addSumo);
+    void AssignNs3Id(ITetrisNode* node);
     void DeleteNode(ITetrisNode*);
     void RefreshScheduledMessageMap();
 
@@ -166,7 +170,7 @@ public:
     static int m_timeResolution;
 
     /// @brief Table that stores the information related to the CAM scheduled messages.
-    std::vector<ScheduledCamMessageData> ScheduledCamMessageTable;
+    ScheduledCamMessageIndex ScheduledCamMessageTable;
 
 //          TODO (JHNOTE: 20/03/2018) either reactivate or remove
 //			/// @brief Table that stores the information related to the UNICAST scheduled messages.
@@ -179,7 +183,7 @@ public:
 //			std::vector<ScheduledTopobroadcastMessageData> ScheduledTopobroadcastMessageTable;
 
     /// @brief Table that stores the identifiers related to the received CAM messages.
-    std::vector<IdentifiersStorageStruct> IdentifiersStorageTable;
+    IdentifiersStorageMap IdentifiersStorageTable;
 
     /**
      * @brief Member function launching the run-time phase.
@@ -290,6 +294,14 @@ public:
      */
     int RunApplicationLogic();
 
+    /**
+     * @brief Executes the applications phase by phase for all the nodes, so that every phase is exchanged with each
+     * application in as few messages as possible. Used when all the applications support the batched protocol mode.
+     * @return 0: If the execution finishes successfully
+     * @return 1: If an error occurs
+     */
+    int RunApplicationLogicBatched();
+
     /**
      * @brief Looks for a node using its SUMO identifier
      * @param[in,out] &nodeId SUMO node identifier
@@ -558,6 +570,26 @@ private:
      */
     int NewSubscriptions(ITetrisNode* node);
 
+    /**
+     * @brief Questions the applications of several nodes if they would like to subscribe to data.
+     * @param[in] nodes The nodes the subscriptions belong to.
+     * @return EXIT_SUCCESS if the subscription were created correctly, EXIT_FAILURE otherwise.
+     */
+    int NewSubscriptions(const std::vector<ITetrisNode*>& nodes);
+
+    /**
+     * @brief Links the new subscriptions to the node and processes them if needed (for example, creating CAM areas).
+     * @param[in] node The node the subscriptions belong to.
+     * @param[in] newSubs The subscriptions the applications of the node requested.
+     */
+    void LinkNewSubscriptions(ITetrisNode* node, std::vector<Subscription*>& newSubs);
+
+    /**
+     * @brief Corrects the position of a node that moved out of the zone with the one stored in the mobility history.
+     * @param[in] node The node to check.
+     */
+    void UpdatePositionFromMobilityHistory(ITetrisNode* node);
+
     /**
      * @brief Informs the applications of the creation of a new node.
      * @param[in] node The node created.
@@ -572,6 +604,13 @@ private:
      */
     int DropSubscriptions(ITetrisNode* node);
 
+    /**
+     * @brief Asks the applications of several nodes if they would like to unsubscribe.
+     * @param[in] nodes The nodes related with the subscriptions to drop.
+     * @return EXIT_SUCCESS if the subscription were removed correctly, EXIT_FAILURE otherwise.
+     */
+    int DropSubscriptions(const std::vector<ITetrisNode*>& nodes);
+
     /**
      * @brief Sends to the Application the IDs and receiver stations IDs of the
      * correctly communicated messages.
@@ -587,6 +626,13 @@ private:
      */
     int ExecuteApplicationMainFunction(ITetrisNode* node);
 
+    /**
+     * @brief Tells the applications of several nodes they can execute their main algorithm.
+     * @param[in] nodes The nodes storing the results of the applications.
+     * @return EXIT_SUCCESS if the applications executed correctly, EXIT_FAILURE otherwise.
+     */
+    int ExecuteApplicationMainFunction(const std::vector<ITetrisNode*>& nodes);
+
     /**
      * @brief Returns the node corresponding to the ns-3 ID
      * @param[in] nodeID The ID of the node in ns-3 simulator
@@ -594,6 +640,14 @@ private:
      */
     ITetrisNode* GetNodeByNs3Id(int nodeId);
 
+    /**
+     * @brief Checks if a ns-3 ID has been assigned to its current node after a given time step
+     * @param[in] nodeId The ID of the node in ns-3 simulator
+     * @param[in] timeStep The time step of a message sent or received by the ns-3 node
+     * @return true if the message belongs to a previous holder of the recycled ns-3 node
+     */
+    bool IsNs3IdReassigned(int nodeId, ics_types::icstime_t timeStep) const;
+
     /// @brief Collection of all current subscriptions.
     std::vector<Subscription*>* m_subscriptionCollectionManager;
 
@@ -104,38 +104,10 @@ bool TraCIClient::Connect() {
             m_socket->connect();
             storeStartTime();
             // subscribe departures and arrivals
-std:
-            string objID;
-            int noSubscribedVars = 2;
-            tcpip::Storage outMsg, inMsg, tmp;
-            outMsg.writeUnsignedByte(0);
-            outMsg.writeInt(/*1 + 4 +*/5 + 1 + 4 + 8 + 8 + (int) objID.length() + 1 + noSubscribedVars);
-            outMsg.writeUnsignedByte(CMD_SUBSCRIBE_SIM_VARIABLE); // command id
-            outMsg.writeDouble(0.0); // begin time
-            outMsg.writeDouble(86400.0); // end time
-            outMsg.writeString(objID); // object id
-            outMsg.writeUnsignedByte(noSubscribedVars); // variable number
-            outMsg.writeUnsignedByte(VAR_DEPARTED_VEHICLES_IDS);
-            outMsg.writeUnsignedByte(VAR_ARRIVED_VEHICLES_IDS);
-            // send request message
-            try {
-                m_socket->sendExact(outMsg);
-            } catch (SocketException& e) {
-                cout << "Error while sending command: " << e.what();
-                return false;
-            }
-            try {
-                m_socket->receiveExact(inMsg);
-                if (!ReportResultState(inMsg, CMD_SUBSCRIBE_SIM_VARIABLE)) {
-                    return false;
-                }
-                vector<std::string> departed, arrived;
-                processSubscriptions(inMsg, departed, arrived);
-                return true;
-            } catch (SocketException& e) {
-                cout << "Error while receiving command: " << e.what();
-                return false;
-            }
+            std::vector<int> variables;
+            variables.push_back(VAR_DEPARTED_VEHICLES_IDS);
+            variables.push_back(VAR_ARRIVED_VEHICLES_IDS);
+            return subscribe(CMD_SUBSCRIBE_SIM_VARIABLE, "", variables);
         } catch (SocketException& e) {
             cout << "iCS --> No connection to SUMO; waiting..." << e.what() << endl;
             Sleep(3000);
@@ -192,6 +164,43 @@ int TraCIClient::CommandSimulationStep(int time, std::vector<std::string>& depar
     return EXIT_SUCCESS;
 }
 
+bool TraCIClient::subscribe(int commandID, const std::string& objID, const std::vector<int>& variables) {
+    if (m_socket == 0) {
+        cout << "iCS --> #Error while sending command: no connection to server SUMO" << endl;
+        return false;
+    }
+
+    tcpip::Storage outMsg, inMsg;
+    outMsg.writeUnsignedByte(0);
+    outMsg.writeInt(/*1 + 4 +*/5 + 1 + 4 + 8 + 8 + (int) objID.length() + 1 + (int) variables.size());
+    outMsg.writeUnsignedByte(commandID); // command id
+    outMsg.writeDouble(0.0); // begin time
+    outMsg.writeDouble(86400.0); // end time
+    outMsg.writeString(objID); // object id
+    outMsg.writeUnsignedByte((int) variables.size()); // variable number
+    for (std::vector<int>::const_iterator i = variables.begin(); i != variables.end(); ++i) {
+        outMsg.writeUnsignedByte(*i);
+    }
+    // send request message
+    try {
+        m_socket->sendExact(outMsg);
+    } catch (SocketException& e) {
+        cout << "Error while sending command: " << e.what();
+        return false;
+    }
+    try {
+        m_socket->receiveExact(inMsg);
+        if (!ReportResultState(inMsg, commandID)) {
+            return false;
+        }
+        vector<std::string> departed, arrived;
+        return processSubscriptions(inMsg, departed, arrived);
+    } catch (SocketException& e) {
+        cout << "Error while receiving command: " << e.what();
+        return false;
+    }
+}
+
 bool TraCIClient::processSubscriptions(tcpip::Storage& inMsg, std::vector<std::string>& departed,
                                        std::vector<std::string>& arrived) {
     try {
@@ -208,6 +217,26 @@ bool TraCIClient::processSubscriptions(tcpip::Storage& inMsg, std::vector<std::s
             }
             std::string objID = inMsg.readString();
             unsigned int varNo = inMsg.readUnsignedByte();
+            if (cmdId == RESPONSE_SUBSCRIBE_VEHICLE_VARIABLE) {
+                TSubscribedVehicleState& state = m_vehicleStates[objID];
+                bool valid = true;
+                for (unsigned int i = 0; i < varNo; ++i) {
+                    int varID = inMsg.readUnsignedByte();
+                    bool ok = inMsg.readUnsignedByte() == RTYPE_OK;
+                    inMsg.readUnsignedByte(); // value type
+                    if (!ok) {
+                        inMsg.readString(); // error description
+                        valid = false;
+                        continue;
+                    }
+                    readVehicleVariable(varID, inMsg, state);
+                }
+                if (!valid) {
+                    // fall back to single value retrieval for this vehicle
+                    m_vehicleStates.erase(objID);
+                }
+                continue;
+            }
             for (unsigned int i = 0; i < varNo; ++i) {
                 int varID = inMsg.readUnsignedByte();
                 bool ok = inMsg.readUnsignedByte() == RTYPE_OK;
@@ -226,9 +255,62 @@ bool TraCIClient::processSubscriptions(tcpip::Storage& inMsg, std::vector<std::s
         cout << "#Error while reading message:" << e.what() << std::endl;
         return false;
     }
+    // SUMO drops the subscriptions of vehicles that left the simulation
+    for (std::vector<std::string>::const_iterator i = arrived.begin(); i != arrived.end(); ++i) {
+        m_vehicleStates.erase(*i);
+    }
     return true;
 }
 
+void TraCIClient::readVehicleVariable(int varID, tcpip::Storage& inMsg, TSubscribedVehicleState& state) {
+    switch (varID) {
+        case VAR_POSITION:
+            state.positionX = (float) inMsg.readDouble();
+            state.positionY = (float) inMsg.readDouble();
+            break;
+        case VAR_SPEED:
+            state.speed = (float) inMsg.readDouble();
+            break;
+        case VAR_ANGLE:
+            state.direction = (float) inMsg.readDouble();
+            break;
+        case VAR_LENGTH:
+            state.length = (float) inMsg.readDouble();
+            break;
+        case VAR_WIDTH:
+            state.width = (float) inMsg.readDouble();
+            break;
+        case VAR_LANE_ID:
+            state.lane = inMsg.readString();
+            break;
+        case VAR_TYPE:
+            state.type = inMsg.readString();
+            break;
+        default:
+            throw invalid_argument("unexpected vehicle variable in subscription response: " + toString(varID));
+    }
+}
+
+bool TraCIClient::SubscribeVehicleVariables(const ITetrisNode& node) {
+    std::vector<int> variables;
+    variables.push_back(VAR_POSITION);
+    variables.push_back(VAR_SPEED);
+    variables.push_back(VAR_ANGLE);
+    variables.push_back(VAR_LENGTH);
+    variables.push_back(VAR_WIDTH);
+    variables.push_back(VAR_LANE_ID);
+    variables.push_back(VAR_TYPE);
+    return subscribe(CMD_SUBSCRIBE_VEHICLE_VARIABLE, node.m_tsId, variables);
+}
+
+const TSubscribedVehicleState* TraCIClient::GetSubscribedVehicleState(const ITetrisNode& node) const {
+    SubscribedVehicleStateMap::const_iterator it = m_vehicleStates.find(node.m_tsId);
+    if (it == m_vehicleStates.end()) {
+        return 0;
+    }
+    return &it->second;
+}
+
 bool TraCIClient::ReportResultState(tcpip::Storage& inMsg, int command) {
     int cmdLength;
     int cmdId;
@@ -386,12 +468,20 @@ int TraCIClient::CommandSetMaximumSpeed(const ITetrisNode& node, float maxSpeed)
 }
 
 float TraCIClient::GetSpeed(const ITetrisNode& node) {
+    const TSubscribedVehicleState* state = GetSubscribedVehicleState(node);
+    if (state != 0) {
+        return state->speed;
+    }
     tcpip::Storage inMsg;
     beginValueRetrieval(node.m_tsId, VAR_SPEED, inMsg);
     return (float) inMsg.readDouble();
 }
 
 float TraCIClient::GetDirection(const ITetrisNode& node) {
+    const TSubscribedVehicleState* state = GetSubscribedVehicleState(node);
+    if (state != 0) {
+        return state->direction;
+    }
     tcpip::Storage inMsg;
     beginValueRetrieval(node.m_tsId, VAR_ANGLE, inMsg);
     return (float) inMsg.readDouble();
@@ -403,6 +493,10 @@ float TraCIClient::GetVehicleLength(const ITetrisNode& node) {
 //  tcpip::Storage inMsg;
 //  beginValueRetrieval(type, VAR_LENGTH, inMsg, CMD_GET_VEHICLETYPE_VARIABLE);
 //  return (float) inMsg.readDouble();
+    const TSubscribedVehicleState* state = GetSubscribedVehicleState(node);
+    if (state != 0) {
+        return state->length;
+    }
     tcpip::Storage inMsg;
     beginValueRetrieval(node.m_tsId, VAR_LENGTH, inMsg);
     return (float) inMsg.readDouble();
@@ -414,12 +508,20 @@ float TraCIClient::GetVehicleWidth(const ITetrisNode& node) {
 //  tcpip::Storage inMsg;
 //  beginValueRetrieval(type, VAR_WIDTH, inMsg, CMD_GET_VEHICLETYPE_VARIABLE);
 //  return (float) inMsg.readDouble();
+    const TSubscribedVehicleState* state = GetSubscribedVehicleState(node);
+    if (state != 0) {
+        return state->width;
+    }
     tcpip::Storage inMsg;
     beginValueRetrieval(node.m_tsId, VAR_WIDTH, inMsg);
     return (float) inMsg.readDouble();
 }
 
 std::pair<float, float> TraCIClient::GetPosition(const ITetrisNode& node) {
+    const TSubscribedVehicleState* state = GetSubscribedVehicleState(node);
+    if (state != 0) {
+        return make_pair(state->positionX, state->positionY);
+    }
     tcpip::Storage inMsg;
     beginValueRetrieval(node.m_tsId, VAR_POSITION, inMsg);
     double x_double = inMsg.readDouble();
@@ -434,12 +536,20 @@ bool TraCIClient::GetExteriorLights(const ITetrisNode& node) {
 }
 
 string TraCIClient::GetLane(const ITetrisNode& node) {
+    const TSubscribedVehicleState* state = GetSubscribedVehicleState(node);
+    if (state != 0) {
+        return state->lane;
+    }
     tcpip::Storage inMsg;
     beginValueRetrieval(node.m_tsId, VAR_LANE_ID, inMsg);
     return inMsg.readString();
 }
 
 std::string TraCIClient::GetVehicleType(const ITetrisNode& node) {
+    const TSubscribedVehicleState* state = GetSubscribedVehicleState(node);
+    if (state != 0) {
+        return state->type;
+    }
     tcpip::Storage inMsg;
     beginValueRetrieval(node.m_tsId, VAR_TYPE, inMsg);
     return inMsg.readString();
@@ -207,6 +207,28 @@ public:
      */
     std::string GetVehicleType(const ITetrisNode& node);
 
+    /**
+     * @brief Subscribes position, speed, angle, lane, type, length and width of a vehicle.
+     * @param[in,out] &node The node to subscribe.
+     * @return True if SUMO acknowledged the subscription.
+     */
+    bool SubscribeVehicleVariables(const ITetrisNode& node);
+
+    /**
+     * @brief Gets the subscribed state of a vehicle received with the last simulation step.
+     * @param[in,out] &node The node to get information from.
+     * @return The subscribed state, or NULL if there is none for the node.
+     */
+    const TSubscribedVehicleState* GetSubscribedVehicleState(const ITetrisNode& node) const;
+
+    /**
+     * @brief Gets the subscribed states of all the vehicles received with the last simulation step.
+     * @return The subscribed states indexed by SUMO ID.
+     */
+    const SubscribedVehicleStateMap& GetSubscribedVehicleStates() const {
+        return m_vehicleStates;
+    }
+
     /**
      * @brief S3 Bus Lane Management (DLR)
      * Lets one station run in a lane that is "bus-only"
@@ -312,6 +334,23 @@ private:
     bool processSubscriptions(tcpip::Storage& inMsg, std::vector<std::string>& departed,
                               std::vector<std::string>& arrived);
 
+    /**
+     * @brief Sends a variable subscription and processes the immediate response
+     * @param[in] commandID The subscription command (CMD_SUBSCRIBE_*_VARIABLE)
+     * @param[in] objID The object the subscription refers to
+     * @param[in] variables The variables to subscribe
+     * @return True if SUMO acknowledged the subscription
+     */
+    bool subscribe(int commandID, const std::string& objID, const std::vector<int>& variables);
+
+    /**
+     * @brief Reads the value of a subscribed vehicle variable into the corresponding state field
+     * @param[in] varID The variable identifier
+     * @param[in,out] &inMsg Message positioned at the value
+     * @param[in,out] &state The state to fill in
+     */
+    void readVehicleVariable(int varID, tcpip::Storage& inMsg, TSubscribedVehicleState& state);
+
     /**
      * @brief
      * @param[in,out] &objID
@@ -346,6 +385,9 @@ private:
     std::vector<ics_types::trafficLightID_t> m_tlsIDs;
 
     double m_startTime;
+
+    /// @brief Vehicle variables received through the vehicle subscriptions.
+    SubscribedVehicleStateMap m_vehicleStates;
 };
 
 }
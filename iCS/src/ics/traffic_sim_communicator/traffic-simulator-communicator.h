@@ -44,6 +44,8 @@
 #endif
 
 #include <utility>
+#include <string>
+#include <map>
 
 #include "../../utils/ics/iCStypes.h"
 
@@ -55,6 +57,29 @@ namespace ics {
 class ITetrisNode;
 
 
+// ===========================================================================
+// struct definitions
+// ===========================================================================
+/**
+* @struct SubscribedVehicleState
+* @brief Vehicle variables delivered by SUMO through a vehicle variable subscription.
+* The values correspond to the state at the end of the last traffic simulation step.
+*/
+struct SubscribedVehicleState {
+    float positionX;
+    float positionY;
+    float speed;
+    float direction;
+    float length;
+    float width;
+    std::string lane;
+    std::string type;
+} typedef TSubscribedVehicleState;
+
+/// @brief Subscribed vehicle states indexed by the traffic simulator ID of the vehicle
+typedef std::map<std::string, TSubscribedVehicleState> SubscribedVehicleStateMap;
+
+
 // ===========================================================================
 // class definitions
 // ===========================================================================
@@ -169,6 +194,27 @@ public:
     */
     virtual std::string GetVehicleType(const ITetrisNode& node) = 0;
 
+    /**
+    * @brief Subscribes the dynamic variables of a vehicle (position, speed, angle, lane, type and size).
+    * The values are then delivered with every simulation step response instead of being queried one by one.
+    * @param[in] node The node whose variables are subscribed.
+    * @return True if the subscription was accepted, false otherwise.
+    */
+    virtual bool SubscribeVehicleVariables(const ITetrisNode& node) = 0;
+
+    /**
+    * @brief Gets the subscribed state of a vehicle received with the last simulation step.
+    * @param[in] node The node to get information from.
+    * @return The subscribed state, or NULL if the vehicle has no valid subscription result.
+    */
+    virtual const TSubscribedVehicleState* GetSubscribedVehicleState(const ITetrisNode& node) const = 0;
+
+    /**
+    * @brief Gets the subscribed states of all the vehicles received with the last simulation step.
+    * @return The subscribed states indexed by the traffic simulator ID of the vehicles.
+    */
+    virtual const SubscribedVehicleStateMap& GetSubscribedVehicleStates() const = 0;
+
     /**
     * @brief Bus Lane Management.
     * Lets one station run in a lane that is "bus-only"
@@ -298,6 +298,59 @@ int Ns3Client::CommandUpdateNodePosition2(int nodeId, float x, float y, float sp
     return EXIT_SUCCESS;
 }
 
+int Ns3Client::CommandUpdateNodePositions2(const std::vector<NodePositionUpdate>& updates) {
+    tcpip::Storage outMsg;
+    tcpip::Storage inMsg;
+
+    if (m_socket == NULL) {
+        cout << "iCS --> #Error while sending command: no connection to server";
+        return EXIT_FAILURE;
+    }
+
+    int length = 4 + 1 + 4;
+    for (vector<NodePositionUpdate>::const_iterator it = updates.begin(); it != updates.end(); ++it) {
+        length += 4 + 4 + 4 + 4 + 4 + 4 + it->laneId.length();
+    }
+    // command length
+    outMsg.writeInt(length);
+    // command id
+    outMsg.writeUnsignedByte(CMD_UPDATENODES2);
+    // number of nodes to be updated
+    outMsg.writeInt(updates.size());
+    // write every record: node id, position x, position y, speed, heading, laneId
+    for (vector<NodePositionUpdate>::const_iterator it = updates.begin(); it != updates.end(); ++it) {
+        outMsg.writeInt(it->nodeId);
+        outMsg.writeFloat(it->x);
+        outMsg.writeFloat(it->y);
+        outMsg.writeFloat(it->speed);
+        outMsg.writeFloat(it->heading);
+        outMsg.writeString(it->laneId);
+    }
+
+    // send request message
+    try {
+        m_socket->sendExact(outMsg);
+    } catch (tcpip::SocketException& e) {
+        cout << "iCS --> #Error while sending command: " << e.what();
+        return EXIT_FAILURE;
+    }
+
+    // receive answer message
+    try {
+        m_socket->receiveExact(inMsg);
+    } catch (tcpip::SocketException& e) {
+        cout << "iCS --> #Error while receiving command: " << e.what();
+        return EXIT_FAILURE;
+    }
+
+    // validate result state
+    if (!ReportResultState(inMsg, CMD_UPDATENODES2)) {
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
 int Ns3Client::CommandCreateNode(float x, float y, std::vector<std::string> techList) {
     tcpip::Storage outMsg;
     tcpip::Storage inMsg;
@@ -115,6 +115,13 @@ public:
      */
     int CommandUpdateNodePosition2(int nodeId, float x, float y, float speed, float heading, std::string laneId);
 
+    /**
+     * @brief Sends a single message to ns-3 with the new mobility values of several nodes.
+     * @param[in] updates The ns-3 identifier, position, speed, heading and lane of each node.
+     * @return EXIT_SUCCESS if the nodes were correctly moved to their new position in ns-3, EXIT_FAILURE otherwise.
+     */
+    int CommandUpdateNodePositions2(const std::vector<NodePositionUpdate>& updates);
+
     /**
      * @brief Sends the order to ns-3 to initialize a node.
      * @param[in] x The new x coordinate of the node's position.
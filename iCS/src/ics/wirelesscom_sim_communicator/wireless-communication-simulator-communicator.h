@@ -69,6 +69,19 @@ struct ReceivedMessage {
      ics_types::snr_t snr;*/
 };
 
+/**
+ * @struct NodePositionUpdate
+ * @brief Mobility of one node, several of them are sent to the wireless simulator in a single message
+ */
+struct NodePositionUpdate {
+    int nodeId;
+    float x;
+    float y;
+    float speed;
+    float heading;
+    std::string laneId;
+};
+
 struct Message {
     Message() {
 //			Can delete it even if I've never assigned it
@@ -145,6 +158,13 @@ public:
     virtual int CommandUpdateNodePosition2(int nodeId, float x, float y, float speed, float heading,
                                            std::string laneId) = 0;
 
+    /**
+     * @brief Sends a single message to ns-3 with the new mobility values of several nodes
+     * @param[in] updates The ns-3 identifier, position, speed, heading and lane of each node
+     * @return EXIT_SUCCESS if the nodes were correctly moved to their new position in ns-3, EXIT_FAILURE otherwise
+     */
+    virtual int CommandUpdateNodePositions2(const std::vector<NodePositionUpdate>& updates) = 0;
+
     /**
      * @brief Sends the order to ns-3 to initializa a node.
      * @param[in] x The new x coordinate of the node's position
@@ -100,8 +100,44 @@ V2xMessageManager::CreateV2xGeobroadcastArea(int subscriptionId, float frequency
 }
 
 void
-V2xMessageManager::InsertCamRow(vector<ScheduledCamMessageData>& table, ScheduledCamMessageData data) {
-    table.push_back(data);
+V2xMessageManager::InsertCamRow(ScheduledCamMessageIndex& table, ScheduledCamMessageData data) {
+    CamMessageKey key;
+    key.senderNs3ID = data.senderNs3ID;
+    key.timeStep = data.timeStep;
+    key.sequenceNumber = data.sequenceNumber;
+    if (table.messages.insert(make_pair(key, data)).second) {
+        table.timeBuckets[data.timeStep].push_back(key);
+    }
+}
+
+ScheduledCamMessageData*
+V2xMessageManager::FindCamRow(ScheduledCamMessageIndex& table, const ScheduledCamMessageData& rowReceived) {
+    CamMessageKey key;
+    key.senderNs3ID = rowReceived.senderNs3ID;
+    key.timeStep = rowReceived.timeStep;
+    key.sequenceNumber = rowReceived.sequenceNumber;
+    unordered_map<CamMessageKey, ScheduledCamMessageData, CamMessageKeyHash>::iterator it = table.messages.find(key);
+    if (it == table.messages.end() || !CompareCamRows(rowReceived, it->second)) {
+        return NULL;
+    }
+    return &it->second;
+}
+
+void
+V2xMessageManager::EraseCamRow(ScheduledCamMessageIndex& table, const CamMessageKey& key) {
+    // The key stays in its time bucket, erasing it again when the bucket expires is harmless
+    table.messages.erase(key);
+}
+
+void
+V2xMessageManager::RefreshCamRows(ScheduledCamMessageIndex& table, icstime_t lastTimeStep) {
+    while (!table.timeBuckets.empty() && table.timeBuckets.begin()->first <= lastTimeStep) {
+        vector<CamMessageKey>& keys = table.timeBuckets.begin()->second;
+        for (vector<CamMessageKey>::iterator it = keys.begin(); it != keys.end(); ++it) {
+            table.messages.erase(*it);
+        }
+        table.timeBuckets.erase(table.timeBuckets.begin());
+    }
 }
 
 void
@@ -194,63 +230,30 @@ V2xMessageManager::CompareTopobroadcastRows(ScheduledTopobroadcastMessageData ro
 }
 
 void
-V2xMessageManager::UpdateIdentifiersTable(vector<IdentifiersStorageStruct>& table, actionID_t actionID, stationID_t senderID, stationID_t receiverID) {
-    bool exists = true;
-
-    if (table.size() > 0) {
-        for (vector<IdentifiersStorageStruct>::iterator it = table.begin(); it != table.end(); it++) {
-            if (actionID == (*it).actionID) {
-                if (senderID == (*it).senderID) {
-                    if (receiverID == (*it).receiverID) {
-                        if (!(*it).stored) {
-                            exists = true;
-                            (*it).stored = true;
-                        } else {
-                            exists = true;
-                        }
-
-                    } else {
-                        exists = false;
-                    }
-                } else {
-                    cout << "[UpdateIdentifiersStorageStruct]: Error-> The senderID doesn't correspond to the actionID" << endl;
-                }
-            } else {
-                exists = false;
-            }
-
-        }
-    } else {
-        exists = false;
-    }
-
-
-    if (!exists) {
+V2xMessageManager::UpdateIdentifiersTable(IdentifiersStorageMap& table, actionID_t actionID, stationID_t senderID, stationID_t receiverID) {
+    IdentifiersStorageMap::iterator it = table.find(actionID);
+    if (it == table.end()) {
         IdentifiersStorageStruct identifStruct;
-
-        identifStruct.actionID = actionID;
         identifStruct.senderID = senderID;
-        identifStruct.receiverID = receiverID;
-        identifStruct.stored = false;
-        table.push_back(identifStruct);
+        it = table.insert(make_pair(actionID, identifStruct)).first;
+    } else if (senderID != it->second.senderID) {
+        cout << "[UpdateIdentifiersStorageStruct]: Error-> The senderID doesn't correspond to the actionID" << endl;
+        return;
+    }
+
+    vector<stationID_t>& receivers = it->second.receiverIDs;
+    if (receivers.empty() || receivers.back() != receiverID) {
+        receivers.push_back(receiverID);
     }
 }
 
 vector<stationID_t>
-V2xMessageManager::GroupReceivers(std::vector<IdentifiersStorageStruct>& table, actionID_t actionID, stationID_t senderID) {
-    vector<IdentifiersStorageStruct>::iterator i = table.begin();
-    vector<stationID_t> vReceivers;
-
-    while (i != table.end()) {
-        if ((*i).actionID == actionID) {
-            if ((*i).senderID == senderID) {
-                vReceivers.push_back((*i).receiverID);
-                (*i).stored = true;
-            }
-        }
-        ++i;
+V2xMessageManager::GroupReceivers(const IdentifiersStorageMap& table, actionID_t actionID, stationID_t senderID) {
+    IdentifiersStorageMap::const_iterator it = table.find(actionID);
+    if (it == table.end() || it->second.senderID != senderID) {
+        return vector<stationID_t>();
     }
-    return vReceivers;
+    return it->second.receiverIDs;
 }
 
 }
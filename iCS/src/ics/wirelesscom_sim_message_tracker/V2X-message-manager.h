@@ -62,6 +62,8 @@
 #endif
 
 #include "../../utils/ics/iCStypes.h"
+#include <map>
+#include <unordered_map>
 #include <vector>
 
 using namespace ics_types;
@@ -94,6 +96,43 @@ struct ScheduledCamMessageData {
     bool received;
 };
 
+/**
+ * @struct CamMessageKey
+ * @brief Identifies a scheduled CAM message: sender, timestep and sequence number.
+*/
+struct CamMessageKey {
+    stationID_t senderNs3ID;
+    icstime_t timeStep;
+    seqNo_t sequenceNumber;
+
+    bool operator==(const CamMessageKey& other) const {
+        return senderNs3ID == other.senderNs3ID && timeStep == other.timeStep && sequenceNumber == other.sequenceNumber;
+    }
+};
+
+/**
+ * @struct CamMessageKeyHash
+ * @brief Hash function of the CamMessageKey.
+*/
+struct CamMessageKeyHash {
+    size_t operator()(const CamMessageKey& key) const {
+        size_t hash = key.senderNs3ID;
+        hash = hash * 31 + (size_t) key.timeStep;
+        hash = hash * 31 + key.sequenceNumber;
+        return hash;
+    }
+};
+
+/**
+ * @struct ScheduledCamMessageIndex
+ * @brief Scheduled CAM messages indexed by their key. The keys are also grouped by timestep
+ * so that the expired messages are cleaned up without visiting the whole table.
+*/
+struct ScheduledCamMessageIndex {
+    std::unordered_map<CamMessageKey, ScheduledCamMessageData, CamMessageKeyHash> messages;
+    std::map<icstime_t, std::vector<CamMessageKey> > timeBuckets;
+};
+
 /**
  * @struct ScheduledUnicastMessageData
  * @brief Struct to store the information related to the UNICAST scheduled messages.
@@ -156,16 +195,16 @@ struct ScheduledGeobroadcastMessageData {
 
 /**
  * @struct IdentifiersStorageStruct
- * @brief Struct to store the identifiers related to a certain message.
- * @todo To be commented.
+ * @brief Struct to store the sender and the receivers of a certain message.
 */
 struct IdentifiersStorageStruct {
-    actionID_t actionID;
     stationID_t senderID;
-    stationID_t receiverID;
-    bool stored;
+    std::vector<stationID_t> receiverIDs;
 };
 
+/// @brief Identifiers of the received messages, by action ID.
+typedef std::unordered_map<actionID_t, IdentifiersStorageStruct> IdentifiersStorageMap;
+
 /**
  * @struct ScheduledTopobroadcastMessageData
  * @brief Struct to store the information related to the TOPOBROADCAST scheduled messages.
@@ -224,7 +263,29 @@ public:
      * @param[in] &table Table that contains the scheduled  CAM messages
      * @param[in] data New information to store in the table
      */
-    void InsertCamRow(std::vector<ScheduledCamMessageData>& table, ScheduledCamMessageData data);
+    void InsertCamRow(ScheduledCamMessageIndex& table, ScheduledCamMessageData data);
+
+    /**
+     * @brief Looks for the scheduled CAM message that matches a received one
+     * @param[in] &table Table that contains the scheduled CAM messages
+     * @param[in] rowReceived Information obtained from ns-3
+     * @return The matching row of the table, NULL if there isn't any
+     */
+    ScheduledCamMessageData* FindCamRow(ScheduledCamMessageIndex& table, const ScheduledCamMessageData& rowReceived);
+
+    /**
+     * @brief Erases a row from the table that stores the scheduled CAM messages
+     * @param[in] &table Table that contains the scheduled CAM messages
+     * @param[in] key Key of the row to erase
+     */
+    void EraseCamRow(ScheduledCamMessageIndex& table, const CamMessageKey& key);
+
+    /**
+     * @brief Erases the scheduled CAM messages of the timesteps up to a certain one
+     * @param[in] &table Table that contains the scheduled CAM messages
+     * @param[in] lastTimeStep Last timestep whose messages are erased
+     */
+    void RefreshCamRows(ScheduledCamMessageIndex& table, icstime_t lastTimeStep);
 
     /**
      * @brief Inserts a new row in the table that stores the scheduled UNICAST messages
@@ -290,17 +351,16 @@ public:
     * @param[in] senderID Identifier of the node that sent the message
     * @param[in] receiverID Idenfitier of the node that received the message
     */
-    void UpdateIdentifiersTable(std::vector<IdentifiersStorageStruct>& table, actionID_t actionID, stationID_t senderID, stationID_t receiverID);
+    void UpdateIdentifiersTable(IdentifiersStorageMap& table, actionID_t actionID, stationID_t senderID, stationID_t receiverID);
 
     /**
     * @brief Groups the receivers of a certain message
     * @param[in] &table Table that contains the identifiers related to a certain message
     * @param[in] actionID Action identifier of the message
     * @param[in] senderID Identifier of the node that sent the message
-    * @param[in] receiverID Idenfitier of the node that received the message
     * @return Group of receivers related to a certain message
     */
-    std::vector<stationID_t> GroupReceivers(std::vector<IdentifiersStorageStruct>& table, actionID_t actionID, stationID_t senderID);
+    std::vector<stationID_t> GroupReceivers(const IdentifiersStorageMap& table, actionID_t actionID, stationID_t senderID);
 
     /// @brief Collection of existing CAM areas.
     std::vector<V2xCamArea*>* m_v2xCamAreaCollection;
@@ -232,6 +232,7 @@ void OutputHelper::AddRsu(iCSInterface* rsu) {
 void OutputHelper::Log(iCSInterface* controller, std::string msg) {
     std::ostringstream strs;
     int msTime = CurrentTime::Now();
+    std::lock_guard<std::mutex> lock(m_mutex);
 
     if (msTime > m_lastMsTime) {
         strs << "  @" << msTime << std::endl;
@@ -258,6 +259,7 @@ void OutputHelper::Log(iCSInterface* controller, std::string msg) {
 /** CALLBACKS
  */
 void OutputHelper::OnPacketSend(iCSInterface* controller, server::Payload* payload) {
+    std::lock_guard<std::mutex> lock(m_mutex);
     if (m_samplePackets) {
         // check if sender is inside a sector
         if (IsVehicle(controller->GetNodeType())) {
@@ -288,6 +290,7 @@ void OutputHelper::OnPacketReceive(iCSInterface* controller, server::Payload* pa
         strs << "p_recv " /*<< InspectHeader (payload)*/;
         Log(controller, strs.str());
     }
+    std::lock_guard<std::mutex> lock(m_mutex);
     m_precv++;
 }
 
@@ -28,6 +28,7 @@
 #include "ics-interface.h"
 #include <fstream>
 #include <map>
+#include <mutex>
 #include <vector>
 
 namespace baseapp {
@@ -165,6 +166,8 @@ private:
     // vars
     int m_lastMsTime;
     std::ofstream out;
+    /// @brief The trace sinks may be called by nodes executed in parallel
+    std::mutex m_mutex;
 
     //godmode vars
     unsigned int m_maxRsuDensity, m_rsuDensityCount, m_rsuDensityAccum;
@@ -46,11 +46,18 @@ bool EventOrdering::operator()(const Event* left, const Event* right) {
 multiset<Event*, EventOrdering> Scheduler::m_list;
 event_id Scheduler::m_currentInvoke = 0;
 double Scheduler::m_currentTime = 0;
+map<int, vector<Event*> > Scheduler::m_deferred;
+mutex Scheduler::m_mutex;
+
+// Whether the events scheduled by this thread are deferred, and under which key
+static thread_local bool deferredThread = false;
+static thread_local int deferredKey = 0;
 
 void Scheduler::Cancel(event_id& id) {
     if (id == 0) {
         return;
     }
+    lock_guard<mutex> lock(m_mutex);
     for (multiset<Event*>::iterator it = m_list.begin(); it != m_list.end(); ++it) {
         if ((*it)->m_id == id) {
             //Can't cancel the current invocation here. Will be removed at the end of the invocation by the Notify
@@ -63,6 +70,47 @@ void Scheduler::Cancel(event_id& id) {
             return;
         }
     }
+    for (map<int, vector<Event*> >::iterator key = m_deferred.begin(); key != m_deferred.end(); ++key) {
+        for (vector<Event*>::iterator it = key->second.begin(); it != key->second.end(); ++it) {
+            if ((*it)->m_id == id) {
+                delete *it;
+                key->second.erase(it);
+                id = 0;
+                return;
+            }
+        }
+    }
+}
+
+event_id Scheduler::add(double time, EventCallBack* callBack) {
+    lock_guard<mutex> lock(m_mutex);
+    Event* e = new Event(time, callBack);
+    if (deferredThread) {
+        m_deferred[deferredKey].push_back(e);
+    } else {
+        m_list.insert(e);
+    }
+    return e->m_id;
+}
+
+void Scheduler::BeginDeferred(int key) {
+    deferredThread = true;
+    deferredKey = key;
+}
+
+void Scheduler::EndDeferred() {
+    deferredThread = false;
+}
+
+void Scheduler::CommitDeferred() {
+    lock_guard<mutex> lock(m_mutex);
+    for (map<int, vector<Event*> >::iterator key = m_deferred.begin(); key != m_deferred.end(); ++key) {
+        for (vector<Event*>::iterator it = key->second.begin(); it != key->second.end(); ++it) {
+            // Equal times are inserted after the ones already there
+            m_list.insert(*it);
+        }
+    }
+    m_deferred.clear();
 }
 
 int Scheduler::Notify(int currentTime) {
@@ -99,11 +147,19 @@ bool Scheduler::IsRunning(event_id id) {
     if (id == 0) {
         return false;
     }
+    lock_guard<mutex> lock(m_mutex);
     for (multiset<Event*>::iterator it = m_list.begin(); it != m_list.end(); ++it) {
         if ((*it)->m_id == id) {
             return true;
         }
     }
+    for (map<int, vector<Event*> >::const_iterator key = m_deferred.begin(); key != m_deferred.end(); ++key) {
+        for (vector<Event*>::const_iterator it = key->second.begin(); it != key->second.end(); ++it) {
+            if ((*it)->m_id == id) {
+                return true;
+            }
+        }
+    }
     return false;
 }
 
@@ -22,6 +22,8 @@
 #ifndef SCHEDULER_H_
 #define SCHEDULER_H_
 
+#include <map>
+#include <mutex>
 #include <set>
 #include <vector>
 #include "current-time.h"
@@ -95,6 +97,15 @@ public:
     static int Notify(int currentParameterime);
     static bool IsRunning(event_id id);
     static double GetCurrentTime();
+
+    /// @brief Until EndDeferred, the events scheduled by the calling thread are kept apart under
+    ///        the given key instead of being added to the scheduler. Used while the nodes run in parallel.
+    static void BeginDeferred(int key);
+    static void EndDeferred();
+    /// @brief Adds the deferred events to the scheduler by increasing key, so that the order of the
+    ///        events with the same time does not depend on the order in which the threads ran.
+    static void CommitDeferred();
+
     template<typename Method, class Class>
 
     /// @brief this schedules the given event aftert the given time (in ms.) from the time of scheduling.
@@ -102,26 +113,28 @@ public:
         time += CurrentTime::Now() > 0 ? CurrentTime::Now() : 0;
         NS_LOG_INFO("Schedule at " << time);
         EventCallBack* cb = new EventCallBackImpl<Class>(instance, function);
-        Event* e = new Event(time, cb);
-        m_list.insert(e);
-        return e->m_id;
+        return add(time, cb);
     }
     template<typename Method, class Class, typename Parameter>
     static event_id Schedule(double time, Method function, Class* instance, Parameter arg) {
         time += CurrentTime::Now() > 0 ? CurrentTime::Now() : 0;
         NS_LOG_INFO("Schedule at " << time);
         EventCallBack* cb = new EventCallBackImpl<Class, Parameter>(instance, function, arg);
-        Event* e = new Event(time, cb);
-        m_list.insert(e);
-        return e->m_id;
+        return add(time, cb);
     }
 private:
     static std::multiset<Event*, EventOrdering> m_list;
     static event_id m_currentInvoke;
     static double m_currentTime;
+    /// @brief Events scheduled while deferred, by key
+    static std::map<int, std::vector<Event*> > m_deferred;
+    /// @brief Guards the events against Schedule, Cancel and IsRunning called by parallel nodes.
+    ///        Notify is only called by the server thread while no node runs in parallel.
+    static std::mutex m_mutex;
 
     Scheduler();
     ~Scheduler();
+    static event_id add(double time, EventCallBack* callBack);
     static void updateAfterNotify();
 };
 } /* namespace application */
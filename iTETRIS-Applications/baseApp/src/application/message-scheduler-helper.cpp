@@ -26,6 +26,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <algorithm> // min
+#include <unordered_set>
 
 
 // Maximal number of objects to be stored in a CPM message
@@ -82,7 +83,7 @@ std::map<MessageType, std::string> MessageScheduler::m_defaultHighlightColor =
 };
 
 MessageScheduler::MessageScheduler(iCSInterface*  controller, const std::string& sumoPOI) :
-    m_node_interface(controller), m_eventBroadcast(0),  m_broadcastCheckInterval(100),
+    m_node_interface(controller), m_eventBroadcast(0),  m_broadcastCheckInterval(100), m_NodeMap(NULL),
     m_highlightDuration(m_defaultHighlightDuration),
     m_highlightSwitch(m_defaultHighlightSwitch),
     m_highlightColor(m_defaultHighlightColor),
@@ -159,7 +160,7 @@ void MessageScheduler::V2XmessageScheduler() {
     } */
 
     // Check CPM tx
-    m_NodeMap  = m_node_interface->GetAllNodes() ;
+    m_NodeMap  = &m_node_interface->GetAllNodes() ;
     CPM_Sensing();
 
 
@@ -333,9 +334,9 @@ void MessageScheduler::ForwardSensing(int sendernode, int sensorno) {
     double minangle ;
     double maxangle ;
 
-    double detectedvehiclesID [100];
-    double maskvehiclesID [100];
-    double nonmaskvehiclesID [100];
+    std::vector<double> detectedvehiclesID;
+    std::unordered_set<int> maskvehiclesID;
+    std::vector<double> nonmaskvehiclesID;
 
     //Sendernodeid details
     //	      double t = (Simulator::Now ()).GetSeconds ();
@@ -346,7 +347,14 @@ void MessageScheduler::ForwardSensing(int sendernode, int sensorno) {
 
     //--------------SENSOR  START------------------------
     //This for loop is to find vehicles within the sensor1 FOV
-    for (NodeMap::const_iterator it = m_NodeMap.begin(); it != m_NodeMap.end(); ++it) {
+    // Only the nodes around the sender can be inside the sensor range
+    std::vector<int> candidates;
+    m_node_interface->GetNodesAround(senderposition, Fsensordistance[sensorno] + carlength / 2, candidates);
+    for (std::vector<int>::const_iterator itId = candidates.begin(); itId != candidates.end(); ++itId) {
+        NodeMap::const_iterator it = m_NodeMap->find(*itId);
+        if (it == m_NodeMap->end()) {
+            continue;
+        }
 
         if (it->second->getNodeType() != 1) { //To avoid the RSU in detection
             int checknodeId = it->second->getId() ;
@@ -388,7 +396,7 @@ void MessageScheduler::ForwardSensing(int sendernode, int sensorno) {
                 if ((distance < Fsensing_distance_temp)  && (((Fsensornegativeangle[sensorno] <= angle) && (angle <= 0)) || ((0 <= angle) && (angle <= Fsensorpositiveangle[sensorno]))))
                     //if ( (distance < Fsensordistance[sensorno])+ (carlength/2) )
                 {
-                    detectedvehiclesID [ticket] = checknodeId;
+                    detectedvehiclesID.push_back(checknodeId);
                     ticket++;
                     detectedvehicles += 1;
 
@@ -407,8 +415,8 @@ void MessageScheduler::ForwardSensing(int sendernode, int sensorno) {
     if (detectedvehicles > 1) {
         for (uint32_t i = 0; i < ticket; ++i) {
 
-            int checki = m_NodeMap.operator [](detectedvehiclesID [i])->getId();
-            const Vector2D detectedi = m_NodeMap.operator [](detectedvehiclesID [i])->getPosition();
+            int checki = m_NodeMap->at(detectedvehiclesID[i])->getId();
+            const Vector2D detectedi = m_NodeMap->at(detectedvehiclesID[i])->getPosition();
             double distance1 = GetDistance(senderposition, detectedi);
 
 
@@ -504,8 +512,8 @@ void MessageScheduler::ForwardSensing(int sendernode, int sensorno) {
             for (uint32_t j = 0; j < ticket; ++j) {
                 uint32_t alreadyexist = 0;
 
-                int checkj = m_NodeMap.operator [](detectedvehiclesID [j])->getId();
-                const Vector2D detectedj = m_NodeMap.operator [](detectedvehiclesID [j])->getPosition();
+                int checkj = m_NodeMap->at(detectedvehiclesID[j])->getId();
+                const Vector2D detectedj = m_NodeMap->at(detectedvehiclesID[j])->getPosition();
                 double distance2 = GetDistance(senderposition, detectedj);
 
 
@@ -516,11 +524,8 @@ void MessageScheduler::ForwardSensing(int sendernode, int sensorno) {
                  Vector detectedj = model4->GetPosition ();
                  double distance2 = modelx->GetDistanceFrom (model4);*/
 
-                for (uint32_t ck = 0; ck < ticket1 ; ++ck) {
-                    if (maskvehiclesID [ck] == checkj) {
-                        alreadyexist = 1;
-                        break;
-                    }
+                if (maskvehiclesID.count(checkj) > 0) {
+                    alreadyexist = 1;
                 }
 
 
@@ -591,7 +596,7 @@ void MessageScheduler::ForwardSensing(int sendernode, int sensorno) {
                              (((targetrightback <= maxangle) && (targetrightfront <= maxangle)) && ((targetrightback  >= minangle) && (targetrightfront >= minangle))))  || (targetmedianangle == maskanglemedian)) {
                         //|| (mask_counter >= 2)
 
-                        maskvehiclesID [ticket1] = checkj;
+                        maskvehiclesID.insert(checkj);
                         ticket1++;
                     }
                 }
@@ -606,30 +611,18 @@ void MessageScheduler::ForwardSensing(int sendernode, int sensorno) {
 
     detectedvehicles = 0;
     for (uint32_t i = 0; i < ticket; ++i) {
-        int find = 0;
-        for (uint32_t j = 0; j < ticket1; ++j) {
-            if (detectedvehiclesID[i] == maskvehiclesID[j]) {
-                find += 1;
-                break;
-            }
-        }
-        if (find == 0) {
-            nonmaskvehiclesID[k] = detectedvehiclesID[i];
+        if (maskvehiclesID.count((int) detectedvehiclesID[i]) == 0) {
+            nonmaskvehiclesID.push_back(detectedvehiclesID[i]);
             k += 1;
             detectedvehicles += 1;
 
         }
     }
 
-    Globalflag =  Globalflag + k;
-
     //std::cout << "TOTAL VEHICLES DETECTED *AFTER* SENSOR MASKING : " << detectedvehicles << std::endl;
 
 
-    for (uint32_t i = 0; tvcount < Globalflag ; ++tvcount, ++i) {
-        Totaldetectedvehicles[tvcount] = nonmaskvehiclesID[i];
-        // std::cout << "FORWARD Non MASKING Vehicle ID : " << nonmaskvehiclesID[i] << std::endl;
-    }
+    Totaldetectedvehicles.insert(Totaldetectedvehicles.end(), nonmaskvehiclesID.begin(), nonmaskvehiclesID.end());
 
     //  std::cout << "FORWARD SENSING ENDS :  "<< std::endl;
     //-------------- SENSOR ENDS---------------
@@ -649,9 +642,9 @@ void MessageScheduler:: ReverseSensing(int sendernode, int sensorno) {
     double minangle ;
     double maxangle ;
 
-    double detectedvehiclesID [100];
-    double maskvehiclesID [100];
-    double nonmaskvehiclesID [100];
+    std::vector<double> detectedvehiclesID;
+    std::unordered_set<int> maskvehiclesID;
+    std::vector<double> nonmaskvehiclesID;
 
     //Sendernodeid details
 //	      double t = (Simulator::Now ()).GetSeconds ();
@@ -661,7 +654,14 @@ void MessageScheduler:: ReverseSensing(int sendernode, int sensorno) {
 
 //--------------SENSOR  START------------------------
     //This for loop is to find vehicles within the sensor1 FOV
-    for (NodeMap::const_iterator it = m_NodeMap.begin(); it != m_NodeMap.end(); ++it) {
+    // Only the nodes around the sender can be inside the sensor range
+    std::vector<int> candidates;
+    m_node_interface->GetNodesAround(senderposition, Rsensordistance[sensorno] + carlength / 2, candidates);
+    for (std::vector<int>::const_iterator itId = candidates.begin(); itId != candidates.end(); ++itId) {
+        NodeMap::const_iterator it = m_NodeMap->find(*itId);
+        if (it == m_NodeMap->end()) {
+            continue;
+        }
 
         if (it->second->getNodeType() != 1) { //To avoid the RSU in detection
             int checknodeId = it->second->getId() ;
@@ -700,7 +700,7 @@ void MessageScheduler:: ReverseSensing(int sendernode, int sensorno) {
 
                 double Rsensing_distance_temp = Rsensordistance[sensorno] + carlength / 2;
                 if ((distance < Rsensing_distance_temp) && (((angle <= Rsensornegativeangle[sensorno]) && (angle >= -180)) || ((angle >= Rsensorpositiveangle[sensorno]) && (angle <= 180)))) {
-                    detectedvehiclesID [ticket] = checknodeId;
+                    detectedvehiclesID.push_back(checknodeId);
                     ticket++;
                     detectedvehicles += 1;
 
@@ -722,8 +722,8 @@ void MessageScheduler:: ReverseSensing(int sendernode, int sensorno) {
     if (detectedvehicles > 1) {
         for (uint32_t i = 0; i < ticket; ++i) {
 
-            int checki = m_NodeMap.operator [](detectedvehiclesID [i])->getId();
-            const Vector2D detectedi = m_NodeMap.operator [](detectedvehiclesID [i])->getPosition();
+            int checki = m_NodeMap->at(detectedvehiclesID[i])->getId();
+            const Vector2D detectedi = m_NodeMap->at(detectedvehiclesID[i])->getPosition();
             double distance1 = GetDistance(senderposition, detectedi);
             //  std::cout << "DETECTED Vehicle ID :" << checki << "DISTANCE $1$ :  "<< distance1 << std::endl;
             //  std::cout << "DETECTED Vehicle X position :" << detectedi.x << std::endl;
@@ -827,15 +827,12 @@ void MessageScheduler:: ReverseSensing(int sendernode, int sensorno) {
             for (uint32_t j = 0; j < ticket; ++j) {
                 uint32_t alreadyexist = 0;
 
-                int checkj = m_NodeMap.operator [](detectedvehiclesID [j])->getId();
-                const Vector2D detectedj = m_NodeMap.operator [](detectedvehiclesID [j])->getPosition();
+                int checkj = m_NodeMap->at(detectedvehiclesID[j])->getId();
+                const Vector2D detectedj = m_NodeMap->at(detectedvehiclesID[j])->getPosition();
                 double distance2 = GetDistance(senderposition, detectedj);
 
-                for (uint32_t ck = 0; ck < ticket1 ; ++ck) {
-                    if (maskvehiclesID [ck] == checkj) {
-                        alreadyexist = 1;
-                        break;
-                    }
+                if (maskvehiclesID.count(checkj) > 0) {
+                    alreadyexist = 1;
                 }
 
 
@@ -920,7 +917,7 @@ void MessageScheduler:: ReverseSensing(int sendernode, int sensorno) {
                             ((((targetleftback <= maxangle) && (targetleftfront <= maxangle)) && ((targetleftback  >= minangle) && (targetleftfront  >= minangle))) ||
                              (((targetrightback <= maxangle) && (targetrightfront <= maxangle)) && ((targetrightback  >= minangle) && (targetrightfront >= minangle))))  || (targetmedianangle == maskanglemedian)) {
                         // || (mask_counter >= 2)
-                        maskvehiclesID [ticket1] = checkj;
+                        maskvehiclesID.insert(checkj);
                         ticket1++;
                     }
                 }
@@ -935,30 +932,18 @@ void MessageScheduler:: ReverseSensing(int sendernode, int sensorno) {
 
     detectedvehicles = 0;
     for (uint32_t i = 0; i < ticket; ++i) {
-        int find = 0;
-        for (uint32_t j = 0; j < ticket1; ++j) {
-            if (detectedvehiclesID[i] == maskvehiclesID[j]) {
-                find += 1;
-                break;
-            }
-        }
-        if (find == 0) {
-            nonmaskvehiclesID[k] = detectedvehiclesID[i];
+        if (maskvehiclesID.count((int) detectedvehiclesID[i]) == 0) {
+            nonmaskvehiclesID.push_back(detectedvehiclesID[i]);
             k += 1;
             detectedvehicles += 1;
 
         }
     }
 
-    Globalflag =  Globalflag + k;
-
     // std::cout << "TOTAL VEHICLES DETECTED *AFTER* SENSOR MASKING : " << detectedvehicles << std::endl;
 
 
-    for (uint32_t i = 0; tvcount < Globalflag ; ++tvcount, ++i) {
-        Totaldetectedvehicles[tvcount] = nonmaskvehiclesID[i];
-        //std::cout << "REVERSE Non MASKING Vehicle ID : " << nonmaskvehiclesID[i] << std::endl;
-    }
+    Totaldetectedvehicles.insert(Totaldetectedvehicles.end(), nonmaskvehiclesID.begin(), nonmaskvehiclesID.end());
 
     // std::cout << "REVERSE SENSING ENDS :  "<< std::endl;
 //-------------- SENSOR ENDS---------------
@@ -967,14 +952,13 @@ void MessageScheduler:: ReverseSensing(int sendernode, int sensorno) {
 
 
 void MessageScheduler::CPM_Sensing() {
-    Globalflag = 0;
-    tvcount = 0;
+    Totaldetectedvehicles.clear();
 
     uint32_t count = 7;
     uint32_t flag = 7;
 
     uint32_t ETSIcount = 0;
-    double detectedvehiclesETSI[100];
+    std::vector<double> detectedvehiclesETSI;
     double tempprevioustime = 0;
     double firstmsg = 0;
     double timedifference = 1;
@@ -996,27 +980,23 @@ void MessageScheduler::CPM_Sensing() {
         ForwardSensing(sendernodeId, sensorno);
         ReverseSensing(sendernodeId,  sensorno);
     }
-    //Fusion (removing duplicates from the 	Totaldetectedvehicles array
-
-    for (uint32_t i = 0; i < Globalflag; ++i)
-        for (uint32_t j = i + 1; j < Globalflag;) {
-            if (Totaldetectedvehicles[i] == Totaldetectedvehicles[j]) {
-                for (uint32_t k = j; k < Globalflag - 1; ++k) {
-                    Totaldetectedvehicles[k] = Totaldetectedvehicles[k + 1];
-                }
-
-                --Globalflag;
-            } else {
-                ++j;
-            }
+    //Fusion (removing duplicates from the 	Totaldetectedvehicles array, the first detection is kept)
+    std::unordered_set<int> fusedvehiclesID;
+    std::vector<double> fuseddetectedvehicles;
+    fuseddetectedvehicles.reserve(Totaldetectedvehicles.size());
+    for (uint32_t i = 0; i < Totaldetectedvehicles.size(); ++i) {
+        if (fusedvehiclesID.insert((int) Totaldetectedvehicles[i]).second) {
+            fuseddetectedvehicles.push_back(Totaldetectedvehicles[i]);
         }
+    }
+    Totaldetectedvehicles.swap(fuseddetectedvehicles);
 
     //***********ETSI MEssage Generation rules*******************
 
-    for (uint32_t i = 0; i < Globalflag; ++i) {
-        int ETvehid1 = m_NodeMap.operator [](Totaldetectedvehicles [i])->getId();
-        const Vector2D ETposition = m_NodeMap.operator [](Totaldetectedvehicles [i])->getPosition();
-        double ETvelocity = m_NodeMap.operator [](Totaldetectedvehicles [i])->getSpeed();
+    for (uint32_t i = 0; i < Totaldetectedvehicles.size(); ++i) {
+        int ETvehid1 = m_NodeMap->at(Totaldetectedvehicles[i])->getId();
+        const Vector2D ETposition = m_NodeMap->at(Totaldetectedvehicles[i])->getPosition();
+        double ETvelocity = m_NodeMap->at(Totaldetectedvehicles[i])->getSpeed();
 
         //std::cout << "DETECTED OBJECT ID after fusion :  "<< ETvehid1  << "  TIME  " << t << std::endl;
         std::map<int, data1> ::iterator ETSIit;
@@ -1045,7 +1025,7 @@ void MessageScheduler::CPM_Sensing() {
             // std::cout << "Vehicle TIME difference :  "<< timedifer  <<  std::endl;
 
             if (((vehiclemoved > 4) || (vehiclespeeddifference >  0.5)) || (timedifer >= 1000)) {
-                detectedvehiclesETSI [ETSIcount] = ETvehid1;
+                detectedvehiclesETSI.push_back(ETvehid1);
                 ETSIcount ++;
 
                 ETSIlist.erase(ETSIit);
@@ -1059,7 +1039,7 @@ void MessageScheduler::CPM_Sensing() {
         } else {
             ETSIlist.insert(std::pair<int, data1>(ETvehid1, current));
 
-            detectedvehiclesETSI [ETSIcount] = ETvehid1;
+            detectedvehiclesETSI.push_back(ETvehid1);
             ETSIcount ++;
 
             //    std::cout << "*******Vehicle Included in the CPM (else) :  "<< ETvehid1  << "  TIME  " << t << std::endl;
@@ -25,6 +25,7 @@
 
 #include <map>
 #include <queue>
+#include <vector>
 #include "foreign/tcpip/storage.h"
 #include "utils/common/RGBColor.h"
 #include "structs.h"
@@ -113,7 +114,7 @@ private:
 
     //Variables to detect the transmission of CPM objects
     typedef std::map<int, baseapp::application::Node*> NodeMap;
-    NodeMap m_NodeMap;
+    const NodeMap* m_NodeMap;
 
 #define totalsensors 1
     //For forwarding vehicles
@@ -131,9 +132,7 @@ private:
     double carlength = 5; //SUMO default value
     double carwidth = 2;
 
-    uint32_t tvcount = 0;
-    double Totaldetectedvehicles[100];
-    uint32_t Globalflag = 0;
+    std::vector<double> Totaldetectedvehicles;
 
     double sensorcontainer_size = 0;
     int CPM_number_of_objects = 0;
@@ -245,7 +245,7 @@ void iCSInterface::SubscribeBehaviour(Behaviour* behaviour) {
     }
 }
 
-bool iCSInterface::Receive(server::Payload* payload) {
+bool iCSInterface::Receive(server::Payload* payload, const double receptionSnr) {
     if (!m_active) {
         return false;
     }
@@ -258,8 +258,8 @@ bool iCSInterface::Receive(server::Payload* payload) {
     GetHeader(payload, server::PAYLOAD_FRONT, header);
 
     double snr = 110;
-    if (!std::isnan(payload->snr)) {
-        snr = payload->snr;
+    if (!std::isnan(receptionSnr)) {
+        snr = receptionSnr;
     }
     // discard unwanted packets
     if (!IsNodeType(GetNodeType(), header->getDestinationType())) {
@@ -1473,5 +1473,9 @@ const server::NodeMap& iCSInterface::GetAllNodes() const {
     return server::Server::GetNodeHandler()->getNodes();
 }
 
+void iCSInterface::GetNodesAround(const Vector2D& center, const double radius, std::vector<int>& nodeIds) const {
+    server::Server::GetNodeHandler()->getNodesAround(center, radius, nodeIds);
+}
+
 } /* namespace application */
 } /* namespace protocol */
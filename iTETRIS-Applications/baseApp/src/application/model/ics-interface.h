@@ -93,6 +93,10 @@ public:
      */
     const server::NodeMap& GetAllNodes() const;
 
+    /// @brief Returns the sorted ids of the nodes that may be within the given distance from a point
+    /// @note  Only a superset is guaranteed, the caller has to check the exact distance
+    void GetNodesAround(const Vector2D& center, const double radius, std::vector<int>& nodeIds) const;
+
     /**
      * @brief If the node is active
      */
@@ -196,9 +200,10 @@ public:
     /**
      * @brief Called by the node class when the node has received the message from iCS
      * @param[in] payload Message received
+     * @param[in] snr The snr of the reception from ns3
      * @return true if the message was for the node. False if the message has been discarded
      */
-    bool Receive(server::Payload* payload);
+    bool Receive(server::Payload* payload, const double snr);
 
     /**
      * @brief Called by the node class when iCS asks the application to execute.
@@ -147,13 +147,13 @@ bool Node::askForSubscription(const int subscriptionId, tcpip::Storage*& request
     return true;
 }
 
-void Node::applicationMessageReceive(int messageId, server::Payload* payload) {
+void Node::applicationMessageReceive(int messageId, server::Payload* payload, const double snr) {
     if (payload != NULL) {
         ostringstream log;
         log << "Node " << m_id << " (sumoID: '" << m_sumoId << "') received message " << messageId << " payload " << payload->getId() << " timestep "
             << payload->getTimeStep();
         Log::WriteLog(log);
-        m_controller->Receive(payload);
+        m_controller->Receive(payload, snr);
     } else {
         Log::WriteLog("MessageReceive: payload is NULL");
     }
@@ -168,9 +168,10 @@ bool Node::applicationExecute(DirectionValueMap& data) {
 
 void Node::send(server::Payload* payload, double time, const int messageCategory) {
     //Add the payload to the local storage
-    std::string key = server::Server::GetNodeHandler()->insertPayload(payload, false);
+    server::PayloadHandle handle = server::Server::GetNodeHandler()->insertPayload(payload, false);
+    std::string key = server::PayloadStorage::toExtra(handle);
     ostringstream oss;
-    oss << "[Node " << m_id << "] send to all. Key=" << key << ". Time=" << time;
+    oss << "[Node " << m_id << "] send to all. Key=" << handle << ". Time=" << time;
     Log::WriteLog(oss);
     //Schedule the creation of the subscription.
     // Variable message size for NS-3 (Size of the transmitted packet different from the size of the structure send)
@@ -195,9 +196,10 @@ void Node::send(server::Payload* payload, double time, const int messageCategory
 }
 
 void Node::sendTo(const int destinationId, server::Payload* payload, double time, const int messageCategory) {
-    std::string key = server::Server::GetNodeHandler()->insertPayload(payload, true);
+    server::PayloadHandle handle = server::Server::GetNodeHandler()->insertPayload(payload, true);
+    std::string key = server::PayloadStorage::toExtra(handle);
     ostringstream oss;
-    oss << "[Node " << m_id << "] send to " << destinationId << ". Key=" << key << ". Time=" << time;
+    oss << "[Node " << m_id << "] send to " << destinationId << ". Key=" << handle << ". Time=" << time;
     Log::WriteLog(oss);
     m_toSubscribe.push(
         SubscriptionHelper::SendUnicast(m_id, payload->size(), messageCategory, destinationId, key, time));
@@ -119,8 +119,9 @@ public:
      */
     /**
      * @brief The node has received a message. This method will call iCSInferface::Receive
+     * @param[in] snr The snr of the reception. The payload may be shared with other receivers.
      */
-    virtual void applicationMessageReceive(const int messageId, server::Payload* payload);
+    virtual void applicationMessageReceive(const int messageId, server::Payload* payload, const double snr);
     /**
      * @brief iCS asked the node to execute. This method will call iCSInferface::Execute
      */
@@ -37,6 +37,7 @@ TraciHelper::~TraciHelper() {
 }
 
 int TraciHelper::AddCommand(const Command& command) {
+    std::lock_guard<std::mutex> lock(m_instance.m_mutex);
     int current = ++m_executionIdCounter;
     m_instance.m_commandList[current] = command;
     return current;
@@ -60,16 +61,20 @@ int TraciHelper::AddSetCommand(const int commandId, const int variableId, const
 }
 
 bool TraciHelper::RemoveCommand(const int executionId) {
+    std::lock_guard<std::mutex> lock(m_instance.m_mutex);
     return m_instance.m_commandList.erase(executionId) > 0;
 }
 
 bool TraciHelper::HasCommand(const int executionId) {
+    std::lock_guard<std::mutex> lock(m_instance.m_mutex);
     return m_instance.m_commandList.find(executionId) != m_instance.m_commandList.end();
 }
 
 bool TraciHelper::GetCommand(const int executionId, Command& command) {
-    if (HasCommand(executionId)) {
-        command = m_instance.m_commandList[executionId];
+    std::lock_guard<std::mutex> lock(m_instance.m_mutex);
+    std::map<const int, Command>::const_iterator it = m_instance.m_commandList.find(executionId);
+    if (it != m_instance.m_commandList.end()) {
+        command = it->second;
         return true;
     }
     return false;
@@ -24,6 +24,7 @@
 #define SRC_APPLICATION_TRACI_HELPER_H_
 
 #include <map>
+#include <mutex>
 #include "foreign/tcpip/storage.h"
 #include "libsumo/TraCIConstants.h"
 
@@ -202,6 +203,8 @@ private:
 
     // map of active traci commands: executionID -> command
     std::map<const int, Command> m_commandList;
+    // the nodes may add commands while executed in parallel
+    std::mutex m_mutex;
 
     static int m_executionIdCounter;
 
@@ -21,6 +21,7 @@
  ***************************************************************************************/
 
 #include <memory>
+#include <thread>
 #include "ics-interface.h"
 #include "utils/log/console.h"
 #include "utils/xml/tinyxml2.h"
@@ -90,6 +91,7 @@ int ProgramConfiguration::LoadConfiguration(const char* fileName, int port) {
 ProgramConfiguration::ProgramConfiguration()
     : m_messageLifetime(10),
       m_sumoTotalDemandLevel(0),
+      m_executionThreads(1),
       m_socket(-1),
       m_testCase(""),
       m_start(0) {}
@@ -153,6 +155,19 @@ int ProgramConfiguration::ParseGeneral(XMLElement* general) {
         }
     }
 
+    xmlElem = general->FirstChildElement("execution-threads");
+    if (xmlElem) {
+        // 0 uses one thread per core
+        unsigned tmp = xmlElem->UnsignedAttribute("value");
+        if (tmp == 0) {
+            tmp = std::thread::hardware_concurrency();
+        }
+        if (tmp > 0) {
+            m_executionThreads = tmp;
+        }
+        Console::Log("Nodes executed by threads: ", m_executionThreads);
+    }
+
     xmlElem = general->FirstChildElement("random-run");
     if (xmlElem) {
         ns3::RngSeedManager::SetRun(xmlElem->IntAttribute("value"));
@@ -90,6 +90,10 @@ public:
     static unsigned GetSumoTotalDemandLevel() {
         return m_instance->m_sumoTotalDemandLevel;
     }
+    /// @brief Number of threads executing the nodes of a step. 1 executes them one after the other.
+    static unsigned GetExecutionThreads() {
+        return m_instance->m_executionThreads;
+    }
 
     static const std::string& GetTestCase() {
         return m_instance->m_testCase;
@@ -116,6 +120,7 @@ private:
     int m_socket;
     unsigned m_messageLifetime;
     unsigned m_sumoTotalDemandLevel;
+    unsigned m_executionThreads;
     std::string m_testCase;
     std::map<int, RsuData> m_rsus;
     std::map<LogType, std::string> m_logs;
@@ -24,10 +24,13 @@
 #include <climits>
 #include <vector>
 #include <memory>
+#include <algorithm>
+#include <cmath>
 
 #include "node-handler.h"
 #include "current-time.h"
 #include "program-configuration.h"
+#include "scheduler.h"
 #include "fixed-station.h"
 #include "log/log.h"
 #include "log/ToString.h"
@@ -51,11 +54,17 @@ using namespace std;
 using namespace application;
 
 std::string NodeHandler::emptyString = "";
+const double NodeHandler::POSITION_INDEX_CELL_SIZE = 100.;
 
 NodeHandler::NodeHandler(BehaviourFactory* factory) :
-    m_factory(factory), m_TMCBehaviour(nullptr), askedTMCForSubscriptions(false), executedRSUs(0) {
+    m_factory(factory), m_TMCBehaviour(nullptr), askedTMCForSubscriptions(false), executedRSUs(0),
+    m_positionIndexValid(false) {
     m_storage = new PayloadStorage();
     m_timeStepBuffer = new CircularBuffer<int>(ProgramConfiguration::GetMessageLifetime());
+    m_pool = NULL;
+    if (ProgramConfiguration::GetExecutionThreads() > 1) {
+        m_pool = new ThreadPool(ProgramConfiguration::GetExecutionThreads());
+    }
     setTMCBehaviour(factory->createTMCBehaviour());
 #ifdef DEBUG_TMC
     std::cout << "NodeHandler(): TMC present: " << (m_TMCBehaviour == nullptr ? "no" : "yes") << std::endl;
@@ -69,11 +78,13 @@ NodeHandler::~NodeHandler() {
         }
         m_nodes.clear();
     }
+    delete m_pool;
     delete m_storage;
     delete m_timeStepBuffer;
 }
 
 void NodeHandler::updateTimeStep(const int timeStep) {
+    m_positionIndexValid = false;
     int oldTimeStep;
     if (m_timeStepBuffer->addValue(timeStep, oldTimeStep)) {
         m_storage->expiredPayloadCleanUp(oldTimeStep);
@@ -100,6 +111,7 @@ bool NodeHandler::asStation(const int nodeId, FixedStation*& station) const {
 
 void NodeHandler::addNode(application::Node* node) {
     m_nodes.insert(std::make_pair(node->getId(), node));
+    m_positionIndexValid = false;
     if (node->isFixed()) {
         if (m_TMCBehaviour != nullptr) {
 #ifdef DEBUG_TMC
@@ -137,6 +149,7 @@ bool NodeHandler::removeMobileNode(const int nodeId, const int ns3NodeId, const
     } else {
         delete nodeIt->second;
         m_nodes.erase(nodeIt);
+        m_positionIndexValid = false;
     }
     std::ostringstream oss;
     oss << "Removed mobile node with id " << nodeId << " ns3id " << ns3NodeId << " sumoId " << sumoNodeId;
@@ -174,11 +187,18 @@ bool NodeHandler::endSubscription(const int nodeId, const int subscriptionId, co
 
 int NodeHandler::mobilityInformation(const int nodeId, const std::vector<MobilityInfo*>& info) {
     int count = 0;
+    m_positionIndexValid = false;
+    // In parallel mode the known nodes are updated once the new ones are created
+    std::map<int, std::vector<MobilityInfo*> > updates;
     for (std::vector<MobilityInfo*>::const_iterator it = info.begin(); it != info.end(); ++it) {
         Node* node;
         const int nodeID = (*it)->id;
         if (getNode(nodeID, node)) {
-            node->updateMobilityInformation(*it);
+            if (m_pool == NULL) {
+                node->updateMobilityInformation(*it);
+            } else {
+                updates[nodeID].push_back(*it);
+            }
         } else {
             if ((*it)->isMobile) {
                 node = new MobileNode(*it, m_factory);
@@ -191,47 +211,125 @@ int NodeHandler::mobilityInformation(const int nodeId, const std::vector<Mobilit
             addNode(node);
         }
     }
+    std::map<int, ThreadPool::Task> tasks;
+    for (std::map<int, std::vector<MobilityInfo*> >::const_iterator it = updates.begin(); it != updates.end(); ++it) {
+        Node* node;
+        getNode(it->first, node);
+        const std::vector<MobilityInfo*>* nodeInfo = &it->second;
+        tasks[it->first] = [node, nodeInfo]() {
+            for (std::vector<MobilityInfo*>::const_iterator info = nodeInfo->begin(); info != nodeInfo->end(); ++info) {
+                node->updateMobilityInformation(*info);
+            }
+        };
+    }
+    runNodeTasks(tasks);
     return count;
 }
 
-std::string NodeHandler::insertPayload(const Payload* payload, bool deleteOnRead) {
+PayloadHandle NodeHandler::insertPayload(const Payload* payload, bool deleteOnRead) {
     StoragePolicy policy = deleteOnRead ? kDeleteOnRead : kMultipleRead;
+    std::lock_guard<std::mutex> lock(m_storageMutex);
     return m_storage->insert(payload, policy);
 }
 
 void NodeHandler::applicationMessageReceive(const std::vector<Message>& messages) {
+    if (m_pool != NULL) {
+        // The payloads are looked up in the order of the messages, then every node receives its
+        // messages in a task. A payload sent to all is shared by its receivers, so they are given
+        // the snr of their reception instead of reading it from the payload.
+        std::vector<Node*> receivers(messages.size(), NULL);
+        std::vector<Payload*> payloads(messages.size(), NULL);
+        std::map<int, std::vector<size_t> > received;
+        for (size_t i = 0; i < messages.size(); ++i) {
+            if (getNode(messages[i].m_destinationId, receivers[i])) {
+                m_storage->find(messages[i].m_payloadHandle, payloads[i]);
+                received[messages[i].m_destinationId].push_back(i);
+            }
+        }
+        std::map<int, ThreadPool::Task> tasks;
+        for (std::map<int, std::vector<size_t> >::const_iterator it = received.begin(); it != received.end(); ++it) {
+            const std::vector<size_t>* indices = &it->second;
+            tasks[it->first] = [&messages, &receivers, &payloads, indices]() {
+                for (std::vector<size_t>::const_iterator i = indices->begin(); i != indices->end(); ++i) {
+                    receivers[*i]->applicationMessageReceive(messages[*i].m_messageId, payloads[*i], messages[*i].m_snr);
+                }
+            };
+        }
+        runNodeTasks(tasks);
+        // The listeners are shared by all the nodes
+        for (size_t i = 0; i < messages.size(); ++i) {
+            if (receivers[i] != NULL) {
+                if (payloads[i] != NULL) {
+                    payloads[i]->snr = messages[i].m_snr;
+                }
+                notifyReceptionListeners(receivers[i], payloads[i], messages[i]);
+                if (PayloadStorage::asPolicy(messages[i].m_payloadHandle) == kDeleteOnRead) {
+                    delete payloads[i];
+                }
+            }
+        }
+        return;
+    }
     for (std::vector<Message>::const_iterator it = messages.begin(); it != messages.end(); ++it) {
         Node* node;
         if (getNode(it->m_destinationId, node)) {
             Payload* payload = NULL;
-            if (m_storage->find(it->m_extra, payload)) {
+            if (m_storage->find(it->m_payloadHandle, payload)) {
                 payload->snr = it->m_snr;
             }
-            node->applicationMessageReceive(it->m_messageId, payload);
-            if (node->isFixed()) {
-#ifdef DEBUG_TMC
-                std::cout << "NodeHandler::applicationMessageReceive(): Sending copy of received message to TMC "
-                          << "(receiver: " << node->getId() << ", msgID: " << it->m_messageId << ")"
-                          << std::endl;
-#endif
-                // send a copy of the received message to all RSU message reception listeners
-                for (auto l : m_RSUMessageReceptionListeners) {
-                    l->ReceiveMessage(node->getId(), payload, it->m_messageId, false);
-                }
-            } else {
-                // send a copy of the received message to all Vehicle message reception listeners
-                for (auto l : m_VehicleMessageReceptionListeners) {
-                    l->ReceiveMessage(node->getId(), payload, it->m_messageId, false);
-                }
-            }
+            node->applicationMessageReceive(it->m_messageId, payload, it->m_snr);
+            notifyReceptionListeners(node, payload, *it);
             //The payload is deleted if necessary
-            if (m_storage->asPolicy(it->m_extra) == kDeleteOnRead) {
+            if (PayloadStorage::asPolicy(it->m_payloadHandle) == kDeleteOnRead) {
                 delete payload;
             }
         }
     }
 }
 
+void NodeHandler::notifyReceptionListeners(const Node* node, Payload* payload, const Message& message) {
+    if (node->isFixed()) {
+#ifdef DEBUG_TMC
+        std::cout << "NodeHandler::applicationMessageReceive(): Sending copy of received message to TMC "
+                  << "(receiver: " << node->getId() << ", msgID: " << message.m_messageId << ")"
+                  << std::endl;
+#endif
+        // send a copy of the received message to all RSU message reception listeners
+        for (auto l : m_RSUMessageReceptionListeners) {
+            l->ReceiveMessage(node->getId(), payload, message.m_messageId, false);
+        }
+    } else {
+        // send a copy of the received message to all Vehicle message reception listeners
+        for (auto l : m_VehicleMessageReceptionListeners) {
+            l->ReceiveMessage(node->getId(), payload, message.m_messageId, false);
+        }
+    }
+}
+
+void NodeHandler::runNodeTasks(std::map<int, ThreadPool::Task>& tasks) {
+    if (tasks.empty()) {
+        return;
+    }
+    std::vector<ThreadPool::Task> poolTasks;
+    poolTasks.reserve(tasks.size());
+    for (std::map<int, ThreadPool::Task>::iterator it = tasks.begin(); it != tasks.end(); ++it) {
+        const int nodeId = it->first;
+        ThreadPool::Task* task = &it->second;
+        poolTasks.push_back([nodeId, task]() {
+            Scheduler::BeginDeferred(nodeId);
+            try {
+                (*task)();
+            } catch (...) {
+                Scheduler::EndDeferred();
+                throw;
+            }
+            Scheduler::EndDeferred();
+        });
+    }
+    m_pool->run(poolTasks);
+    Scheduler::CommitDeferred();
+}
+
 bool NodeHandler::applicationExecute(const int nodeId, DirectionValueMap& data) {
     if (ProgramConfiguration::GetStartTime() >= CurrentTime::Now()) {
         return false;
@@ -245,6 +343,45 @@ bool NodeHandler::applicationExecute(const int nodeId, DirectionValueMap& data)
     return false;
 }
 
+void NodeHandler::applicationExecute(std::vector<ApplicationExecution>& executions) {
+    if (m_pool == NULL) {
+        for (std::vector<ApplicationExecution>::iterator it = executions.begin(); it != executions.end(); ++it) {
+            it->result = applicationExecute(it->nodeId, it->data);
+        }
+        return;
+    }
+    if (ProgramConfiguration::GetStartTime() >= CurrentTime::Now()) {
+        return;
+    }
+    // A node asked more than once executes in the order of the requests
+    std::map<int, std::vector<ApplicationExecution*> > byNode;
+    for (std::vector<ApplicationExecution>::iterator it = executions.begin(); it != executions.end(); ++it) {
+        if (hasNode(it->nodeId)) {
+            byNode[it->nodeId].push_back(&*it);
+        }
+    }
+    std::map<int, ThreadPool::Task> tasks;
+    for (std::map<int, std::vector<ApplicationExecution*> >::const_iterator it = byNode.begin(); it != byNode.end(); ++it) {
+        Node* node;
+        getNode(it->first, node);
+        const std::vector<ApplicationExecution*>* nodeExecutions = &it->second;
+        tasks[it->first] = [node, nodeExecutions]() {
+            for (std::vector<ApplicationExecution*>::const_iterator e = nodeExecutions->begin(); e != nodeExecutions->end(); ++e) {
+                (*e)->result = node->applicationExecute((*e)->data);
+            }
+        };
+    }
+    runNodeTasks(tasks);
+    // The TMC is shared by the RSUs
+    for (std::map<int, std::vector<ApplicationExecution*> >::const_iterator it = byNode.begin(); it != byNode.end(); ++it) {
+        Node* node;
+        getNode(it->first, node);
+        for (size_t i = 0; i < it->second.size(); ++i) {
+            checkTMCExecution(node);
+        }
+    }
+}
+
 void NodeHandler::checkTMCExecution(const Node* node) {
     if (node->isFixed()) {
 #ifdef DEBUG_TMC
@@ -317,7 +454,44 @@ void NodeHandler::deleteNode(int nodeId) {
     if (it != m_nodes.end()) {
         delete it->second;
         m_nodes.erase(it);
+        m_positionIndexValid = false;
+    }
+}
+
+int NodeHandler::getPositionIndexCell(const double coordinate) {
+    return (int) std::floor(coordinate / POSITION_INDEX_CELL_SIZE);
+}
+
+void NodeHandler::buildPositionIndex() const {
+    m_positionIndex.clear();
+    for (NodeMap::const_iterator it = m_nodes.begin(); it != m_nodes.end(); ++it) {
+        const Vector2D position = it->second->getPosition();
+        std::pair<int, int> cell(getPositionIndexCell(position.x), getPositionIndexCell(position.y));
+        // Nodes are visited by increasing id, so every cell stays sorted
+        m_positionIndex[cell].push_back(it->first);
+    }
+    m_positionIndexValid = true;
+}
+
+void NodeHandler::getNodesAround(const Vector2D& center, const double radius, std::vector<int>& nodeIds) const {
+    std::lock_guard<std::mutex> lock(m_positionIndexMutex);
+    if (!m_positionIndexValid) {
+        buildPositionIndex();
+    }
+    nodeIds.clear();
+    const int minX = getPositionIndexCell(center.x - radius);
+    const int maxX = getPositionIndexCell(center.x + radius);
+    const int minY = getPositionIndexCell(center.y - radius);
+    const int maxY = getPositionIndexCell(center.y + radius);
+    for (int x = minX; x <= maxX; ++x) {
+        for (int y = minY; y <= maxY; ++y) {
+            std::map<std::pair<int, int>, std::vector<int> >::const_iterator it = m_positionIndex.find(std::make_pair(x, y));
+            if (it != m_positionIndex.end()) {
+                nodeIds.insert(nodeIds.end(), it->second.begin(), it->second.end());
+            }
+        }
     }
+    std::sort(nodeIds.begin(), nodeIds.end());
 }
 
 void NodeHandler::trafficLightInformation(const int nodeId, const bool error, const std::vector<std::string>& data) {
@@ -24,9 +24,11 @@
 #define NODEHANDLER_H_
 
 #include <map>
+#include <mutex>
 #include <set>
 #include "payload-storage.h"
 #include "circular-buffer.h"
+#include "thread-pool.h"
 #include "structs.h"
 #include "node.h"
 #include "mobile-node.h"
@@ -50,6 +52,16 @@ public:
         virtual void ReceiveMessage(int receiverID, server::Payload* payload, double snr, bool mobileNode = false) = 0;
     };
 
+    /// @brief Execution of a node asked by iCS and its result
+    struct ApplicationExecution {
+        ApplicationExecution(const int id) :
+            nodeId(id), result(false) {
+        }
+        int nodeId;
+        //whether there is data to send to iCS
+        bool result;
+        DirectionValueMap data;
+    };
 
 
     NodeHandler(application::BehaviourFactory* factory);
@@ -90,10 +102,17 @@ public:
     int mobilityInformation(const int nodeId, const std::vector<MobilityInfo*>& info);
     void trafficLightInformation(const int nodeId, const bool error, const std::vector<std::string>& data);
     //returns the id of the payload
-    std::string insertPayload(const Payload* payload, bool deleteOnRead = true);
+    PayloadHandle insertPayload(const Payload* payload, bool deleteOnRead = true);
     void applicationMessageReceive(const std::vector<Message>& messages);
     //returns if there is data to send to iCS
     bool applicationExecute(const int nodeId, DirectionValueMap& data);
+    /// @brief Executes the given nodes, in parallel when more than one execution thread is configured.
+    ///        The events scheduled by the nodes and the TMC execution are applied in node id order.
+    void applicationExecute(std::vector<ApplicationExecution>& executions);
+    /// @brief Whether the nodes are executed by more than one thread
+    bool isParallel() const {
+        return m_pool != NULL;
+    }
     void ConfirmSubscription(const int nodeId, const int subscriptionId, const bool status);
 
     void deleteNode(int);
@@ -113,6 +132,13 @@ public:
         return m_nodes;
     }
 
+    /// @brief Collects the nodes whose position may be within a given distance from a point
+    /// @param[in] center Center of the searched area
+    /// @param[in] radius Searched distance
+    /// @param[out] nodeIds Sorted ids of the nodes in the index cells overlapping the area.
+    ///             The caller has to check the exact distance.
+    void getNodesAround(const application::Vector2D& center, const double radius, std::vector<int>& nodeIds) const;
+
     void setTMCBehaviour(application::TMCBehaviour* b);
 
     /// @brief Adds a RSU message reception listener.
@@ -135,9 +161,32 @@ private:
     /// @brief This method monitores the request for subscriptions by the TMC Behaviour, if existent.
     void checkTMCSubscriptionRequests(const application::Node* node);
 
+    /// @brief Forwards a copy of a message received by a node to the reception listeners
+    void notifyReceptionListeners(const application::Node* node, Payload* payload, const Message& message);
+
+    /// @brief Runs the tasks of the nodes in the thread pool. The events scheduled by a task are
+    ///        deferred and added to the scheduler in node id order once all the tasks are done.
+    /// @param[in] tasks Task of every node, by node id
+    void runNodeTasks(std::map<int, ThreadPool::Task>& tasks);
+
+    /// @brief Fills the position index with the current position of all the nodes
+    void buildPositionIndex() const;
+
+    /// @brief Returns the index cell of a coordinate
+    static int getPositionIndexCell(const double coordinate);
+
     NodeMap m_nodes;
     std::map<std::string, int> m_sumoICSIDMap;
 
+    /// @brief Uniform grid of the node ids by position. It is rebuilt on the first query after
+    ///        a node has been added, removed or moved.
+    mutable std::map<std::pair<int, int>, std::vector<int> > m_positionIndex;
+    mutable bool m_positionIndexValid;
+    /// @brief Guards the position index, which is queried by nodes executed in parallel
+    mutable std::mutex m_positionIndexMutex;
+    /// @brief Side of the cells of the position index (in m.)
+    static const double POSITION_INDEX_CELL_SIZE;
+
     /// @brief Whether the TMC was already asked for general subscriptions to be issued in this sim step
     bool askedTMCForSubscriptions;
     /// @brief Whether the TMC was already executed in this sim step
@@ -147,7 +196,11 @@ private:
 
 
     PayloadStorage* m_storage;
+    /// @brief Guards the storage, which is filled by nodes executed in parallel
+    std::mutex m_storageMutex;
     CircularBuffer<int>* m_timeStepBuffer;
+    /// @brief Threads executing the nodes, NULL if they are executed one after the other
+    ThreadPool* m_pool;
 
     /// @brief Logic for the traffic management control, @see BehaviourFactory
     ///        The TMC Behaviour receives a copy of all received messages for the RSUs
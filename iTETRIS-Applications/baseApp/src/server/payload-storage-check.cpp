@@ -0,0 +1,73 @@
+/*
+ * This file is part of the iTETRIS Control System (https://github.com/DLR-TS/ics-transaid)
+ * Copyright (c) 2008-2021 iCS development team and contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+/****************************************************************************************
+ * Round trip of the payload handles through the extra string exchanged with iCS and ns-3.
+ *
+ * The handles are chosen so that their bytes contain 0x20 and 0x00: ns-3 splits the
+ * generic container at the first space and reads a leading 0 byte as a TOPO field list,
+ * so the encoded extra must contain neither.
+ *
+ * Usage: payload-storage-check
+ ***************************************************************************************/
+
+#include <cstdlib>
+#include <iostream>
+#include <stdint.h>
+#include "payload-storage.h"
+
+using namespace std;
+using namespace baseapp::server;
+
+static PayloadHandle MakeHandle(StoragePolicy policy, uint32_t generation, uint32_t index) {
+    return ((PayloadHandle) policy << 63) | ((PayloadHandle) generation << 32) | index;
+}
+
+static bool Check(PayloadHandle handle) {
+    string extra = PayloadStorage::toExtra(handle);
+    bool ok = !extra.empty() && extra[0] != '\0' && extra.find(' ') == string::npos
+              && extra.find('\0') == string::npos
+              && PayloadStorage::fromExtra(extra) == handle
+              && PayloadStorage::fromExtra(extra + " 7") == handle;
+    if (!ok) {
+        cerr << "Handle " << hex << handle << " encoded as '" << extra << "' does not round trip" << endl;
+    }
+    return ok;
+}
+
+int main() {
+    bool ok = true;
+    const StoragePolicy policies[] = { kDeleteOnRead, kMultipleRead };
+    for (int p = 0; p < 2; ++p) {
+        ok &= Check(MakeHandle(policies[p], 1, 0));
+        ok &= Check(MakeHandle(policies[p], 1, 0x20));
+        ok &= Check(MakeHandle(policies[p], 0x20, 0x20));
+        ok &= Check(MakeHandle(policies[p], 0x10000, 0x2000));
+        ok &= Check(MakeHandle(policies[p], 0x20202020, 0x20202020));
+        ok &= Check(MakeHandle(policies[p], 0x7FFFFFFF, 0xFFFFFFFF));
+    }
+    ok &= PayloadStorage::fromExtra("") == 0;
+    ok &= PayloadStorage::fromExtra("x12") == 0;
+    ok &= PayloadStorage::fromExtra("d") == 0;
+    ok &= PayloadStorage::fromExtra("d 12") == 0;
+    if (!ok) {
+        cerr << "payload-storage-check failed" << endl;
+        return EXIT_FAILURE;
+    }
+    cout << "payload-storage-check passed" << endl;
+    return EXIT_SUCCESS;
+}
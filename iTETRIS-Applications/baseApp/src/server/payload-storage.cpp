@@ -22,6 +22,8 @@
 
 #include "payload-storage.h"
 #include "../utils/log/log.h"
+#include <cctype>
+#include <cstdlib>
 #include <sstream>
 
 namespace baseapp {
@@ -29,101 +31,148 @@ namespace server {
 
 using namespace std;
 
+static const int POLICY_SHIFT = 63;
+static const int GENERATION_SHIFT = 32;
+static const uint32_t GENERATION_MASK = 0x7FFFFFFF;
+static const PayloadHandle POLICY_BIT = (PayloadHandle) 1 << POLICY_SHIFT;
+
 PayloadStorage::PayloadStorage() {
-    m_counter = 0;
+    m_size = 0;
 }
 
 PayloadStorage::~PayloadStorage() {
-    if (m_storage.size() > 0) {
-        for (map<unsigned, const Payload*>::const_iterator it = m_storage.begin(); it != m_storage.end(); ++it) {
-            delete (it->second);
-        }
-        m_storage.clear();
+    for (vector<Slot>::iterator it = m_slots.begin(); it != m_slots.end(); ++it) {
+        delete (it->payload);
     }
+    m_slots.clear();
 }
 
-string PayloadStorage::insert(const Payload* payload, const StoragePolicy policy) {
-    m_storage.insert(make_pair(++m_counter, payload));
-    return createKey(policy);
+PayloadHandle PayloadStorage::insert(const Payload* payload, const StoragePolicy policy) {
+    uint32_t index;
+    if (m_freeSlots.empty()) {
+        index = m_slots.size();
+        Slot slot;
+        slot.payload = NULL;
+        slot.generation = 1;
+        m_slots.push_back(slot);
+    } else {
+        index = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    }
+    m_slots[index].payload = payload;
+    ++m_size;
+    PayloadHandle handle = ((PayloadHandle) policy << POLICY_SHIFT)
+                           | ((PayloadHandle) m_slots[index].generation << GENERATION_SHIFT) | index;
+    m_timeBuckets[payload->getTimeStep()].push_back(handle);
+    return handle;
 }
 
-bool PayloadStorage::find(const string& key, Payload*& payload) {
-    map<unsigned, const Payload*>::iterator it = m_storage.find(getIndex(key));
-    if (it == m_storage.end()) {
+bool PayloadStorage::find(const PayloadHandle handle, Payload*& payload) {
+    uint32_t index;
+    if (!getIndex(handle, index)) {
         return false;
     }
-    payload = (Payload*) it->second;
-    if (asPolicy(key) == kDeleteOnRead) {
-        m_storage.erase(it);
+    payload = (Payload*) m_slots[index].payload;
+    if (asPolicy(handle) == kDeleteOnRead) {
+        release(index);
     }
     return true;
 }
 
-bool PayloadStorage::erase(const std::string& key) {
-    return m_storage.erase(getIndex(key));
+bool PayloadStorage::erase(const PayloadHandle handle) {
+    uint32_t index;
+    if (!getIndex(handle, index)) {
+        return false;
+    }
+    release(index);
+    return true;
 }
 
-bool PayloadStorage::eraseAndDelete(const string& key) {
-    map<unsigned, const Payload*>::iterator it = m_storage.find(getIndex(key));
-    if (it == m_storage.end()) {
+bool PayloadStorage::eraseAndDelete(const PayloadHandle handle) {
+    uint32_t index;
+    if (!getIndex(handle, index)) {
         return false;
     }
-    delete (it->second);
-    m_storage.erase(it);
+    delete (m_slots[index].payload);
+    release(index);
     return true;
 }
 
-bool PayloadStorage::hasKey(const string& key) const {
-    return m_storage.count(getIndex(key));
+bool PayloadStorage::hasKey(const PayloadHandle handle) const {
+    uint32_t index;
+    return getIndex(handle, index);
 }
 
 int PayloadStorage::expiredPayloadCleanUp(const int oldTimeStep) {
     int number = 0;
-    ostringstream log;
-    log << "ExpiredPayloadCleanUp for time: " << oldTimeStep << ". Removing keys: ";
-    for (map<unsigned, const Payload*>::iterator it = m_storage.begin(); it != m_storage.end();) {
-        if (it->second->getTimeStep() <= oldTimeStep) {
-            log << it->first << " ";
-            ++number;
-            delete (it->second);
-            it = m_storage.erase(it);
-        } else {
-            ++it;
+    while (!m_timeBuckets.empty() && m_timeBuckets.begin()->first <= oldTimeStep) {
+        const vector<PayloadHandle>& handles = m_timeBuckets.begin()->second;
+        for (vector<PayloadHandle>::const_iterator it = handles.begin(); it != handles.end(); ++it) {
+            // The payloads already read or erased are skipped, their slot has a new generation
+            if (eraseAndDelete(*it)) {
+                ++number;
+            }
         }
+        m_timeBuckets.erase(m_timeBuckets.begin());
     }
-    if (number == 0) {
-        log << "noting to remove ";
-    }
-    log << "Current size: " << m_storage.size();
+    ostringstream log;
+    log << "ExpiredPayloadCleanUp for time: " << oldTimeStep << ". Removed " << number << " payloads. Current size: "
+        << m_size;
     Log::WriteLog(log);
     return number;
 }
 
-unsigned PayloadStorage::getIndex(const string& key) const {
-    unsigned index;
-    istringstream(key.substr(1, key.size())) >> index;
-    return index;
+bool PayloadStorage::getIndex(const PayloadHandle handle, uint32_t& index) const {
+    index = (uint32_t) handle;
+    uint32_t generation = (uint32_t)(handle >> GENERATION_SHIFT) & GENERATION_MASK;
+    return index < m_slots.size() && m_slots[index].generation == generation && m_slots[index].payload != NULL;
 }
 
-string PayloadStorage::createKey(const StoragePolicy policy) const {
-    ostringstream key;
-    key << asChar(policy) << m_counter;
-    return key.str();
+void PayloadStorage::release(const uint32_t index) {
+    Slot& slot = m_slots[index];
+    slot.payload = NULL;
+    slot.generation = (slot.generation + 1) & GENERATION_MASK;
+    if (slot.generation == 0) {
+        slot.generation = 1;
+    }
+    m_freeSlots.push_back(index);
+    --m_size;
 }
 
-char PayloadStorage::asChar(const StoragePolicy policy) const {
-    return (char) policy;
+StoragePolicy PayloadStorage::asPolicy(const PayloadHandle handle) {
+    return (handle >> POLICY_SHIFT) ? kMultipleRead : kDeleteOnRead;
 }
 
-StoragePolicy PayloadStorage::asPolicy(const string& key) const {
-    switch (key[0]) {
-        case 'd':
-            return kDeleteOnRead;
-        case 'm':
-            return kMultipleRead;
-        default:
-            return kDeleteOnRead;
+string PayloadStorage::toExtra(const PayloadHandle handle) {
+    // ns-3 parses the extra: it may not contain a space or start with a 0 byte (TYPE_TOPO),
+    // so the handle travels as the policy letter followed by the hex digits of slot and generation
+    static const char DIGITS[] = "0123456789abcdef";
+    char extra[18]; // letter, up to 16 digits and the terminator
+    char* pos = extra + sizeof(extra) - 1;
+    *pos = '\0';
+    PayloadHandle value = handle & ~POLICY_BIT;
+    do {
+        *--pos = DIGITS[value & 0xF];
+        value >>= 4;
+    } while (value != 0);
+    *--pos = asPolicy(handle) == kMultipleRead ? 'm' : 'd';
+    return string(pos, extra + sizeof(extra) - 1 - pos);
+}
+
+PayloadHandle PayloadStorage::fromExtra(const string& extra) {
+    if (extra.size() < 2 || (extra[0] != 'd' && extra[0] != 'm') || !isxdigit((unsigned char) extra[1])) {
+        return 0;
+    }
+    const char* digits = extra.c_str() + 1;
+    char* end;
+    PayloadHandle handle = strtoull(digits, &end, 16);
+    if (end == digits || (*end != '\0' && *end != ' ') || (handle & POLICY_BIT)) {
+        return 0;
+    }
+    if (extra[0] == 'm') {
+        handle |= POLICY_BIT;
     }
+    return handle;
 }
 
 } /* namespace server */
@@ -25,39 +25,65 @@
 
 #include <map>
 #include <string>
+#include <vector>
+#include <stdint.h>
 #include "payload.h"
 
 namespace baseapp {
 namespace server {
 
 enum StoragePolicy {
-    kDeleteOnRead = (int) 'd', kMultipleRead = (int) 'm'
+    kDeleteOnRead = 0, kMultipleRead = 1
 };
 
+/**
+ * Handle of a stored payload. The lower 32 bits are the index of its slot, the next 31 bits
+ * the generation of the slot, so that the handle of a removed payload is never valid again,
+ * and the highest bit is the storage policy. 0 is never a valid handle.
+ */
+typedef uint64_t PayloadHandle;
+
+/**
+ * Stores the payloads of the messages sent by the nodes until they are received.
+ * The payloads are kept in a slot map and bucketed by timestep, so that the expired
+ * ones are removed without visiting the whole storage.
+ */
 class PayloadStorage {
 public:
     PayloadStorage();
     virtual ~PayloadStorage();
 
-    std::string insert(const Payload* payload, const StoragePolicy policy = kDeleteOnRead);
-    bool find(const std::string& key, Payload*& payload);
-    bool erase(const std::string& key);
-    bool eraseAndDelete(const std::string& key);
-    bool hasKey(const std::string& key) const;
+    PayloadHandle insert(const Payload* payload, const StoragePolicy policy = kDeleteOnRead);
+    bool find(const PayloadHandle handle, Payload*& payload);
+    bool erase(const PayloadHandle handle);
+    bool eraseAndDelete(const PayloadHandle handle);
+    bool hasKey(const PayloadHandle handle) const;
     int expiredPayloadCleanUp(const int oldTimeStep);
-    StoragePolicy asPolicy(const std::string& key) const;
     int size() const {
-        return m_storage.size();
+        return m_size;
     }
 
+    static StoragePolicy asPolicy(const PayloadHandle handle);
+    /// @brief Encodes the handle as the extra string shared with the recipient nodes:
+    ///        'd' or 'm' for the policy followed by the handle in hexadecimal digits
+    static std::string toExtra(const PayloadHandle handle);
+    /// @brief Decodes the handle at the beginning of an extra string, 0 if there is none
+    static PayloadHandle fromExtra(const std::string& extra);
+
 private:
-    std::string createKey(const StoragePolicy policy) const;
-    char asChar(const StoragePolicy policy) const;
-    unsigned getIndex(const std::string& key) const;
+    struct Slot {
+        const Payload* payload;
+        uint32_t generation;
+    };
+
+    bool getIndex(const PayloadHandle handle, uint32_t& index) const;
+    void release(const uint32_t index);
 
 private:
-    std::map<unsigned, const Payload*> m_storage;
-    unsigned m_counter;
+    std::vector<Slot> m_slots;
+    std::vector<uint32_t> m_freeSlots;
+    std::map<int, std::vector<PayloadHandle> > m_timeBuckets;
+    int m_size;
 };
 
 } /* namespace server */
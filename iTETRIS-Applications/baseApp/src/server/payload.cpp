@@ -27,7 +27,7 @@
 namespace baseapp {
 namespace server {
 
-int Payload::PAYLOAD_ID = 0;
+std::atomic<int> Payload::PAYLOAD_ID(0);
 
 Payload::Payload(int size) :
     m_size(size), snr(0) {
@@ -23,6 +23,7 @@
 #ifndef PAYLOAD_H_
 #define PAYLOAD_H_
 
+#include <atomic>
 #include <list>
 #include "headers.h"
 
@@ -55,7 +56,7 @@ private:
     int m_id;
     int m_size;
     std::list<application::Header*> m_headerList;
-    static int PAYLOAD_ID;
+    static std::atomic<int> PAYLOAD_ID;
 };
 
 } /* namespace server */
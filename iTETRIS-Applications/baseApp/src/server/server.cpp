@@ -84,6 +84,7 @@ void Server::RunServer(application::BehaviourFactory* factory) {
                 // dispatch each command
                 m_instance->dispatchCommand();
             }
+            m_instance->executePending();
         }
         if (m_closeConnection && m_instance->m_outputStorage.size() > 0) {
             // send out all answers as one storage
@@ -131,6 +132,10 @@ int Server::dispatchCommand() {
     int commandLength = m_inputStorage.readInt();
 
     int commandId = m_inputStorage.readUnsignedByte();
+    if (commandId != CMD_NOTIFY_APP_EXECUTE) {
+        // the nodes are executed before any other command is answered
+        executePending();
+    }
 
     bool success = false;
     // dispatch commands
@@ -171,7 +176,7 @@ int Server::dispatchCommand() {
             writeStatusCmd(CMD_APP_CLOSE, APP_RTYPE_OK, "Closing");
             break;
         case CMD_SUMO_TRACI_COMMAND:
-            success = sumoTraciCommand();
+            success = sumoTraciCommand(commandStart + commandLength);
             break;
         case CMD_RECEIVED_CAM_INFO:
             success = getReceivedCAMinfo();
@@ -179,6 +184,11 @@ int Server::dispatchCommand() {
         case CMD_SUMO_STEPLENGTH:
             success = storeSUMOStepLength();
             break;
+        case CMD_BATCH_MODE:
+            // the commands of a message are dispatched one after the other, so several nodes can be served at once
+            writeStatusCmd(CMD_BATCH_MODE, APP_RTYPE_OK, "CMD_BATCH_MODE");
+            success = true;
+            break;
 
         default:
             writeStatusCmd(commandId, APP_RTYPE_NOTIMPLEMENTED, "Command not implemented");
@@ -341,6 +351,7 @@ bool Server::applicationMessageReceive() {
         std::string extra_aux = m_inputStorage.readString();
         extra_aux.substr(0, extra_aux.find(" "));
         message.m_extra = extra_aux;
+        message.m_payloadHandle = PayloadStorage::fromExtra(extra_aux);
 
         short size = m_inputStorage.readShort();
         ostringstream log;
@@ -356,7 +367,7 @@ bool Server::applicationMessageReceive() {
             //TAG_TXPOWER
             m_inputStorage.readUnsignedByte();
             unsigned int power = m_inputStorage.readUnsignedByte();
-            log << "[" << message.m_destinationId << "|" << message.m_messageId << "|" << message.m_extra << "] ";
+            log << "[" << message.m_destinationId << "|" << message.m_messageId << "|" << message.m_payloadHandle << "] ";
             log << "RSSI= " << rssi << " SNR= " << snr << " POWER= " << power;
             int remaing = size - 14;
             if (size >= 19) {
@@ -373,7 +384,7 @@ bool Server::applicationMessageReceive() {
             log << "]";
 
         } else {
-            log << "[" << message.m_destinationId << "|" << message.m_messageId << "|" << message.m_extra << "] ";
+            log << "[" << message.m_destinationId << "|" << message.m_messageId << "|" << message.m_payloadHandle << "] ";
             log << "size= " << size << " [";
             for (int tmp = 0; tmp < size; tmp++) {
                 log << (int) m_inputStorage.readChar() << ",";
@@ -407,10 +418,35 @@ bool Server::applicationExecute() {
     } else {
         it->second = 0;
     }
+    if (m_nodeHandler->isParallel()) {
+        // executed with the following CMD_NOTIFY_APP_EXECUTE of the message
+        m_pendingExecutions.push_back(NodeHandler::ApplicationExecution(nodeId));
+        return true;
+    }
+    NodeHandler::ApplicationExecution execution(nodeId);
+    execution.result = m_nodeHandler->applicationExecute(nodeId, execution.data);
+    writeExecuteResult(execution);
+    return true;
+}
+
+void Server::executePending() {
+    if (m_pendingExecutions.empty()) {
+        return;
+    }
+    m_nodeHandler->applicationExecute(m_pendingExecutions);
+    // the answers follow the order of the commands
+    for (std::vector<NodeHandler::ApplicationExecution>::const_iterator it = m_pendingExecutions.begin();
+            it != m_pendingExecutions.end(); ++it) {
+        writeExecuteResult(*it);
+    }
+    m_pendingExecutions.clear();
+}
+
+void Server::writeExecuteResult(const NodeHandler::ApplicationExecution& execution) {
     // create reply message
     writeStatusCmd(CMD_NOTIFY_APP_EXECUTE, APP_RTYPE_OK, "CMD_NOTIFY_APP_EXECUTE");
-    DirectionValueMap data;
-    if (m_nodeHandler->applicationExecute(nodeId, data)) {
+    const DirectionValueMap& data = execution.data;
+    if (execution.result) {
         Storage dataStorage;
         dataStorage.writeUnsignedByte(data.size());
         for (DirectionValueMap::const_iterator dirIt = data.begin(); dirIt != data.end(); ++dirIt) {
@@ -438,7 +474,6 @@ bool Server::applicationExecute() {
         m_outputStorage.writeUnsignedByte(CMD_NOTIFY_APP_EXECUTE);
         m_outputStorage.writeUnsignedByte(APP_RESULT_OFF);
     }
-    return true;
 }
 
 bool Server::trafficLightInformation() {
@@ -450,12 +485,13 @@ bool Server::trafficLightInformation() {
     return true;
 }
 
-bool Server::sumoTraciCommand() {
+bool Server::sumoTraciCommand(int commandEnd) {
     int nodeId = m_inputStorage.readInt();
     int subscriptionId = m_inputStorage.readInt();
     int executionId = m_inputStorage.readInt();
     Storage storage;
-    while (m_inputStorage.valid_pos()) {
+    // the message may carry further commands after this one
+    while (m_inputStorage.valid_pos() && m_inputStorage.position() < commandEnd) {
         storage.writeChar(m_inputStorage.readChar());
     }
     m_nodeHandler->sumoTraciCommandResult(nodeId, executionId, storage);
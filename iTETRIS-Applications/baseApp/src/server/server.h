@@ -68,8 +68,11 @@ private:
     bool applicationMessageReceive();
     bool applicationConfirmSubscription(int commandId);
     bool applicationExecute();
+    /// @brief Executes the nodes of the pending CMD_NOTIFY_APP_EXECUTE and writes their answers
+    void executePending();
+    void writeExecuteResult(const NodeHandler::ApplicationExecution& execution);
     bool trafficLightInformation();
-    bool sumoTraciCommand();
+    bool sumoTraciCommand(int commandEnd);
     bool getReceivedCAMinfo();
 
 private:
@@ -81,6 +84,8 @@ private:
     int m_currentTimeStep;
     NodeHandler* m_nodeHandler;
     std::map<int, int> m_lastSeenNodes;
+    /// @brief Consecutive CMD_NOTIFY_APP_EXECUTE of a message, executed together in parallel mode
+    std::vector<NodeHandler::ApplicationExecution> m_pendingExecutions;
     static const int MAX_NODE_TIMESTEP = 5;
     static int SUMO_STEPLENGTH;
 };
@@ -0,0 +1,154 @@
+/*
+ * This file is part of the iTETRIS Control System (https://github.com/DLR-TS/ics-transaid)
+ * Copyright (c) 2008-2021 iCS development team and contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "thread-pool.h"
+
+namespace baseapp {
+namespace server {
+
+using namespace std;
+
+ThreadPool::ThreadPool(unsigned threads) :
+    m_batch(0), m_stop(false), m_pending(0) {
+    if (threads == 0) {
+        threads = 1;
+    }
+    for (unsigned i = 0; i < threads; ++i) {
+        m_queues.push_back(unique_ptr<TaskQueue>(new TaskQueue()));
+    }
+    // The queue 0 belongs to the thread calling run()
+    for (unsigned i = 1; i < threads; ++i) {
+        m_threads.push_back(thread(&ThreadPool::workerLoop, this, i));
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        lock_guard<mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wakeUp.notify_all();
+    for (vector<thread>::iterator it = m_threads.begin(); it != m_threads.end(); ++it) {
+        it->join();
+    }
+}
+
+void ThreadPool::run(vector<Task>& tasks) {
+    if (tasks.empty()) {
+        return;
+    }
+    if (m_threads.empty()) {
+        for (vector<Task>::iterator it = tasks.begin(); it != tasks.end(); ++it) {
+            (*it)();
+        }
+        return;
+    }
+    {
+        lock_guard<mutex> lock(m_mutex);
+        m_error = nullptr;
+    }
+    // Set before queueing: a thread still looking for work may already take the first tasks
+    m_pending = static_cast<unsigned>(tasks.size());
+    // The tasks are dealt out in turn, the stealing balances the uneven ones
+    for (unsigned i = 0; i < tasks.size(); ++i) {
+        TaskQueue& queue = *m_queues[i % m_queues.size()];
+        lock_guard<mutex> lock(queue.mutex);
+        queue.tasks.push_back(&tasks[i]);
+    }
+    {
+        lock_guard<mutex> lock(m_mutex);
+        ++m_batch;
+    }
+    m_wakeUp.notify_all();
+
+    runTasks(0);
+
+    exception_ptr error;
+    {
+        unique_lock<mutex> lock(m_mutex);
+        m_done.wait(lock, [this] {
+            return m_pending == 0;
+        });
+        error = m_error;
+        m_error = nullptr;
+    }
+    if (error) {
+        rethrow_exception(error);
+    }
+}
+
+void ThreadPool::workerLoop(unsigned index) {
+    unsigned batch = 0;
+    while (true) {
+        {
+            unique_lock<mutex> lock(m_mutex);
+            m_wakeUp.wait(lock, [this, batch] {
+                return m_stop || m_batch != batch;
+            });
+            if (m_stop) {
+                return;
+            }
+            batch = m_batch;
+        }
+        runTasks(index);
+    }
+}
+
+void ThreadPool::runTasks(unsigned index) {
+    Task* task;
+    while (popTask(index, task)) {
+        try {
+            (*task)();
+        } catch (...) {
+            lock_guard<mutex> lock(m_mutex);
+            if (!m_error) {
+                m_error = current_exception();
+            }
+        }
+        if (--m_pending == 0) {
+            // Taking the lock avoids a lost wake-up between the check and the wait of run()
+            lock_guard<mutex> lock(m_mutex);
+            m_done.notify_all();
+        }
+    }
+}
+
+bool ThreadPool::popTask(unsigned index, Task*& task) {
+    {
+        TaskQueue& own = *m_queues[index];
+        lock_guard<mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = own.tasks.back();
+            own.tasks.pop_back();
+            return true;
+        }
+    }
+    for (unsigned i = 1; i < m_queues.size(); ++i) {
+        TaskQueue& victim = *m_queues[(index + i) % m_queues.size()];
+        lock_guard<mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = victim.tasks.front();
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+} /* namespace server */
+} /* namespace baseapp */
@@ -0,0 +1,85 @@
+/*
+ * This file is part of the iTETRIS Control System (https://github.com/DLR-TS/ics-transaid)
+ * Copyright (c) 2008-2021 iCS development team and contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef THREAD_POOL_H_
+#define THREAD_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace baseapp {
+namespace server {
+
+/**
+ * @brief Fixed set of threads running batches of independent tasks.
+ *
+ * Every thread owns a queue of tasks. It takes its own tasks from the back and, when its queue
+ * is empty, steals from the front of the other queues, so that long tasks do not leave the
+ * other threads idle. The thread calling run() takes part in the execution.
+ */
+class ThreadPool {
+public:
+    typedef std::function<void()> Task;
+
+    /// @param[in] threads Number of threads executing the tasks, including the calling one
+    explicit ThreadPool(unsigned threads);
+    ~ThreadPool();
+
+    unsigned size() const {
+        return static_cast<unsigned>(m_queues.size());
+    }
+
+    /// @brief Executes all the tasks and returns when they are done.
+    ///        The first exception thrown by a task is rethrown here.
+    void run(std::vector<Task>& tasks);
+
+private:
+    struct TaskQueue {
+        std::mutex mutex;
+        std::deque<Task*> tasks;
+    };
+
+    void workerLoop(unsigned index);
+    /// @brief Executes tasks until all the queues are empty
+    void runTasks(unsigned index);
+    bool popTask(unsigned index, Task*& task);
+
+    std::vector<std::unique_ptr<TaskQueue> > m_queues;
+    std::vector<std::thread> m_threads;
+
+    std::mutex m_mutex;
+    std::condition_variable m_wakeUp;
+    std::condition_variable m_done;
+    /// @brief Incremented by every run(), wakes up the threads
+    unsigned m_batch;
+    bool m_stop;
+    std::atomic<unsigned> m_pending;
+    std::exception_ptr m_error;
+};
+
+} /* namespace server */
+} /* namespace baseapp */
+
+#endif /* THREAD_POOL_H_ */
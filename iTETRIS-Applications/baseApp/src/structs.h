@@ -176,11 +176,14 @@ struct MobilityInfo {
 struct Message {
     Message() {
         m_destinationId = m_messageId = 0;
+        m_payloadHandle = 0;
         m_snr = NAN;
     }
     int m_destinationId;
     int m_messageId;
     std::string m_extra;
+    // Handle of the payload in the PayloadStorage, decoded from the extra
+    uint64_t m_payloadHandle;
     double m_snr;
 } typedef Message;
 
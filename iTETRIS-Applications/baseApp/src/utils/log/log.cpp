@@ -22,6 +22,7 @@
 #include <time.h>
 #include <cstdlib>
 #include <iomanip>
+#include <mutex>
 #include <sys/time.h>
 #include "log.h"
 
@@ -29,6 +30,8 @@ using namespace std;
 
 Log* Log::m_instance = NULL;
 bool Log::m_logActive = false;
+// The nodes may be executed in parallel, each line is written at once
+static mutex writeMutex;
 
 int Log::StartLog(int type, string path) {
     if (m_instance == NULL) {
@@ -119,6 +122,7 @@ bool Log::Write(const int index, const char* message, const LogLevel messageLogL
 
     ofstream* fs = m_instance->getLog(index);
 
+    lock_guard<mutex> lock(writeMutex);
     if (!fs->good()) {
         return false;
     }
@@ -39,6 +39,8 @@
 #include <cassert>
 #include <algorithm>
 #include <iomanip>
+#include <cstring>
+#include <stdint.h>
 
 using namespace std;
 
@@ -58,11 +60,7 @@ Storage::Storage(const unsigned char packet[], int length) {
         length = sizeof(packet) / sizeof(unsigned char);
     }
 
-    store.reserve(length);
-    // Get the content
-    for (int i = 0; i < length; ++i) {
-        store.push_back(packet[i]);
-    }
+    store.assign(packet, packet + length);
 
     init();
 }
@@ -70,7 +68,7 @@ Storage::Storage(const unsigned char packet[], int length) {
 // ----------------------------------------------------------------------
 void Storage::init() {
     // Initialize local variables
-    iter_ = store.begin();
+    pos_ = 0;
 
     short a = 0x0102;
     unsigned char* p_a = reinterpret_cast<unsigned char*>(&a);
@@ -83,20 +81,26 @@ Storage::~Storage() {
 
 // ----------------------------------------------------------------------
 bool Storage::valid_pos() {
-    return (iter_ != store.end());   // this implies !store.empty()
+    return pos_ < store.size();   // this implies !store.empty()
 }
 
 // ----------------------------------------------------------------------
 unsigned int Storage::position() const {
-    // According to C++ standard std::distance will simply compute the iterators
-    // difference for random access iterators as std::vector provides.
-    return static_cast<unsigned int>(std::distance(store.begin(), iter_));
+    return pos_;
 }
 
 // ----------------------------------------------------------------------
 void Storage::reset() {
+    // clear() keeps the capacity, a reused storage stops allocating once it has grown
     store.clear();
-    iter_ = store.begin();
+    pos_ = 0;
+}
+
+// ----------------------------------------------------------------------
+unsigned char* Storage::prepareReceive(unsigned int length) {
+    store.resize(length);
+    pos_ = 0;
+    return length == 0 ? NULL : &store[0];
 }
 
 // ----------------------------------------------------------------------
@@ -117,7 +121,7 @@ unsigned char Storage::readChar() throw (std::invalid_argument) {
  */
 void Storage::writeChar(unsigned char value) throw () {
     store.push_back(value);
-    iter_ = store.begin();
+    pos_ = 0;
 }
 
 // ----------------------------------------------------------------------
@@ -171,13 +175,30 @@ void Storage::writeUnsignedByte(int value) throw (std::invalid_argument) {
  * @return The read string
  */
 std::string Storage::readString() throw (std::invalid_argument) {
-    int len = readInt();
+    const char* data;
+    unsigned int len;
+    readStringData(data, len);
+    return std::string(data, len);
+}
+
+// -----------------------------------------------------------------------
+void Storage::readString(std::string& value) {
+    const char* data;
+    unsigned int len;
+    readStringData(data, len);
+    value.assign(data, len);
+}
+
+// -----------------------------------------------------------------------
+void Storage::readStringData(const char*& data, unsigned int& length) {
+    const int len = readInt();
+    if (len < 0) {
+        throw std::invalid_argument("Storage::readString(): negative length");
+    }
     checkReadSafe(len);
-    StorageType::const_iterator end = iter_;
-    std::advance(end, len);
-    const string tmp(iter_, end);
-    iter_ = end;
-    return tmp;
+    data = len == 0 ? "" : reinterpret_cast<const char*>(&store[pos_]);
+    length = static_cast<unsigned int>(len);
+    pos_ += length;
 }
 
 // ----------------------------------------------------------------------
@@ -187,8 +208,9 @@ std::string Storage::readString() throw (std::invalid_argument) {
  */
 void Storage::writeString(const std::string& s) throw () {
     writeInt(static_cast<int>(s.length()));
-    store.insert(store.end(), s.begin(), s.end());
-    iter_ = store.begin();
+    if (!s.empty()) {
+        memcpy(grow(static_cast<unsigned int>(s.length())), s.data(), s.length());
+    }
 }
 
 // -----------------------------------------------------------------------
@@ -300,78 +322,152 @@ double Storage::readDouble() throw (std::invalid_argument) {
     return value;
 }
 
+// ----------------------------------------------------------------------
+/**
+ * The arrays are converted with shifts on the 32 bit patterns, which gives the
+ * network order of writeInt/writeFloat without a test of the host endianess.
+ */
+void Storage::readIntArray(int* values, unsigned int count) {
+    checkReadArraySafe(count, 4);
+    if (count == 0) {
+        return;
+    }
+    const unsigned char* src = &store[pos_];
+    for (unsigned int i = 0; i < count; ++i, src += 4) {
+        const uint32_t bits = (uint32_t(src[0]) << 24) | (uint32_t(src[1]) << 16) | (uint32_t(src[2]) << 8) | uint32_t(src[3]);
+        memcpy(&values[i], &bits, 4);
+    }
+    pos_ += 4 * count;
+}
+
+// ----------------------------------------------------------------------
+void Storage::writeIntArray(const int* values, unsigned int count) {
+    if (count == 0) {
+        return;
+    }
+    unsigned char* dst = grow(4 * count);
+    for (unsigned int i = 0; i < count; ++i, dst += 4) {
+        uint32_t bits;
+        memcpy(&bits, &values[i], 4);
+        dst[0] = static_cast<unsigned char>(bits >> 24);
+        dst[1] = static_cast<unsigned char>(bits >> 16);
+        dst[2] = static_cast<unsigned char>(bits >> 8);
+        dst[3] = static_cast<unsigned char>(bits);
+    }
+}
+
+// ----------------------------------------------------------------------
+void Storage::readFloatArray(float* values, unsigned int count) {
+    checkReadArraySafe(count, 4);
+    if (count == 0) {
+        return;
+    }
+    const unsigned char* src = &store[pos_];
+    for (unsigned int i = 0; i < count; ++i, src += 4) {
+        const uint32_t bits = (uint32_t(src[0]) << 24) | (uint32_t(src[1]) << 16) | (uint32_t(src[2]) << 8) | uint32_t(src[3]);
+        memcpy(&values[i], &bits, 4);
+    }
+    pos_ += 4 * count;
+}
+
+// ----------------------------------------------------------------------
+void Storage::writeFloatArray(const float* values, unsigned int count) {
+    if (count == 0) {
+        return;
+    }
+    unsigned char* dst = grow(4 * count);
+    for (unsigned int i = 0; i < count; ++i, dst += 4) {
+        uint32_t bits;
+        memcpy(&bits, &values[i], 4);
+        dst[0] = static_cast<unsigned char>(bits >> 24);
+        dst[1] = static_cast<unsigned char>(bits >> 16);
+        dst[2] = static_cast<unsigned char>(bits >> 8);
+        dst[3] = static_cast<unsigned char>(bits);
+    }
+}
+
 // ----------------------------------------------------------------------
 void Storage::writePacket(unsigned char* packet, int length) {
-    store.insert(store.end(), &(packet[0]), &(packet[length]));
-    iter_ = store.begin();   // reserve() invalidates iterators
+    store.insert(store.end(), packet, packet + length);
+    pos_ = 0;
 }
 
 // ----------------------------------------------------------------------
 void Storage::writePacket(const std::vector<unsigned char>& packet) {
-    std::copy(packet.begin(), packet.end(), std::back_inserter(store));
-    iter_ = store.begin();
+    store.insert(store.end(), packet.begin(), packet.end());
+    pos_ = 0;
 }
 
 // ----------------------------------------------------------------------
 void Storage::writeStorage(const tcpip::Storage& other) {
-    // the compiler cannot deduce to use a const_iterator as source
-    store.insert<StorageType::const_iterator>(store.end(), other.iter_, other.store.end());
-    iter_ = store.begin();
-}
-
-// ----------------------------------------------------------------------
-void Storage::checkReadSafe(unsigned int num) const throw (std::invalid_argument) {
-    int distance;
-    if ((distance = std::distance(iter_, store.end())) < num) {
-        if (distance < 0) {
-            cout << "### distance < 0 " << distance << endl;
-            //sometimes distance return a negative value for no apparent reason..
-            StorageType::const_iterator tmp = iter_;
-            int read = 0;
-            for (; tmp != store.end(); ++tmp) {
-                ++read;
-                if (read >= num) {
-                    return;
-                }
-            }
-        }
+    // only the bytes not yet read from other
+    store.insert(store.end(), other.store.begin() + other.pos_, other.store.end());
+    pos_ = 0;
+}
+
+// ----------------------------------------------------------------------
+void Storage::checkReadSafe(unsigned int num) const {
+    if (num > remaining()) {
         std::ostringstream msg;
         msg << "tcpip::Storage::readIsSafe: want to read " << num << " bytes from Storage, " << "but only "
-            << std::distance(iter_, store.end()) << " remaining";
+            << remaining() << " remaining";
         throw std::invalid_argument(msg.str());
     }
 }
 
+// ----------------------------------------------------------------------
+void Storage::checkReadArraySafe(unsigned int count, unsigned int size) const {
+    // compared by division, count * size may overflow for a malformed count
+    if (count > remaining() / size) {
+        std::ostringstream msg;
+        msg << "tcpip::Storage::readIsSafe: want to read " << count << " elements of " << size
+            << " bytes from Storage, " << "but only " << remaining() << " bytes remaining";
+        throw std::invalid_argument(msg.str());
+    }
+}
+
+// ----------------------------------------------------------------------
+unsigned int Storage::remaining() const {
+    return pos_ < store.size() ? static_cast<unsigned int>(store.size()) - pos_ : 0;
+}
+
 // ----------------------------------------------------------------------
 unsigned char Storage::readCharUnsafe() {
-    char hb = *iter_;
-    ++iter_;
-    return hb;
+    return store[pos_++];
+}
+
+// ----------------------------------------------------------------------
+unsigned char* Storage::grow(unsigned int size) {
+    const StorageType::size_type oldSize = store.size();
+    store.resize(oldSize + size);
+    pos_ = 0;
+    return &store[oldSize];
 }
 
 // ----------------------------------------------------------------------
 void Storage::writeByEndianess(const unsigned char* begin, unsigned int size) {
-    const unsigned char* end = &(begin[size]);
+    unsigned char* dst = grow(size);
     if (bigEndian_) {
-        store.insert(store.end(), begin, end);
-    } else
-        store.insert(store.end(), std::reverse_iterator<const unsigned char*>(end),
-                     std::reverse_iterator<const unsigned char*>(begin));
-    iter_ = store.begin();
+        memcpy(dst, begin, size);
+    } else {
+        for (unsigned int i = 0; i < size; ++i) {
+            dst[i] = begin[size - 1 - i];
+        }
+    }
 }
 
 // ----------------------------------------------------------------------
 void Storage::readByEndianess(unsigned char* array, int size) {
     checkReadSafe(size);
+    const unsigned char* src = &store[pos_];
     if (bigEndian_) {
-        for (int i = 0; i < size; ++i) {
-            array[i] = readCharUnsafe();
-        }
+        memcpy(array, src, size);
     } else {
-        for (int i = size - 1; i >= 0; --i) {
-            array[i] = readCharUnsafe();
+        for (int i = 0; i < size; ++i) {
+            array[i] = src[size - 1 - i];
         }
     }
+    pos_ += size;
 }
 
 // ----------------------------------------------------------------------
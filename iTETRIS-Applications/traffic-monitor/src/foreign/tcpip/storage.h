@@ -57,7 +57,8 @@ public:
 
 private:
     StorageType store;
-    StorageType::const_iterator iter_;
+    /// Read position. Every write moves it back to the beginning of the storage.
+    unsigned int pos_;
 
     // sortation of bytes forwards or backwards?
     bool bigEndian_;
@@ -66,9 +67,15 @@ private:
     void init();
 
     /// Check if the next \p num bytes can be read safely
-    void checkReadSafe(unsigned int num) const throw(std::invalid_argument);
+    void checkReadSafe(unsigned int num) const;
+    /// Check if \p count elements of \p size bytes can be read safely, without overflowing the byte count
+    void checkReadArraySafe(unsigned int count, unsigned int size) const;
+    /// Number of bytes left to read
+    unsigned int remaining() const;
     /// Read a byte \em without validity check
     unsigned char readCharUnsafe();
+    /// Append \p size bytes at the end of the storage and return where they start
+    unsigned char* grow(unsigned int size);
     /// Write \p size elements of array \p begin according to endianess
     void writeByEndianess(const unsigned char* begin, unsigned int size);
     /// Read \p size elements into \p array according to endianess
@@ -89,7 +96,14 @@ public:
     virtual bool valid_pos();
     virtual unsigned int position() const;
 
+    /// Empties the storage. The allocated memory is kept for the next content.
     void reset();
+    /// Makes room for \p size bytes, so that the following writes do not reallocate
+    void reserve(unsigned int size) {
+        store.reserve(size);
+    }
+    /// Empties the storage and returns a buffer of \p length bytes to be filled directly, e.g. by recv
+    unsigned char* prepareReceive(unsigned int length);
     /// Dump storage content as series of hex values
     std::string hexDump() const;
 
@@ -104,6 +118,10 @@ public:
     virtual void writeUnsignedByte(int) throw(std::invalid_argument);
 
     virtual std::string readString() throw(std::invalid_argument);
+    /// Reads a string into \p value, reusing its memory
+    void readString(std::string& value);
+    /// Reads a string without copying it. \p data stays valid until the storage is written or reset.
+    void readStringData(const char*& data, unsigned int& length);
     virtual void writeString(const std::string& s) throw();
 
     virtual std::vector<std::string> readStringList() throw(std::invalid_argument);
@@ -121,6 +139,13 @@ public:
     virtual double readDouble() throw(std::invalid_argument);
     virtual void writeDouble(double) throw();
 
+    /// Bulk versions of readInt/writeInt and readFloat/writeFloat. The bytes are the same as
+    /// \p count single calls, without a length prefix.
+    void readIntArray(int* values, unsigned int count);
+    void writeIntArray(const int* values, unsigned int count);
+    void readFloatArray(float* values, unsigned int count);
+    void writeFloatArray(const float* values, unsigned int count);
+
     virtual void writePacket(unsigned char* packet, int length);
     virtual void writePacket(const std::vector<unsigned char>& packet);
 
@@ -137,6 +162,9 @@ public:
     StorageType::const_iterator end() const {
         return store.end();
     }
+    const unsigned char* data() const {
+        return store.empty() ? NULL : &store[0];
+    }
 
 };
 
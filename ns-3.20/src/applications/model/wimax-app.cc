@@ -354,7 +354,8 @@ WimaxApp::RetrieveInciPacketTagsWimax (Ptr<Packet> packet, Ipv4Address ipAddress
 	    uint32_t timeStep = packetTags->timeStepTag.Get ();
 	    uint32_t timeStepSN = packetTags->tSSeqNTag.Get ();
 	    //TODO check to see if RSSI and SNR may also be integrated
-	    tcpip::Storage *genericTagContainer = new tcpip::Storage(); // alternative if Ptr does not work here
+	    tcpip::Storage& genericTagContainer = m_genericTagContainer;
+	    genericTagContainer.reset();
 
 
 	    NS_LOG_INFO("\n");
@@ -375,7 +376,8 @@ WimaxApp::RetrieveInciPacketTagsWimax (Ptr<Packet> packet, Ipv4Address ipAddress
 	            uint32_t timeStep = packetTags->timeStepTag.Get ();
 	            uint32_t timeStepSN = packetTags->tSSeqNTag.Get ();
 	            //TODO check to see if RSSI and SNR may also be integrated
-	            tcpip::Storage *genericTagContainer = new tcpip::Storage(); // alternative if Ptr does not work here
+	            tcpip::Storage& genericTagContainer = m_genericTagContainer;
+	            genericTagContainer.reset();
 
 
 	            NS_LOG_INFO("\n");
@@ -403,7 +405,8 @@ WimaxApp::RetrieveInciPacketTagsWimax (Ptr<Packet> packet, Ipv4Address ipAddress
 	    uint32_t timeStep = packetTags->timeStepTag.Get ();
 	    uint32_t timeStepSN = packetTags->tSSeqNTag.Get ();
 	    //TODO check to see if RSSI and SNR may also be integrated
-        tcpip::Storage *genericTagContainer = new tcpip::Storage(); // alternative if Ptr does not work here
+        tcpip::Storage& genericTagContainer = m_genericTagContainer;
+        genericTagContainer.reset();
 
 
 	    NS_LOG_INFO("\n");
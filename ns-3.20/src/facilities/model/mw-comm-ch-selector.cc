@@ -146,21 +146,12 @@ MWCOMMchSelector::GetUnicastDisseminationProfile(uint32_t commProfile, uint32_t
     				if(techno == "WaveRsu") {
     					Ptr<LocationTable> locationTable = node->GetObject <LocationTable> ();
 
-    					if (locationTable != NULL)
+    					if (locationTable != NULL && locationTable->GetEntry (destinationId) != 0)
     					{
-    						LocationTable::Table table = locationTable->GetTable ();
-    						for (LocationTable::Table::const_iterator iter = table.begin(); iter < table.end(); iter++)
-    						{
-    							if ((*iter).gnAddr == destinationId)
-    							{
-    								closestNode = node;
-    								closestNodeTechno = techno;
-    								found1 = true;
-    								break;
-
-    							  }
-    						    }
-    						}
+    						closestNode = node;
+    						closestNodeTechno = techno;
+    						found1 = true;
+    					}
     				}
     				else  {
     					Ptr<IpBaseStaMgnt> staMgnt = node->GetObject<IpBaseStaMgnt> ();
@@ -60,33 +60,41 @@ double DistanceInMeters(uint32_t lat2, uint32_t lon2, uint32_t lat1, uint32_t lo
 struct c2cCommonHeader::LongPositionVector getMinDistToDest(Ptr <LocationTable> ntable, Ptr<c2cAddress> daddr)
 {
     struct c2cCommonHeader::LongPositionVector vector;
-    if (ntable->m_Table.size() != 0)
+    const LocationTable::Table& table = ntable->GetTable ();
+    if (table.size() != 0)
     {
     double min = 1000000;
+    double destLat = daddr->GetGeoAreaPos1 ()->lat;
+    double destLon = daddr->GetGeoAreaPos1 ()->lon;
+    const LocationTable::LocTableEntry* best = 0;
 
-     for (uint32_t i = 0; i < (ntable->m_Table.size()); i++)
+     for (LocationTable::Table::const_iterator i = table.begin (); i != table.end (); i++)
        {
-        if (ntable->m_Table[i].is_neigh == true)
+        if (i->is_neigh == true)
         {
-        double distance = CartesianDistance (ntable->m_Table[i].Lat, ntable->m_Table[i].Long, daddr->GetGeoAreaPos1 ()->lat, daddr->GetGeoAreaPos1 ()->lon);
+        double distance = CartesianDistance (i->Lat, i->Long, destLat, destLon);
 
         if(distance < min)
         {
           min = distance;
-          vector.gnAddr = ntable->m_Table[i].gnAddr;
-          vector.Ts = ntable->m_Table[i].Ts;
-          vector.Lat = ntable->m_Table[i].Lat;
-          vector.Long = ntable->m_Table[i].Long;
-          vector.Alt = ntable->m_Table[i].Alt;
-          vector.PosAcc = ntable->m_Table[i].PosAcc;
-          vector.AltAcc = ntable->m_Table[i].AltAcc;
-          vector.Speed = ntable->m_Table[i].Speed;
-          vector.Heading = ntable->m_Table[i].Heading;
-          vector.SpeedAcc = ntable->m_Table[i].SpeedAcc;
-          vector.HeadingAcc = ntable->m_Table[i].HeadingAcc;
+          best = &(*i);
         }
         }
        }
+     if (best != 0)
+       {
+          vector.gnAddr = best->gnAddr;
+          vector.Ts = best->Ts;
+          vector.Lat = best->Lat;
+          vector.Long = best->Long;
+          vector.Alt = best->Alt;
+          vector.PosAcc = best->PosAcc;
+          vector.AltAcc = best->AltAcc;
+          vector.Speed = best->Speed;
+          vector.Heading = best->Heading;
+          vector.SpeedAcc = best->SpeedAcc;
+          vector.HeadingAcc = best->HeadingAcc;
+       }
     }
 
   return vector;
@@ -104,18 +112,12 @@ Ptr<c2cAddress> DirectNeighbour (Ptr <LocationTable> ntable, Ptr<c2cAddress> dad
 
     if (ntable != 0)
     {
-     for (LocationTable::Table::iterator i = ntable->m_Table.begin ();
-       i != ntable->m_Table.end (); i++)
+     const LocationTable::LocTableEntry* entry = ntable->GetEntry (daddr->GetId());
+     if (entry != 0 && entry->is_neigh == true)
        {
-         if (daddr->GetId() == i->gnAddr)
-         {
-            if (i->is_neigh == true)
-            {
-              isdirectneigh = true;
-              result = CreateObject<c2cAddress> ();
-              result->Set (i->gnAddr, i->Lat, i->Long);
-            }
-         }
+         isdirectneigh = true;
+         result = CreateObject<c2cAddress> ();
+         result->Set (entry->gnAddr, entry->Lat, entry->Long);
        }
     }
     if (isdirectneigh == true)
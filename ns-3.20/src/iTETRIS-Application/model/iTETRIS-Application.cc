@@ -211,36 +211,37 @@ void iTETRISApplication::RetrieveInciPacketTags(Ptr<Packet> packet) {
     // iTETRIS Extension for EU FP7 COLOMBO - generic container to transmit ns-3 data to the Application
     //JHNote (04/09/2013): take any other type of Tag that may be of interest for the iCS and Application module and put it in a vector
 
-    tcpip::Storage* genericTagContainer = new tcpip::Storage(); // alternative if Ptr does not work here
+    tcpip::Storage& genericTagContainer = m_genericTagContainer;
+    genericTagContainer.reset();
 
     RSSITag rssiTag;
     uint16_t rssi = -1;
-    genericTagContainer->writeUnsignedByte(TAG_RSSI);
+    genericTagContainer.writeUnsignedByte(TAG_RSSI);
     if (packet->PeekPacketTag(rssiTag)) {
         rssi = rssiTag.Get();
     }
-    genericTagContainer->writeShort((short) rssi);
+    genericTagContainer.writeShort((short) rssi);
 //		genericTagContainer->writeUnsignedByte(TAG_RSSI);
 //		genericTagContainer->writeShort((short) messageId);
 
     SnrTag snrTag;
     double snr = -1.0;
-    genericTagContainer->writeUnsignedByte(TAG_SNR);
+    genericTagContainer.writeUnsignedByte(TAG_SNR);
     if (packet->PeekPacketTag(snrTag)) {
         snr = snrTag.Get();
     }
-    genericTagContainer->writeDouble(snr);
+    genericTagContainer.writeDouble(snr);
 
     TxPowerTag txPower;
     uint8_t power = 0;
-    genericTagContainer->writeUnsignedByte(TAG_TXPOWER);
+    genericTagContainer.writeUnsignedByte(TAG_TXPOWER);
     if (packet->PeekPacketTag(txPower)) {
         power = txPower.Get();
     }
-    genericTagContainer->writeUnsignedByte(power);
+    genericTagContainer.writeUnsignedByte(power);
 
-    genericTagContainer->writeUnsignedByte(TAG_MSGID);
-    genericTagContainer->writeInt(messageId);
+    genericTagContainer.writeUnsignedByte(TAG_MSGID);
+    genericTagContainer.writeInt(messageId);
 
     NS_LOG_INFO("\n");
     NS_LOG_INFO(
@@ -90,7 +90,7 @@ public:
 
     void SetServiceType(std::string servicetype);
     void SetServiceIndex(uint32_t app_index);
-    typedef Callback<bool, uint32_t, std::string, uint32_t, uint32_t, uint32_t, tcpip::Storage*> ReceiveCallback;
+    typedef Callback<bool, uint32_t, std::string, uint32_t, uint32_t, uint32_t, tcpip::Storage&> ReceiveCallback;
     void SetReceiveCallback(iTETRISApplication::ReceiveCallback cb);
     void UnsetReceiveCallback(void);
 
@@ -156,6 +156,7 @@ protected:
     uint32_t m_stepSequenceNumber;
     uint32_t m_app_index;
     iTETRISApplication::ReceiveCallback m_forwardIcs;
+    tcpip::Storage m_genericTagContainer; // reused for every received packet, the receiver copies its content
 
     uint32_t m_messageId;
     uint32_t m_V2XmessageType;
@@ -49,6 +49,7 @@
 #include "ns3/application.h"
 #include "iTETRIS-Results.h"
 #include "ns3/config.h"
+#include "ns3/node-list.h"
 #include <stdio.h>
 #include "ns3/ns3-server.h"
 #include <math.h>
@@ -79,22 +80,43 @@ iTETRISResults::~iTETRISResults() {
 
 }
 
-void iTETRISResults::LogPacketsTx(std::string context, Ptr<const Packet> packet, double distanceTxRx, uint32_t sendernodeId) {
-
-
+uint32_t iTETRISResults::GetNodeIdFromContext(const std::string& context) {
     std::size_t posInit = context.find("/NodeList/");
     std::size_t posEnd = context.find("/DeviceList/");
     std::string strRx = context.substr(posInit + 10, (posEnd - posInit - 10));
-    int nodeRx = std::stoul(strRx);
+    return std::stoul(strRx);
+}
+
+Ptr<MobilityModel> iTETRISResults::GetMobilityModel(uint32_t nodeId) {
+    if (nodeId >= m_mobilityModels.size()) {
+        m_mobilityModels.resize(nodeId + 1);
+    }
+    if (m_mobilityModels[nodeId] == 0 && nodeId < NodeList::GetNNodes()) {
+        m_mobilityModels[nodeId] = NodeList::GetNode(nodeId)->GetObject<MobilityModel>();
+    }
+    return m_mobilityModels[nodeId];
+}
+
+bool iTETRISResults::IsInScenario(const Vector& position) const {
+    return position.x > m_initial_x && position.x < m_end_x && position.y > m_initial_y && position.y < m_end_y;
+}
+
+void iTETRISResults::LogPacketsTx(std::string context, Ptr<const Packet> packet, double distanceTxRx, uint32_t sendernodeId) {
+    LogPacketsTxNode(GetNodeIdFromContext(context), packet, distanceTxRx, sendernodeId);
+}
+
+void iTETRISResults::LogPacketsTxNode(uint32_t nodeRx, Ptr<const Packet> packet, double distanceTxRx, uint32_t sendernodeId) {
 
 
     if (m_TransAIDNodes->GetById(nodeRx) != NULL) {
 
-        Ptr<MobilityModel> modelrx = m_TransAIDNodes->GetById(nodeRx)->GetObject<MobilityModel>();
-        Ptr<MobilityModel> modeltx = m_TransAIDNodes->GetById(sendernodeId)->GetObject<MobilityModel>();
+        Ptr<MobilityModel> modelrx = GetMobilityModel(nodeRx);
+        Ptr<MobilityModel> modeltx = GetMobilityModel(sendernodeId);
+        if (modelrx == 0 || modeltx == 0) {
+            return;
+        }
 
-        if ((modelrx->GetPosition().x > m_initial_x && modelrx->GetPosition().x < m_end_x && modelrx->GetPosition().y > m_initial_y && modelrx->GetPosition().y < m_end_y)
-                && (modeltx->GetPosition().x > m_initial_x && modeltx->GetPosition().x < m_end_x && modeltx->GetPosition().y > m_initial_y && modeltx->GetPosition().y < m_end_y)) {
+        if (IsInScenario(modelrx->GetPosition()) && IsInScenario(modeltx->GetPosition())) {
 
 
             V2XmessageTypeTag v2x_tag;
@@ -131,21 +153,21 @@ void iTETRISResults::LogPacketsTx(std::string context, Ptr<const Packet> packet,
 }
 
 void iTETRISResults::LogPacketsRx(std::string context, Ptr<const Packet> packet, double distanceTxRx, uint32_t sendernodeId) {
+    LogPacketsRxNode(GetNodeIdFromContext(context), packet, distanceTxRx, sendernodeId);
+}
 
-
-    std::size_t posInit = context.find("/NodeList/");
-    std::size_t posEnd = context.find("/DeviceList/");
-    std::string strRx = context.substr(posInit + 10, (posEnd - posInit - 10));
-    int nodeRx = std::stoul(strRx);
+void iTETRISResults::LogPacketsRxNode(uint32_t nodeRx, Ptr<const Packet> packet, double distanceTxRx, uint32_t sendernodeId) {
 
 
     if (m_TransAIDNodes->GetById(nodeRx) != NULL) {
 
-        Ptr<MobilityModel> modelrx = m_TransAIDNodes->GetById(nodeRx)->GetObject<MobilityModel>();
-        Ptr<MobilityModel> modeltx = m_TransAIDNodes->GetById(sendernodeId)->GetObject<MobilityModel>();
+        Ptr<MobilityModel> modelrx = GetMobilityModel(nodeRx);
+        Ptr<MobilityModel> modeltx = GetMobilityModel(sendernodeId);
+        if (modelrx == 0 || modeltx == 0) {
+            return;
+        }
 
-        if ((modelrx->GetPosition().x > m_initial_x && modelrx->GetPosition().x < m_end_x && modelrx->GetPosition().y > m_initial_y && modelrx->GetPosition().y < m_end_y)
-                && (modeltx->GetPosition().x > m_initial_x && modeltx->GetPosition().x < m_end_x && modeltx->GetPosition().y > m_initial_y && modeltx->GetPosition().y < m_end_y)) {
+        if (IsInScenario(modelrx->GetPosition()) && IsInScenario(modeltx->GetPosition())) {
 
             V2XmessageTypeTag v2x_tag;
             packet->PeekPacketTag(v2x_tag);
@@ -298,75 +320,74 @@ void iTETRISResults::LogAwarenessRatio(const NodeContainer& m_NodeContainer) {
 
     m_TransAIDNodes = &m_NodeContainer;
 
-    double distance;
-    int indexAux;
-    bool NodeActive = false;
-    bool NodeActiveRx = false;
+    // Positions of the active nodes inside the scenario borders, bucketed in cells as wide as the metric range
+    // so that the neighbours of a node are always in its own cell or in the 8 surrounding ones
+    std::vector<uint32_t> activeIds;
+    std::vector<Vector> activePositions;
+    std::map<std::pair<int, int>, std::vector<uint32_t> > cells;
 
     NodeContainer::Iterator it;
     for (it = m_NodeContainer.Begin(); it != m_NodeContainer.End(); ++it) {
-        uint32_t nodeId = (*it)->GetId();
-
+        bool NodeActive = true;
         if ((*it)->IsMobileNode()) {
-
             Ptr<VehicleStaMgnt> StaMgnt = (*it)->GetObject<VehicleStaMgnt>();
             NodeActive = StaMgnt->IsNodeActive();
-        } else {
-            NodeActive = true;
+        }
+        if (!NodeActive) {
+            continue;
         }
 
-        if (NodeActive) {
-
-            Ptr<MobilityModel> mobModel = (*it)->GetObject<MobilityModel>();
+        Vector position = (*it)->GetObject<MobilityModel>()->GetPosition();
+        if (position.x > m_initial_x && position.x < m_end_x && position.y > m_initial_y && position.y < m_end_y) { // TODO update the conditions of the border of the scenario
+            std::pair<int, int> cell((int) floor(position.x / METRIC_DISTANCE_RANGE),
+                                     (int) floor(position.y / METRIC_DISTANCE_RANGE));
+            cells[cell].push_back(activeIds.size());
+            activeIds.push_back((*it)->GetId());
+            activePositions.push_back(position);
+        }
+    }
 
-            if (mobModel->GetPosition().x > m_initial_x && mobModel->GetPosition().x < m_end_x && mobModel->GetPosition().y > m_initial_y && mobModel->GetPosition().y < m_end_y) {
-                std::map<int, NARdata>::iterator itNAR;
+    for (uint32_t i = 0; i < activeIds.size(); ++i) {
+        uint32_t nodeId = activeIds[i];
+        const Vector& position = activePositions[i];
 
-                itNAR = m_NARdataMap.find(nodeId);
+        std::map<int, NARdata>::iterator itNAR;
+        itNAR = m_NARdataMap.find(nodeId);
+        if (itNAR == m_NARdataMap.end()) {
+            NARdata NARdataAux = {};
+            itNAR = m_NARdataMap.insert(m_NARdataMap.end(), std::pair<int, NARdata>(nodeId, NARdataAux));
+        }
 
-                if (itNAR == m_NARdataMap.end()) {
-                    NARdata NARdataAux = {};
-                    itNAR = m_NARdataMap.insert(m_NARdataMap.end(), std::pair<int, NARdata>(nodeId, NARdataAux));
+        int cellX = (int) floor(position.x / METRIC_DISTANCE_RANGE);
+        int cellY = (int) floor(position.y / METRIC_DISTANCE_RANGE);
+        for (int dx = -1; dx <= 1; ++dx) {
+            for (int dy = -1; dy <= 1; ++dy) {
+                std::map<std::pair<int, int>, std::vector<uint32_t> >::const_iterator itCell;
+                itCell = cells.find(std::pair<int, int>(cellX + dx, cellY + dy));
+                if (itCell == cells.end()) {
+                    continue;
                 }
-
-                NodeContainer::Iterator it1;
-                for (it1 = m_NodeContainer.Begin(); it1 != m_NodeContainer.End(); ++it1) {
-                    if ((*it1)->IsMobileNode()) {
-
-                        Ptr<VehicleStaMgnt> StaMgntRx = (*it1)->GetObject<VehicleStaMgnt>();
-                        NodeActiveRx = StaMgntRx->IsNodeActive();
-                    } else {
-                        NodeActiveRx = true;
+                for (std::vector<uint32_t>::const_iterator itJ = itCell->second.begin(); itJ != itCell->second.end(); ++itJ) {
+                    uint32_t neighbourId = activeIds[*itJ];
+                    if (nodeId == neighbourId) {
+                        continue;
+                    }
+                    const Vector& position1 = activePositions[*itJ];
+                    double distance = sqrt((position.x - position1.x) * (position.x - position1.x) +
+                                           (position.y - position1.y) * (position.y - position1.y));
+                    if (distance >= METRIC_DISTANCE_RANGE) {
+                        continue;
                     }
 
-                    if ((nodeId != (*it1)->GetId()) && NodeActiveRx) {
-
-                        Ptr<MobilityModel> mobModel1 = (*it1)->GetObject<MobilityModel>();
-
-                        if (mobModel1->GetPosition().x > m_initial_x && mobModel1->GetPosition().x < m_end_x && mobModel1->GetPosition().y > m_initial_y && mobModel1->GetPosition().y < m_end_y) { // TODO update the conditions of the border of the scenario
-
-                            mobModel->GetPosition();
-
-                            distance = sqrt((mobModel->GetPosition().x - mobModel1->GetPosition().x) *
-                                            (mobModel->GetPosition().x - mobModel1->GetPosition().x) +
-                                            (mobModel->GetPosition().y - mobModel1->GetPosition().y) *
-                                            (mobModel->GetPosition().y - mobModel1->GetPosition().y));
-
-
-                            std::map<int, double>::iterator itNARtot;
-                            itNARtot = (*itNAR).second.totalVehicles.find((*it1)->GetId());
-                            if (itNARtot != (*itNAR).second.totalVehicles.end()) {
-                                if ((*itNARtot).second > distance) {
-                                    (*itNARtot).second = distance;
-                                }
-                            } else {
-                                (*itNAR).second.totalVehicles.insert((*itNAR).second.totalVehicles.end(),
-                                                                     std::pair<int, double>((*it1)->GetId(),
-                                                                             distance));
-                            }
-
+                    std::map<int, double>::iterator itNARtot;
+                    itNARtot = (*itNAR).second.totalVehicles.find(neighbourId);
+                    if (itNARtot != (*itNAR).second.totalVehicles.end()) {
+                        if ((*itNARtot).second > distance) {
+                            (*itNARtot).second = distance;
                         }
-
+                    } else {
+                        (*itNAR).second.totalVehicles.insert((*itNAR).second.totalVehicles.end(),
+                                                             std::pair<int, double>(neighbourId, distance));
                     }
                 }
             }
@@ -471,6 +492,10 @@ void iTETRISResults::writeResults() {
         std::map <int, double>::iterator detectedIterator;
 
         for (detectedIterator = (*itNAR).second.detectedVehicles.begin(); detectedIterator != (*itNAR).second.detectedVehicles.end(); ++detectedIterator) {
+            // Same range as the neighbours counted in totalVehicles, so that the last bin does not exceed 1
+            if ((*detectedIterator).second >= METRIC_DISTANCE_RANGE) {
+                continue;
+            }
             int indexAux = std::min(N_LAST_STEP, (int) floor((*detectedIterator).second / 10));
             for (int i = indexAux; i < N_STEPS_METRIC; i++) {
                 ++sum_NAR_detected[i];
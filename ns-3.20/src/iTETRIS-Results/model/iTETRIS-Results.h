@@ -49,12 +49,14 @@
 #include "ns3/storage.h"
 #include "ns3/config.h"
 #include "ns3/node-container.h"
+#include "ns3/mobility-model.h"
 #include <stdio.h>
 #include <fstream>
 #include <iostream>
 #include <fstream>
 #include <string>
 #include <map>
+#include <vector>
 #include "ns3/yans-wifi-helper.h"
 #include "ns3/wifi-module.h"
 #include "ns3/wifi-80211p-helper.h"
@@ -65,6 +67,8 @@ class NodeContainer;
 #define N_STEPS_METRIC 100
 #define N_LAST_STEP 99
 #define N_LAST_DISTANCE_STEP 990
+// Largest distance (m) taken into account by the distance-binned metrics
+#define METRIC_DISTANCE_RANGE (N_STEPS_METRIC * 10)
 
 
 struct PDRdata {
@@ -105,6 +109,9 @@ public:
 
     void LogPacketsTx(std::string context, Ptr<const Packet> packet, double distanceTxRx, uint32_t sendernodeId);
     void LogPacketsRx(std::string context, Ptr<const Packet> packet, double distanceTxRx, uint32_t sendernodeId);
+    // Variants of the trace sinks above to be connected per device with the receiver node ID bound to the callback
+    void LogPacketsTxNode(uint32_t nodeRx, Ptr<const Packet> packet, double distanceTxRx, uint32_t sendernodeId);
+    void LogPacketsRxNode(uint32_t nodeRx, Ptr<const Packet> packet, double distanceTxRx, uint32_t sendernodeId);
     void PhyStateTracer(std::string context, Time start, Time duration, enum WifiPhy::State state);
 
 
@@ -117,6 +124,10 @@ private:
 
     void ResetCounters();
 
+    static uint32_t GetNodeIdFromContext(const std::string& context);
+    Ptr<MobilityModel> GetMobilityModel(uint32_t nodeId);
+    bool IsInScenario(const Vector& position) const;
+
     PDRdata m_PDRdataCAM;
     PDRdata m_PDRdataCPM;
     PDRdata m_PDRdataMCM;
@@ -144,6 +155,9 @@ private:
     int m_end_y;
 
     const NodeContainer* m_TransAIDNodes;
+
+    // Mobility models of the nodes indexed by node ID, filled on first use
+    std::vector<Ptr<MobilityModel> > m_mobilityModels;
 };
 
 } // namespace ns3
@@ -58,6 +58,10 @@ public:
     virtual void Install(NodeContainer container, STACK stack) {};
     virtual void Configure(std::string Filename) {};
     virtual void RelateInstaller(Ptr<CommModuleInstaller> installer) {};
+    /**
+     * @brief Called when a node is deactivated, so that the installer can release the per-node state of the models it created
+     */
+    virtual void NotifyNodeDeactivated(uint32_t nodeId) {};
     virtual ~CommModuleInstaller();
 };
 
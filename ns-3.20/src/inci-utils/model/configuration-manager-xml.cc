@@ -196,6 +196,23 @@ ConfigurationManagerXml::ReadFile(iTETRISNodeManager* nodeManager) {
             xmlFree(value);
         }
 
+        if (std::string((char*)tag) == "nodeRecycling") {
+            xmlChar* value = xmlTextReaderGetAttribute(reader, BAD_CAST "value");
+            if (value == 0) {
+                NS_FATAL_ERROR("Error getting attribute 'value' of element 'nodeRecycling'");
+            }
+            xmlChar* delay = xmlTextReaderGetAttribute(reader, BAD_CAST "delay");
+            double recyclingDelay = 5.0;
+            if (delay != 0) {
+                recyclingDelay = atof((char*)delay);
+                xmlFree(delay);
+            }
+            const bool nodeRecycling = (bool) atoi((char*)value);
+            std::cout << " Parsed nodeRecycling = " << nodeRecycling << " delay = " << recyclingDelay << std::endl;
+            nodeManager->SetNodeRecycling(nodeRecycling, Seconds(recyclingDelay));
+            xmlFree(value);
+        }
+
         if (std::string((char*)tag) == "InitialXlogKPI") {
             xmlChar* cordIniX = xmlTextReaderGetAttribute(reader, BAD_CAST "value");
             if (cordIniX == 0) {
@@ -56,6 +56,13 @@
 #include "ns3/node-container.h"
 #include "ns3/vehicle-sta-mgnt.h"
 #include "ns3/itetris-mobility-model.h"
+#include "ns3/simulator.h"
+#include "ns3/location-table.h"
+#include "ns3/service-management.h"
+#include "ns3/service-list.h"
+#include "ns3/wifi-net-device.h"
+#include "ns3/regular-wifi-mac.h"
+#include <algorithm>
 
 using namespace std;
 
@@ -64,6 +71,8 @@ NS_LOG_COMPONENT_DEFINE("iTETRISNodeManager");
 namespace ns3 {
 
 iTETRISNodeManager::iTETRISNodeManager() :
+    m_nodeRecycling(false),
+    m_recyclingDelay(Seconds(5.0)),
     m_logKPIs(false),
     m_KPIFilePrefix("")
 {}
@@ -99,6 +108,7 @@ void iTETRISNodeManager::CreateItetrisNode(uint32_t numNodes) {
     for (x = 0; x < numNodes; x++) {
         m_iTETRISNodes.Create(1);
         Ptr<Node> singleNode = m_iTETRISNodes.Get(m_iTETRISNodes.GetN() - 1);
+        IndexNode(singleNode);
         NodeContainer singleNodeContainer;
         singleNodeContainer.Add(singleNode);
 
@@ -116,6 +126,7 @@ void iTETRISNodeManager::CreateItetrisNode(uint32_t numNodes) {
 void iTETRISNodeManager::CreateItetrisNode(void) {
     m_iTETRISNodes.Create(1);
     Ptr<Node> singleNode = m_iTETRISNodes.Get(m_iTETRISNodes.GetN() - 1);
+    IndexNode(singleNode);
     NodeContainer singleNodeContainer;
     singleNodeContainer.Add(singleNode);
     vector<Ptr<CommModuleInstaller> >::iterator it;
@@ -126,9 +137,79 @@ void iTETRISNodeManager::CreateItetrisNode(void) {
 }
 
 
+bool iTETRISNodeManager::RecycleItetrisNode(const std::vector<std::string>& commModules, const Vector& position, const float& speed, const float& heading, const std::string& laneId, uint32_t& nodeId) {
+    if (!m_nodeRecycling) {
+        return false;
+    }
+    NodePool::iterator pool = m_nodePool.find(GetModulesKey(commModules));
+    if (pool == m_nodePool.end() || pool->second.empty()) {
+        return false;
+    }
+    const RecycledNode& candidate = pool->second.front();
+    if (candidate.deactivationTime + m_recyclingDelay > Simulator::Now()) {
+        return false;
+    }
+    nodeId = candidate.nodeId;
+    pool->second.pop_front();
+    ResetNode(nodeId);
+    UpdateNodePosition(nodeId, position, speed, heading, laneId);
+    NS_LOG_DEBUG("ns-3 server --> node " << nodeId << " recycled in position= (" << position.x << ", " << position.y << ")");
+    return true;
+}
+
+void iTETRISNodeManager::SetNodeModules(uint32_t nodeId, const std::vector<std::string>& commModules) {
+    if (m_nodeRecycling) {
+        m_nodeModules[nodeId] = GetModulesKey(commModules);
+    }
+}
+
+void iTETRISNodeManager::SetNodeRecycling(bool on, const Time& delay) {
+    m_nodeRecycling = on;
+    m_recyclingDelay = delay;
+}
+
+std::string iTETRISNodeManager::GetModulesKey(const std::vector<std::string>& commModules) const {
+    std::vector<std::string> modules(commModules);
+    std::sort(modules.begin(), modules.end());
+    std::string key;
+    for (std::vector<std::string>::const_iterator it = modules.begin(); it != modules.end(); ++it) {
+        key += *it;
+        key += ";";
+    }
+    return key;
+}
+
+void iTETRISNodeManager::ResetNode(uint32_t nodeId) {
+    Ptr<Node> node = GetItetrisNode(nodeId);
+    Ptr<InciPacketList> packetList = GetInciPacketList(nodeId);
+    if (packetList != NULL) {
+        packetList->Clear();
+    }
+    Ptr<LocationTable> locationTable = node->GetObject<LocationTable> ();
+    if (locationTable != NULL) {
+        locationTable->ClearTable();
+    }
+    Ptr<ServiceManagement> serviceManagement = node->GetObject<ServiceManagement> ();
+    if (serviceManagement != NULL && serviceManagement->GetServiceList() != NULL
+            && serviceManagement->GetServiceList()->GetService("CAM") != NULL) {
+        serviceManagement->DeactivateService("CAM");
+    }
+    for (uint32_t i = 0; i < node->GetNDevices(); ++i) {
+        Ptr<WifiNetDevice> device = DynamicCast<WifiNetDevice> (node->GetDevice(i));
+        if (device == NULL) {
+            continue;
+        }
+        Ptr<RegularWifiMac> mac = DynamicCast<RegularWifiMac> (device->GetMac());
+        if (mac != NULL) {
+            mac->FlushQueues();
+        }
+    }
+}
+
 void iTETRISNodeManager::CreateItetrisTMC(void) {
     m_iTETRISNodes.Create(1);
     Ptr<Node> singleNode = m_iTETRISNodes.Get(m_iTETRISNodes.GetN() - 1);
+    IndexNode(singleNode);
     NodeContainer singleNodeContainer;
     singleNodeContainer.Add(singleNode);
     Ptr<CommModuleInstaller> comInstaller = GetInstaller("TMC");
@@ -232,17 +313,15 @@ iTETRISNodeManager::SetDefaultModule(std::string typeOfModule) {
 
 void
 iTETRISNodeManager::UpdateNodePosition(uint32_t nodeId, Vector position) {
-    Ptr<Node> node = m_iTETRISNodes.GetById(nodeId);
-    Ptr<MobilityModel> mobModel = node->GetObject<MobilityModel> ();
+    Ptr<MobilityModel> mobModel = GetMobilityModel(nodeId);
     mobModel->SetPosition(position);
 }
 
 void
 iTETRISNodeManager::UpdateNodePosition(uint32_t nodeId, const Vector& position, const float& speed, const float& heading, const std::string& laneId) {
-    Ptr<Node> node = m_iTETRISNodes.GetById(nodeId);
-    Ptr<ItetrisMobilityModel> itetrisMobModel = node->GetObject<ItetrisMobilityModel> ();
+    Ptr<MobilityModel> basicMobModel = GetMobilityModel(nodeId);
+    Ptr<ItetrisMobilityModel> itetrisMobModel = DynamicCast<ItetrisMobilityModel> (basicMobModel);
     if (itetrisMobModel == NULL) {
-        Ptr<MobilityModel> basicMobModel = node->GetObject<MobilityModel> ();
         basicMobModel->SetPosition(position);
         return;
     }
@@ -251,9 +330,65 @@ iTETRISNodeManager::UpdateNodePosition(uint32_t nodeId, const Vector& position,
 
 Ptr<Node>
 iTETRISNodeManager::GetItetrisNode(uint32_t nodeId) {
+    NodeIndexEntry* entry = GetNodeIndexEntry(nodeId);
+    if (entry == NULL) {
+        return NULL;
+    }
+    return entry->node;
+}
+
+Ptr<MobilityModel>
+iTETRISNodeManager::GetMobilityModel(uint32_t nodeId) {
+    NodeIndexEntry* entry = GetNodeIndexEntry(nodeId);
+    if (entry == NULL) {
+        return NULL;
+    }
+    // The objects are aggregated by the installers after the node creation, a missing object is looked up again
+    if (entry->mobilityModel == NULL) {
+        entry->mobilityModel = entry->node->GetObject<MobilityModel> ();
+    }
+    return entry->mobilityModel;
+}
 
-    Ptr<Node> node = NULL;
-    return m_iTETRISNodes.GetById(nodeId);
+Ptr<VehicleStaMgnt>
+iTETRISNodeManager::GetVehicleStaMgnt(uint32_t nodeId) {
+    NodeIndexEntry* entry = GetNodeIndexEntry(nodeId);
+    if (entry == NULL) {
+        return NULL;
+    }
+    if (entry->staMgnt == NULL) {
+        entry->staMgnt = entry->node->GetObject<VehicleStaMgnt> ();
+    }
+    return entry->staMgnt;
+}
+
+Ptr<InciPacketList>
+iTETRISNodeManager::GetInciPacketList(uint32_t nodeId) {
+    NodeIndexEntry* entry = GetNodeIndexEntry(nodeId);
+    if (entry == NULL) {
+        return NULL;
+    }
+    if (entry->packetList == NULL) {
+        entry->packetList = entry->node->GetObject<InciPacketList> ();
+    }
+    return entry->packetList;
+}
+
+void
+iTETRISNodeManager::IndexNode(Ptr<Node> node) {
+    uint32_t nodeId = node->GetId();
+    if (nodeId >= m_nodeIndex.size()) {
+        m_nodeIndex.resize(nodeId + 1);
+    }
+    m_nodeIndex[nodeId].node = node;
+}
+
+iTETRISNodeManager::NodeIndexEntry*
+iTETRISNodeManager::GetNodeIndexEntry(uint32_t nodeId) {
+    if (nodeId >= m_nodeIndex.size() || m_nodeIndex[nodeId].node == NULL) {
+        return NULL;
+    }
+    return &m_nodeIndex[nodeId];
 }
 
 Ptr<CommModuleInstaller>
@@ -271,7 +406,7 @@ iTETRISNodeManager::ActivateNode(uint32_t nodeId) {
     Ptr<Node> node = GetItetrisNode(nodeId);
     if (node) {
         if (node->IsMobileNode()) {
-            Ptr<VehicleStaMgnt> staMgnt = node->GetObject<VehicleStaMgnt> ();
+            Ptr<VehicleStaMgnt> staMgnt = GetVehicleStaMgnt(nodeId);
             NS_ASSERT_MSG(staMgnt, "VehicleStaMgnt object not found in the vehicle");
             staMgnt->ActivateNode();
             return true;
@@ -287,9 +422,21 @@ iTETRISNodeManager::DeactivateNode(uint32_t nodeId) {
     Ptr<Node> node = GetItetrisNode(nodeId);
     if (node) {
         if (node->IsMobileNode()) {
-            Ptr<VehicleStaMgnt> staMgnt = node->GetObject<VehicleStaMgnt> ();
+            Ptr<VehicleStaMgnt> staMgnt = GetVehicleStaMgnt(nodeId);
             NS_ASSERT_MSG(staMgnt, "VehicleStaMgnt object not found in the vehicle");
+            if (staMgnt->IsNodeActive()) {
+                std::map<uint32_t, std::string>::iterator modules = m_nodeModules.find(nodeId);
+                if (modules != m_nodeModules.end()) {
+                    RecycledNode recycled;
+                    recycled.nodeId = nodeId;
+                    recycled.deactivationTime = Simulator::Now();
+                    m_nodePool[modules->second].push_back(recycled);
+                }
+            }
             staMgnt->DeactivateNode();
+            for (InstallerContainerList::iterator it = m_itetrisInstallers.begin(); it != m_itetrisInstallers.end(); ++it) {
+                it->second->NotifyNodeDeactivated(nodeId);
+            }
             return true;
         }
     }
@@ -300,7 +447,7 @@ bool iTETRISNodeManager::IsNodeActive(uint32_t nodeId) {
     Ptr<Node> node = GetItetrisNode(nodeId);
     if (node) {
         if (node->IsMobileNode()) {
-            Ptr<VehicleStaMgnt> staMgnt = node->GetObject<VehicleStaMgnt> ();
+            Ptr<VehicleStaMgnt> staMgnt = GetVehicleStaMgnt(nodeId);
             NS_ASSERT_MSG(staMgnt, "VehicleStaMgnt object not found in the vehicle");
             return staMgnt->IsNodeActive();
         }
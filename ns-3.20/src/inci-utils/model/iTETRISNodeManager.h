@@ -45,9 +45,14 @@
 #define ITETRISNODEMANAGER_H
 
 #include "ns3/mobility-model.h"
+#include "ns3/nstime.h"
 #include "comm-module-installer.h"
 #include "ns3/itetris-types.h"
+#include "ns3/vehicle-sta-mgnt.h"
+#include "inci-packet-list.h"
 #include <map>
+#include <deque>
+#include <vector>
 
 namespace ns3 {
 
@@ -71,6 +76,21 @@ public:
     uint32_t CreateItetrisNode(const Vector& position, const float& speed, const float& heading, const std::string& laneId);
     void CreateItetrisTMC(void);
 
+    /**
+     * @brief Reuse a deactivated node with the communication modules 'commModules' and place it in the given position. Returns false if node recycling is off or no node is available
+     */
+    bool RecycleItetrisNode(const std::vector<std::string>& commModules, const Vector& position, const float& speed, const float& heading, const std::string& laneId, uint32_t& nodeId);
+
+    /**
+     * @brief Register the communication modules of a node so that it can be recycled once it is deactivated
+     */
+    void SetNodeModules(uint32_t nodeId, const std::vector<std::string>& commModules);
+
+    /**
+     * @brief Recycle the nodes of departed vehicles. A deactivated node is reused after 'delay', when the state about it kept by the other nodes (e.g. location tables, messages in flight) has expired
+     */
+    void SetNodeRecycling(bool on, const Time& delay);
+
     /**
      * @brief Get all the iTETRIS nodes
      */
@@ -115,6 +135,13 @@ public:
 
     Ptr<Node> GetItetrisNode(uint32_t nodeId);
 
+    /**
+     * @brief Get the objects aggregated to a node. They are cached in the node index so that the per-packet paths skip the aggregation lookups
+     */
+    Ptr<MobilityModel> GetMobilityModel(uint32_t nodeId);
+    Ptr<VehicleStaMgnt> GetVehicleStaMgnt(uint32_t nodeId);
+    Ptr<InciPacketList> GetInciPacketList(uint32_t nodeId);
+
     bool ActivateNode(uint32_t nodeId);
     bool DeactivateNode(uint32_t nodeId);
     bool IsNodeActive(uint32_t nodeId);
@@ -139,6 +166,48 @@ private:
 
     std::string GetEdgeId(std::string laneId);
 
+    typedef struct {
+        Ptr<Node> node;
+        Ptr<MobilityModel> mobilityModel;
+        Ptr<VehicleStaMgnt> staMgnt;
+        Ptr<InciPacketList> packetList;
+    } NodeIndexEntry;
+
+    void IndexNode(Ptr<Node> node);
+    NodeIndexEntry* GetNodeIndexEntry(uint32_t nodeId);
+
+    std::string GetModulesKey(const std::vector<std::string>& commModules) const;
+
+    /**
+     * @brief Clear the state left by the previous vehicle of a recycled node: received packets, location table, CAM transmission and MAC queues. The shadowing links were removed on deactivation
+     */
+    void ResetNode(uint32_t nodeId);
+
+    typedef struct {
+        uint32_t nodeId;
+        Time deactivationTime;
+    } RecycledNode;
+
+    typedef std::map<std::string, std::deque<RecycledNode> > NodePool;
+
+    /**
+     * @brief Deactivated nodes waiting to be recycled, per set of communication modules. Each queue is sorted by deactivation time
+     */
+    NodePool m_nodePool;
+
+    /**
+     * @brief Set of communication modules of the recyclable nodes
+     */
+    std::map<uint32_t, std::string> m_nodeModules;
+
+    bool m_nodeRecycling;
+    Time m_recyclingDelay;
+
+    /**
+     * @brief The iTETRIS nodes indexed by node ID (ns-3 node IDs are dense), filled on node creation. The aggregated objects are cached on first use
+     */
+    std::vector<NodeIndexEntry> m_nodeIndex;
+
     /**
      * @brief Node container with all the iTETRIS nodes
      */
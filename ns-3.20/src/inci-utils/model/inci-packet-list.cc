@@ -59,31 +59,66 @@ TypeId InciPacketList::GetTypeId(void) {
     return tid;
 }
 
+std::set<uint32_t> InciPacketList::m_pendingNodes;
+
 InciPacketList::InciPacketList() {
-    m_position = 0;
+    m_numPackets = 0;
 }
 
 bool InciPacketList::ReceiveFromApplication(uint32_t senderId, std::string msgType, uint32_t ts, uint32_t tsSeqNo,
-        uint32_t messageId, tcpip::Storage* genericTagContainer) {
+        uint32_t messageId, tcpip::Storage& genericTagContainer) {
     NS_LOG_DEBUG("Packet received in InciPacketList");
     NS_LOG_DEBUG("SenderId = " << senderId << " msgType = " << msgType << " ts = " << ts << " tsSeqNo = " << tsSeqNo);
-    InciPacket* newPacket = new InciPacket(senderId, msgType, ts, tsSeqNo, messageId, genericTagContainer);
-    m_packetList.push_back(newPacket);
+    m_packetList.writeInt(senderId);
+    m_packetList.writeInt(messageId);
+    m_packetList.writeString(msgType);
+    m_packetList.writeInt(ts);
+    m_packetList.writeInt(tsSeqNo);
+    m_packetList.writeShort(genericTagContainer.size());
+    m_packetList.writeStorage(genericTagContainer);
+    ++m_numPackets;
+    if (m_node != 0) {
+        m_pendingNodes.insert(m_node->GetId());
+    }
     return false;
 }
 
-bool InciPacketList::GetReceivedPacket(InciPacket& packet) {
-    if (m_packetList.size() == m_position) {
-        m_position = 0;
-        for (std::vector<InciPacket*>::iterator it = m_packetList.begin(); it != m_packetList.end(); ++it) {
-            delete *it;
-        }
-        m_packetList.clear();
+bool InciPacketList::GetReceivedPacket(struct InciPacket::ReceivedInciPacket& packetData) {
+    if (m_numPackets == 0) {
+        m_packetList.reset();
         return false;
-    } else {
-        packet = *(m_packetList[m_position++]);
-        return true;
     }
+    packetData.senderId = m_packetList.readInt();
+    packetData.messageId = m_packetList.readInt();
+    packetData.msgType = m_packetList.readString();
+    packetData.ts = m_packetList.readInt();
+    packetData.tsSeqNo = m_packetList.readInt();
+    // The caller takes the ownership of the tag container
+    int containerSize = m_packetList.readShort();
+    packetData.genericTagContainer = new tcpip::Storage();
+    for (int i = 0; i < containerSize; ++i) {
+        packetData.genericTagContainer->writeChar(m_packetList.readChar());
+    }
+    --m_numPackets;
+    return true;
+}
+
+int InciPacketList::WriteReceivedPackets(tcpip::Storage& storage) {
+    int numPackets = m_numPackets;
+    storage.writeStorage(m_packetList);
+    m_packetList.reset();
+    m_numPackets = 0;
+    return numPackets;
+}
+
+void InciPacketList::Clear() {
+    m_packetList.reset();
+    m_numPackets = 0;
+}
+
+void InciPacketList::TakePendingNodes(std::set<uint32_t>& nodeIds) {
+    nodeIds.clear();
+    nodeIds.swap(m_pendingNodes);
 }
 
 void InciPacketList::DoDispose(void) {
@@ -109,6 +144,6 @@ void InciPacketList::NotifyNewAggregate() {
 }
 
 int InciPacketList::Size() const {
-    return m_packetList.size();
+    return m_numPackets;
 }
 }
@@ -49,12 +49,12 @@
 #include <stdint.h>
 #include <string>
 #include <vector>
+#include <set>
 #include "ns3/storage.h"
+#include "inci-packet.h"
 
 namespace ns3 {
 
-class InciPacket;
-
 /**
  * @class InciPacketList
  * @brief The class InciPacketList stores all the packets that have been received by a node. The InciPacketList is attached to every node.
@@ -65,8 +65,23 @@ public:
     static TypeId GetTypeId(void);
     InciPacketList(void);
     bool ReceiveFromApplication(uint32_t senderId, std::string msgType, uint32_t ts, uint32_t tsSeqNo,
-                                uint32_t messageId, tcpip::Storage* genericTagContainer);
-    bool GetReceivedPacket(InciPacket& packet);
+                                uint32_t messageId, tcpip::Storage& genericTagContainer);
+    bool GetReceivedPacket(struct InciPacket::ReceivedInciPacket& packetData);
+
+    /**
+     * @brief Write all the received packets to 'storage' in the format of CMD_GET_ALL_RECEIVED_MESSAGES and empty the list. Returns the number of packets written
+     */
+    int WriteReceivedPackets(tcpip::Storage& storage);
+
+    /**
+     * @brief Move to 'nodeIds' the IDs of the nodes that have received packets since the last call
+     */
+    static void TakePendingNodes(std::set<uint32_t>& nodeIds);
+
+    /**
+     * @brief Drop the packets that have not been collected yet
+     */
+    void Clear();
 
     void DoDispose(void);
 
@@ -77,9 +92,18 @@ public:
 
 private:
 
-    std::vector<InciPacket*> m_packetList;
+    /**
+     * The received packets are serialized on reception, one record per packet:
+     * senderId (int), messageId (int), msgType (string), ts (int), tsSeqNo (int), tag container size (short), tag container
+     */
+    tcpip::Storage m_packetList;
+    int m_numPackets;
     Ptr<Node> m_node;
-    unsigned m_position;
+
+    /**
+     * IDs of the nodes whose list received packets since the last TakePendingNodes
+     */
+    static std::set<uint32_t> m_pendingNodes;
 
 };
 
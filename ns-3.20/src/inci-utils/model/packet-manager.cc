@@ -113,11 +113,9 @@ bool PacketManager::GetReceivedPacket(uint32_t nodeId, struct InciPacket::Receiv
     bool morePackets = false;
     Ptr<Node> node = m_nodeManager->GetItetrisNode(nodeId);
     if (node != NULL) {
-        Ptr<InciPacketList> packetList = node->GetObject<InciPacketList>();
+        Ptr<InciPacketList> packetList = m_nodeManager->GetInciPacketList(nodeId);
         if (packetList != NULL) {
-            InciPacket packet;
-            morePackets = packetList->GetReceivedPacket(packet);
-            inciPacketData = packet.GetData();
+            morePackets = packetList->GetReceivedPacket(inciPacketData);
         } else {
             NS_LOG_DEBUG("Node with ID " << nodeId << " does not have a PacketList attached");
         }
@@ -131,7 +129,7 @@ bool PacketManager::GetReceivedPacket(uint32_t nodeId, struct InciPacket::Receiv
 int PacketManager::GetNumberOfReceivedPackets(uint32_t nodeId) {
     Ptr<Node> node = m_nodeManager->GetItetrisNode(nodeId);
     if (node != NULL) {
-        Ptr<InciPacketList> packetList = node->GetObject<InciPacketList>();
+        Ptr<InciPacketList> packetList = m_nodeManager->GetInciPacketList(nodeId);
         if (packetList != NULL) {
             return packetList->Size();
         } else {
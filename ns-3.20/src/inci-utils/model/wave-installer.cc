@@ -229,6 +229,18 @@ WaveInstaller::RelateInstaller(Ptr<CommModuleInstaller> installer) {
     NS_LOG_DEBUG("Linking installers in WaveInstaller::RelateInstaller");
 }
 
+/**
+ * @brief WaveInstaller::NotifyNodeDeactivated
+ * @param nodeId
+ */
+
+void
+WaveInstaller::NotifyNodeDeactivated(uint32_t nodeId) {
+    for (std::vector<Ptr<ShadowingModel> >::iterator it = m_shadowingModels.begin(); it != m_shadowingModels.end(); ++it) {
+        (*it)->RemoveNodeLinks(nodeId);
+    }
+}
+
 /**
  * @brief WaveInstaller::SetChannelType
  * @param devices
@@ -348,6 +360,7 @@ WaveInstaller::Configure(std::string filename) {
                     m_shadowingObject.Set(std::string((char*)attribute), StringValue((char*)value));
                     Ptr<ShadowingModel> shadow = m_shadowingObject.Create()->GetObject<ShadowingModel> ();
                     NS_ASSERT(shadow);
+                    m_shadowingModels.push_back(shadow);
                     std::vector<WaveInstaller::AttributesChannel>::iterator it = GetFirstEmptyElement();
                     (*it).name = std::string("ShadowingModel");
                     (*it).value = new PointerValue(shadow);
@@ -62,6 +62,7 @@
 namespace ns3 {
 
 class YansWifiChannel;
+class ShadowingModel;
 class CAMmanageHelper;
 class C2CIPHelper;
 class ServiceListHelper;
@@ -76,6 +77,7 @@ public:
     void Install(NodeContainer container);
     void Configure(std::string filename);
     void RelateInstaller(Ptr<CommModuleInstaller> installer);
+    void NotifyNodeDeactivated(uint32_t nodeId);
     Ptr<YansWifiChannel> GetWaveCch(void);
     Ptr<YansWifiChannel> GetWaveSch(void);
     void CreateAndAggregateObjectFromTypeId(Ptr<Node> node, const std::string typeId);
@@ -112,6 +114,7 @@ protected:
     c2cInterfaceHelper inf;
     ObjectFactory m_visibilityObject;
     ObjectFactory m_shadowingObject;
+    std::vector<Ptr<ShadowingModel> > m_shadowingModels;
     ObjectFactory m_fadingObject;
     bool FADING;
     float m_interferenceRangeV;
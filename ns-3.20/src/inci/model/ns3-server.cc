@@ -53,6 +53,7 @@
 #include <sys/time.h>
 #include "ns3/log.h"
 #include <string>
+#include <set>
 #include "ns3/config.h"
 #include "ns3/iTETRIS-Results.h"
 
@@ -252,6 +253,13 @@ int Ns3Server::dispatchCommand() {
 #endif
             success = UpdateNodePosition2();
             break;
+        case CMD_UPDATENODES2:
+#ifdef _DEBUG
+            log << "ns-3 server --> CMD_UPDATENODES2 received";
+            Log((log.str()).c_str());
+#endif
+            success = UpdateNodePositions2();
+            break;
         case CMD_CREATENODE:
 #ifdef _DEBUG
             log << "ns-3 server --> CMD_CREATENODE received";
@@ -479,7 +487,7 @@ bool Ns3Server::CreateNode(void) {
                      << nodeId
                      << "/DeviceList/*/$ns3::WifiNetDevice/Phy/PhyTxDist";
 
-        Config::Connect(resultString.str(), MakeCallback(&iTETRISResults::LogPacketsTx, my_resultsManager));
+        Config::ConnectWithoutContext(resultString.str(), MakeCallback(&iTETRISResults::LogPacketsTxNode, my_resultsManager).Bind((uint32_t) nodeId));
 
         resultString.str("");
 
@@ -487,7 +495,7 @@ bool Ns3Server::CreateNode(void) {
                      << nodeId
                      << "/DeviceList/*/$ns3::WifiNetDevice/Phy/PhyRxEndDist";
 
-        Config::Connect(resultString.str(), MakeCallback(&iTETRISResults::LogPacketsRx, my_resultsManager));
+        Config::ConnectWithoutContext(resultString.str(), MakeCallback(&iTETRISResults::LogPacketsRxNode, my_resultsManager).Bind((uint32_t) nodeId));
 
 
         resultString.str("");
@@ -523,7 +531,20 @@ bool Ns3Server::CreateNode2(void) {
     vector<string> listOfCommModules = myInputStorage.readStringList();
     vector<string>::iterator moduleIt;
 
+    uint32_t recycledId;
+    if (my_nodeManagerPtr->RecycleItetrisNode(listOfCommModules, pos, speed, heading, laneId, recycledId)) {
+        // The node keeps the communication modules and the KPI traces of its previous vehicle
+        writeStatusCmd(CMD_CREATENODE2, RTYPE_OK, "CreateNode2()");
+
+        myOutputStorage.writeUnsignedByte(1 + 1 + 4);
+        myOutputStorage.writeUnsignedByte(CMD_CREATENODE2);
+        myOutputStorage.writeInt(recycledId);
+
+        return !listOfCommModules.empty();
+    }
+
     int32_t nodeId = my_nodeManagerPtr->CreateItetrisNode(pos, speed, heading, laneId);
+    my_nodeManagerPtr->SetNodeModules(nodeId, listOfCommModules);
 
 #ifdef _DEBUG
     stringstream log;
@@ -553,14 +574,14 @@ bool Ns3Server::CreateNode2(void) {
                      << nodeId
                      << "/DeviceList/*/$ns3::WifiNetDevice/Phy/PhyTxDist";
 
-        Config::Connect(resultString.str(), MakeCallback(&iTETRISResults::LogPacketsTx, my_resultsManager));
+        Config::ConnectWithoutContext(resultString.str(), MakeCallback(&iTETRISResults::LogPacketsTxNode, my_resultsManager).Bind((uint32_t) nodeId));
         resultString.str("");
 
         resultString << "/NodeList/"
                      << nodeId
                      << "/DeviceList/*/$ns3::WifiNetDevice/Phy/PhyRxEndDist";
 
-        Config::Connect(resultString.str(), MakeCallback(&iTETRISResults::LogPacketsRx, my_resultsManager));
+        Config::ConnectWithoutContext(resultString.str(), MakeCallback(&iTETRISResults::LogPacketsRxNode, my_resultsManager).Bind((uint32_t) nodeId));
 
         resultString.str("");
 
@@ -623,6 +644,31 @@ bool Ns3Server::UpdateNodePosition2() {
     return true;
 }
 
+bool Ns3Server::UpdateNodePositions2() {
+    int number = myInputStorage.readInt();
+    for (int i = 0; i < number; ++i) {
+        uint32_t nodeId = myInputStorage.readInt();
+        float x = myInputStorage.readFloat();
+        float y = myInputStorage.readFloat();
+        float speed = myInputStorage.readFloat();
+        float heading = myInputStorage.readFloat();
+        string laneId = myInputStorage.readString();
+        Vector pos = Vector(x, y, 0);
+
+        my_nodeManagerPtr->UpdateNodePosition(nodeId, pos, speed, heading, laneId);
+
+#ifdef _DEBUG
+        stringstream log;
+        log << "ns-3 server --> Node with ID " << nodeId << " has updated its position x=" << x << " y=" << y << endl;
+        Log((log.str()).c_str());
+#endif
+    }
+
+    writeStatusCmd(CMD_UPDATENODES2, RTYPE_OK, "UpdateNodePositions2()");
+
+    return true;
+}
+
 bool Ns3Server::ActivateNode(void) {
     int number = myInputStorage.readInt();
     for (int i = 0; i < number; ++i) {
@@ -829,16 +875,22 @@ bool Ns3Server::GetReceivedMessages() {
 }
 
 bool Ns3Server::GetAllReceivedMessages() {
-    NodeContainer nodeList = my_nodeManagerPtr->GetItetrisNodes();
     tcpip::Storage messageStorage;
     int numNodesWithMessages = 0;
 #ifdef _DEBUG
     std::ostringstream oss;
     oss << "Received messages [";
 #endif
-    for (NodeContainer::Iterator it = nodeList.Begin(); it != nodeList.End(); ++it) {
-        int nodeId = (*it)->GetId();
-        int numMessages = my_packetManagerPtr->GetNumberOfReceivedPackets(nodeId);
+    // Only the nodes that received packets since the last call are visited, in ascending ID order
+    std::set<uint32_t> pendingNodes;
+    InciPacketList::TakePendingNodes(pendingNodes);
+    for (std::set<uint32_t>::const_iterator it = pendingNodes.begin(); it != pendingNodes.end(); ++it) {
+        int nodeId = *it;
+        Ptr<InciPacketList> packetList = my_nodeManagerPtr->GetInciPacketList(nodeId);
+        if (packetList == NULL) {
+            continue;
+        }
+        int numMessages = packetList->Size();
         if (numMessages > 0) {
 #ifdef _DEBUG
             oss << nodeId << ":" << numMessages << ", ";
@@ -846,18 +898,7 @@ bool Ns3Server::GetAllReceivedMessages() {
             ++numNodesWithMessages;
             messageStorage.writeInt(nodeId);
             messageStorage.writeInt(numMessages);
-            InciPacket::ReceivedInciPacket inciPacket;
-            while (my_packetManagerPtr->GetReceivedPacket(nodeId, inciPacket)) {
-                messageStorage.writeInt(inciPacket.senderId);
-                messageStorage.writeInt(inciPacket.messageId);
-                messageStorage.writeString(inciPacket.msgType);
-                messageStorage.writeInt(inciPacket.ts);
-                messageStorage.writeInt(inciPacket.tsSeqNo);
-                messageStorage.writeShort(inciPacket.genericTagContainer->size());
-                messageStorage.writeStorage(*inciPacket.genericTagContainer);
-                //Get memory back
-                delete inciPacket.genericTagContainer;
-            }
+            packetList->WriteReceivedPackets(messageStorage);
         }
     }
 
@@ -132,6 +132,11 @@ private:
      */
     bool UpdateNodePosition2();
 
+    /**
+     * @brief Update position, speed, heading and laneId of a list of nodes, answered with a single status
+     */
+    bool UpdateNodePositions2();
+
     /**
      * @brief Start sending CAM in the nodes indicated in a list of nodes
      */
@@ -45,7 +45,7 @@ TypeId ETSIChannelLoadMonitorMngr::GetTypeId (void)
                        UintegerValue (200),
                        MakeUintegerAccessor (&ETSIChannelLoadMonitorMngr::m_monitorWindow),
                        MakeUintegerChecker<int64_t> (1))
-    .AddAttribute ("MonitorInterval", "The length of the monitoring interval",
+    .AddAttribute ("MonitorInterval", "The length of the monitoring interval (no longer used, the busy time is measured on the PHY state changes)",
                        UintegerValue (10),
                        MakeUintegerAccessor (&ETSIChannelLoadMonitorMngr::m_monitorInterval),
                        MakeUintegerChecker<int64_t> (1))
@@ -54,36 +54,95 @@ TypeId ETSIChannelLoadMonitorMngr::GetTypeId (void)
 }
 
 
+/**
+ * @brief Forwards the state changes of the PHY to the ETSIChannelLoadMonitorMngr
+ */
+class ETSIChannelLoadPhyListener : public WifiPhyListener
+{
+public:
+  ETSIChannelLoadPhyListener (ETSIChannelLoadMonitorMngr *monitor)
+    : m_monitor (monitor)
+  {
+  }
+  virtual ~ETSIChannelLoadPhyListener ()
+  {
+  }
+  virtual void NotifyRxStart (Time duration)
+  {
+    m_monitor->NotifyRxStartNow (duration);
+  }
+  virtual void NotifyRxEndOk (void)
+  {
+    m_monitor->NotifyRxEndNow ();
+  }
+  virtual void NotifyRxEndError (void)
+  {
+    m_monitor->NotifyRxEndNow ();
+  }
+  virtual void NotifyTxStart (Time duration)
+  {
+    m_monitor->NotifyTxStartNow (duration);
+  }
+  virtual void NotifyMaybeCcaBusyStart (Time duration)
+  {
+    m_monitor->NotifyMaybeCcaBusyStartNow (duration);
+  }
+  virtual void NotifySwitchingStart (Time duration)
+  {
+    m_monitor->NotifySwitchingStartNow (duration);
+  }
+private:
+  ETSIChannelLoadMonitorMngr *m_monitor;
+};
+
+/**
+ * @brief Duration of the part of the period [start, end] inside the window [windowStart, windowEnd]
+ */
+static Time
+GetOverlap (Time start, Time end, Time windowStart, Time windowEnd)
+{
+  Time from = Max (start, windowStart);
+  Time to = Min (end, windowEnd);
+  return to > from ? to - from : Seconds (0);
+}
+
+ETSIChannelLoadMonitorMngr::ETSIChannelLoadMonitorMngr ()
+  : m_phyListener (0),
+    m_stopMonitoring (true)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+}
+
 ETSIChannelLoadMonitorMngr::~ETSIChannelLoadMonitorMngr ()
 {
   NS_LOG_FUNCTION_NOARGS ();
+  delete m_phyListener;
+  m_phyListener = 0;
 }
 
 /**
- * @brief ETSIChannelLoadMonitorMngr::Monitor the actual algorithm to measure the channel load
- * @todo check and improve its performance and precision
+ * @brief ETSIChannelLoadMonitorMngr::Monitor the actual algorithm to measure the channel load.
+ * Closes the monitoring windows elapsed since the last call, with the busy time accumulated
+ * from the PHY state changes.
  */
 void
 ETSIChannelLoadMonitorMngr::Monitor() {
-
-    // FIR first order 50% filter
-	if(Simulator::Now().GetMilliSeconds() < m_lastUpdate+m_monitorWindow) {
-
-		m_probe++;
-		Ptr<WifiPhy> netDevicePhy = DynamicCast<WifiNetDevice>(m_netDevice)->GetPhy();
-
-		if((netDevicePhy !=NULL) && netDevicePhy->IsStateBusy()){
-			m_total_busy++;
-		}
+	if (m_stopMonitoring) {
+		return;
 	}
-	else {
-		m_lastUpdate = Simulator::Now().GetMilliSeconds();
+
+	Time now = Simulator::Now();
+	Time window = MilliSeconds(m_monitorWindow);
+	while (now >= m_windowStart + window) {
+		Time windowEnd = m_windowStart + window;
+		Time busy = m_busyTime + GetOverlap(m_busyStart, m_busyEnd, m_windowStart, windowEnd);
+		float busyRatio = busy.GetSeconds() / window.GetSeconds();
 
 		//  Base monitoring channel load
-			m_channelLoad = (float) m_total_busy/m_probe;
+			m_channelLoad = busyRatio;
 
 		// ETSI filter computation
-			m_channelLoad = m_weight*m_previous_channelLoad+(1-m_weight)*((float) m_total_busy/m_probe);
+			m_channelLoad = m_weight*m_previous_channelLoad+(1-m_weight)*busyRatio;
 			m_previous_channelLoad =m_channelLoad;
 		// end of ETSI filter computation
 
@@ -113,24 +172,84 @@ ETSIChannelLoadMonitorMngr::Monitor() {
 			m_channelState= state1;
 		}
 
-		m_probe = 0;
-		m_total_busy = 0;
+		m_busyTime = Seconds(0);
+		m_windowStart = windowEnd;
+	}
+}
+
+/**
+ * @brief Merges the PHY states in the current busy period, after one of them changed at the current time
+ */
+void
+ETSIChannelLoadMonitorMngr::UpdateBusyPeriod() {
+	Time now = Simulator::Now();
+	Time end = Max(Max(m_endTx, m_endRx), Max(m_endCcaBusy, m_endSwitching));
+	if (now >= m_busyEnd) {
+		// The last busy period is over, its part in the current window is accounted
+		m_busyTime += GetOverlap(m_busyStart, m_busyEnd, m_windowStart, now);
+		m_busyStart = now;
+	}
+	m_busyEnd = Max(end, now);
+}
+
+void
+ETSIChannelLoadMonitorMngr::NotifyRxStartNow(Time duration) {
+	if (m_stopMonitoring) {
+		return;
+	}
+	Monitor();
+	m_endRx = Simulator::Now() + duration;
+	UpdateBusyPeriod();
+}
+
+void
+ETSIChannelLoadMonitorMngr::NotifyRxEndNow() {
+	if (m_stopMonitoring) {
+		return;
+	}
+	Monitor();
+	m_endRx = Simulator::Now();
+	UpdateBusyPeriod();
+}
 
-		if(m_stopMonitoring)  // manager has scheduled a stop
-			return;
+void
+ETSIChannelLoadMonitorMngr::NotifyTxStartNow(Time duration) {
+	if (m_stopMonitoring) {
+		return;
 	}
+	Monitor();
+	// A transmission aborts the reception
+	m_endRx = Min(m_endRx, Simulator::Now());
+	m_endTx = Simulator::Now() + duration;
+	UpdateBusyPeriod();
+}
 
-	Time nextTime(MilliSeconds(m_monitorInterval)); // Time till next packet
-	NS_LOG_LOGIC ("nextProbe = " << nextTime);
-	Simulator::Schedule(nextTime, &ChannelLoadMonitorMngr::Monitor, this);
+void
+ETSIChannelLoadMonitorMngr::NotifyMaybeCcaBusyStartNow(Time duration) {
+	if (m_stopMonitoring) {
+		return;
+	}
+	Monitor();
+	m_endCcaBusy = Max(m_endCcaBusy, Simulator::Now() + duration);
+	UpdateBusyPeriod();
+}
 
+void
+ETSIChannelLoadMonitorMngr::NotifySwitchingStartNow(Time duration) {
+	if (m_stopMonitoring) {
+		return;
+	}
+	Monitor();
+	// Switching channel aborts the reception and resets the CCA
+	m_endRx = Min(m_endRx, Simulator::Now());
+	m_endCcaBusy = Min(m_endCcaBusy, Simulator::Now());
+	m_endSwitching = Simulator::Now() + duration;
+	UpdateBusyPeriod();
 }
 
 void
 ETSIChannelLoadMonitorMngr::startMonitoring() {
-	m_lastUpdate = Simulator::Now().GetMilliSeconds();
-	m_probe=0;
-	m_total_busy=0;
+	Time now = Simulator::Now();
 	m_previous_channelLoad=0;
 	m_weight=0.5;
 	m_tmp_probe=0;
@@ -145,13 +264,31 @@ ETSIChannelLoadMonitorMngr::startMonitoring() {
 				m_past_samples.push_back(0);
 			}
 
-	Time nextTime(MilliSeconds (m_monitorInterval)); // Time till next probe
-	NS_LOG_LOGIC ("nextProbe = " << nextTime);
-	Simulator::Schedule(nextTime, &ETSIChannelLoadMonitorMngr::Monitor, this);
+	Ptr<WifiPhy> netDevicePhy = DynamicCast<WifiNetDevice>(m_netDevice)->GetPhy();
+
+	// The PHY may already be busy, until it becomes idle
+	m_windowStart = now;
+	m_busyTime = Seconds(0);
+	m_busyStart = now;
+	m_busyEnd = now;
+	m_endTx = now;
+	m_endRx = now;
+	m_endSwitching = now;
+	m_endCcaBusy = now;
+	if (netDevicePhy != NULL) {
+		m_endCcaBusy = now + netDevicePhy->GetDelayUntilIdle();
+		m_busyEnd = m_endCcaBusy;
+		if (m_phyListener == 0) {
+			m_phyListener = new ETSIChannelLoadPhyListener(this);
+			netDevicePhy->RegisterListener(m_phyListener);
+		}
+	}
+	m_stopMonitoring = false;
 }
 
 void
 ETSIChannelLoadMonitorMngr::stopMonitoring() {
+	Monitor();
 	m_stopMonitoring = true;
 }
 
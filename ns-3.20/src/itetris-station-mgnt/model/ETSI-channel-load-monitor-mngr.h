@@ -34,26 +34,46 @@
 namespace ns3
 {
 
+class ETSIChannelLoadPhyListener;
+
 /**
  * @brief The ETSIChannelLoadMonitorMngr class implementing the ETSI ITS channel load mechanism
+ *
+ * The busy time of the channel is accumulated from the state changes of the PHY, which are
+ * notified by a WifiPhyListener. The monitoring windows are closed lazily, when the load is
+ * queried or when the PHY changes state.
  */
 
 class ETSIChannelLoadMonitorMngr : public ChannelLoadMonitorMngr
 {
   public:
     static TypeId GetTypeId (void);
+    ETSIChannelLoadMonitorMngr();
     virtual ~ETSIChannelLoadMonitorMngr();
     void startMonitoring();
     void stopMonitoring();
     void Monitor();
 
+    void NotifyRxStartNow (Time duration);
+    void NotifyRxEndNow (void);
+    void NotifyTxStartNow (Time duration);
+    void NotifyMaybeCcaBusyStartNow (Time duration);
+    void NotifySwitchingStartNow (Time duration);
 
   protected:
+    void UpdateBusyPeriod (void);
+
     int64_t m_monitorWindow; // the monitoring window duration (1s by default)
-    int64_t m_monitorInterval; // the monitoring interval (10ms by default, ~~slot time for 10MHz ITS-G5)
-    int64_t m_lastUpdate;
-    uint32_t m_probe;
-    uint32_t m_total_busy;
+    int64_t m_monitorInterval; // no longer used, the busy time is measured on the PHY state changes
+    Time m_windowStart;       // start of the current monitoring window
+    Time m_busyTime;          // busy time of the current window, out of the current busy period
+    Time m_busyStart;         // start of the current (or last) busy period
+    Time m_busyEnd;           // expected end of the current (or last) busy period
+    Time m_endTx;             // end of the PHY states, as tracked by the WifiPhyStateHelper
+    Time m_endRx;
+    Time m_endCcaBusy;
+    Time m_endSwitching;
+    ETSIChannelLoadPhyListener *m_phyListener;
     bool m_stopMonitoring;
     float m_previous_channelLoad;
     float m_weight;
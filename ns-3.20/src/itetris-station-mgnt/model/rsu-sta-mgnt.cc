@@ -81,17 +81,14 @@ RsuStaMgnt::GetC2cAddress (uint32_t nodeId) const
       Ptr<LocationTable> locationTable = m_node->GetObject <LocationTable> ();
       if (locationTable != NULL)
 	{
-	  LocationTable::Table table = locationTable->GetTable ();
 	  NS_LOG_INFO ("[RsuStaMgnt::GetC2cAddress] Looking up c2cAdress of node "<< nodeId << " in neighbor table of node " << m_node->GetId ());
-	  for (LocationTable::Table::const_iterator iter = table.begin(); iter < table.end(); iter++)
+	  const LocationTable::LocTableEntry* entry = locationTable->GetEntry (nodeId);
+	  if (entry != 0)
 	    {
-	      if ((*iter).gnAddr == nodeId)
-		{
-		  resAddress = CreateObject<c2cAddress> (); 
-		  NS_LOG_INFO ("Node found with Id "<< nodeId );
-		  resAddress->Set(nodeId, (*iter).Lat, (*iter).Long);
-		  return (resAddress);
-		}
+	      resAddress = CreateObject<c2cAddress> (); 
+	      NS_LOG_INFO ("Node found with Id "<< nodeId );
+	      resAddress->Set(nodeId, entry->Lat, entry->Long);
+	      return (resAddress);
 	    }
 	}
     }
@@ -134,23 +131,20 @@ RsuStaMgnt::GetIpv6Address (uint32_t nodeId) const
 	Ptr<LocationTable> locationTable = m_node->GetObject <LocationTable> ();
 	if (locationTable != NULL)
 	{
-	  LocationTable::Table table = locationTable->GetTable ();
 	  NS_LOG_INFO ("[VehicleStaMgnt::GetIPv6Address] Looking up IPv6Adress of node "<< nodeId << " in neighbor table of node " << m_node->GetId ()<<"\n");
-	  for (LocationTable::Table::const_iterator iter = table.begin(); iter < table.end(); iter++)
+	  const LocationTable::LocTableEntry* entry = locationTable->GetEntry (nodeId);
+	  if (entry != 0)
 	  {
-		  if ((*iter).gnAddr == nodeId)
+		  for (unsigned int i = 0; i< entry->ipAddr.size(); i++)
 		  {
-			  for (unsigned int i = 0; i< (*iter).ipAddr.size(); i++)
+			  //Compare Ipv6 prefixes of location table entries and RSU Ipv6 address.
+			  if(CompareIpv6Prefix(entry->ipAddr[i], m_node->GetObject<Ipv6L3Protocol> ()->GetAddress(1,1).GetAddress(), 64))
 			  {
-				  //Compare Ipv6 prefixes of location table entries and RSU Ipv6 address.
-				  if(CompareIpv6Prefix((*iter).ipAddr[i], m_node->GetObject<Ipv6L3Protocol> ()->GetAddress(1,1).GetAddress(), 64))
-				  {
-					  resAddress = new Ipv6Address ();
-					  uint8_t* addr_buf = (uint8_t*) malloc (16*sizeof (uint8_t));
-					  resAddress->Set((*iter).ipAddr[i].GetBytes2 (addr_buf));
-					  NS_LOG_INFO ("Node found with Id "<< nodeId << " and IPv6 address: "<< *resAddress <<"\n");
-					  return (resAddress);
-				  }
+				  resAddress = new Ipv6Address ();
+				  uint8_t* addr_buf = (uint8_t*) malloc (16*sizeof (uint8_t));
+				  resAddress->Set(entry->ipAddr[i].GetBytes2 (addr_buf));
+				  NS_LOG_INFO ("Node found with Id "<< nodeId << " and IPv6 address: "<< *resAddress <<"\n");
+				  return (resAddress);
 			  }
 		  }
 	    }
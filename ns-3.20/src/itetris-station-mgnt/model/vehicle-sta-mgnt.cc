@@ -152,17 +152,14 @@ VehicleStaMgnt::GetC2cAddress (uint32_t nodeId) const
       Ptr<LocationTable> locationTable = m_node->GetObject <LocationTable> ();
       if (locationTable != NULL)
 	{
-	  LocationTable::Table table = locationTable->GetTable ();
 	  NS_LOG_INFO ("[VehicleStaMgnt::GetC2cAddress] Looking up c2cAdress of node "<< nodeId << " in neighbor table of node " << m_node->GetId ());
-	  for (LocationTable::Table::const_iterator iter = table.begin(); iter < table.end(); iter++)
+	  const LocationTable::LocTableEntry* entry = locationTable->GetEntry (nodeId);
+	  if (entry != 0)
 	    {
-	      if ((*iter).gnAddr == nodeId)
-		{
-		  resAddress = CreateObject<c2cAddress> (); 
-		  NS_LOG_INFO ("Node found with Id "<< nodeId );
-		  resAddress->Set(nodeId, (*iter).Lat, (*iter).Long);
-		  return (resAddress);
-		}
+	      resAddress = CreateObject<c2cAddress> (); 
+	      NS_LOG_INFO ("Node found with Id "<< nodeId );
+	      resAddress->Set(nodeId, entry->Lat, entry->Long);
+	      return (resAddress);
 	    }
 	}
     }    void ActivateNode (void);
@@ -209,19 +206,16 @@ VehicleStaMgnt::GetIpv6Address (uint32_t nodeId) const
      Ptr<LocationTable> locationTable = m_node->GetObject <LocationTable> ();
       if (locationTable != NULL)
 	{
-	  LocationTable::Table table = locationTable->GetTable ();
 	  NS_LOG_INFO ("[VehicleStaMgnt::GetIPv6Address] Looking up IPv6Adress of node "<< nodeId << " in neighbor table of node " << m_node->GetId ()<<"\n");
-	  for (LocationTable::Table::const_iterator iter = table.begin(); iter < table.end(); iter++)
+	  const LocationTable::LocTableEntry* entry = locationTable->GetEntry (nodeId);
+	  if (entry != 0)
 	    {
-	      if ((*iter).gnAddr == nodeId)
-		{
-		  resAddress = new Ipv6Address ();
-                  uint8_t* addr_buf = (uint8_t*) malloc (16*sizeof (uint8_t));
-                  resAddress->Set((*iter).ipAddr[0].GetBytes2 (addr_buf));
-                  //std::cout<<"Inside VehicleStaMgnt::GetIpv6Address!!!"<<resAddress<<std::endl; 
-		  NS_LOG_INFO ("Node found with Id "<< nodeId << " and IPv6 address: "<< *resAddress <<"\n");
-		  return (resAddress);
-		}
+	      resAddress = new Ipv6Address ();
+              uint8_t* addr_buf = (uint8_t*) malloc (16*sizeof (uint8_t));
+              resAddress->Set(entry->ipAddr[0].GetBytes2 (addr_buf));
+              //std::cout<<"Inside VehicleStaMgnt::GetIpv6Address!!!"<<resAddress<<std::endl; 
+	      NS_LOG_INFO ("Node found with Id "<< nodeId << " and IPv6 address: "<< *resAddress <<"\n");
+	      return (resAddress);
 	    }
 	}
     }
@@ -335,7 +329,7 @@ void VehicleStaMgnt::ScanRoadSideUnits (void) const
   Ptr<LocationTable> locationTable = m_node->GetObject <LocationTable> ();
   if (locationTable != NULL)
   {
-  LocationTable::Table table = locationTable->GetTable ();
+  const LocationTable::Table& table = locationTable->GetTable ();
   for (LocationTable::Table::const_iterator iter = table.begin(); iter < table.end(); iter++)
   {
    Ptr<Node> node = NodeList::GetNode ((*iter).gnAddr);
@@ -139,7 +139,13 @@ void LocationTable::AddOwnEntry()
 void LocationTable::AddPosEntry(c2cCommonHeader commonheader)
 {
  //std::cout << "LocationTable::AddPosEntry" << std::endl;
-  bool exist = false;
+  // Nothing to update if the entry of the sender already has this timestamp
+  SlotMap::const_iterator slot = m_slots.find(commonheader.GetSourPosVector().gnAddr);
+  if (slot != m_slots.end() && m_Table[slot->second].Ts == commonheader.GetSourPosVector().Ts)
+  {
+    return;
+  }
+
   struct LocTableEntry entry;
   entry.gnAddr = commonheader.GetSourPosVector().gnAddr;
   entry.Ts = commonheader.GetSourPosVector().Ts;
@@ -164,35 +170,18 @@ void LocationTable::AddPosEntry(c2cCommonHeader commonheader)
   else
     entry.is_neigh = false;
 
-  if (m_Table.size() != 0)
+  if (slot == m_slots.end())
   {
-    for (Table::iterator i = m_Table.begin(); i != m_Table.end(); i++)
-    {
-
-      if (i->gnAddr == entry.gnAddr)
-      {
-        exist = true;
-        if (i->Ts == entry.Ts)
-          return;
-        else
-        {
-          m_Table.erase(i);
-          m_Table.push_back(entry);
-          return;
-        }
-      }
-
-    }
-    if (exist == false)
-      m_Table.push_back(entry);
+    InsertEntry(entry);
   }
   else
-    m_Table.push_back(entry);
+  {
+    UpdateEntry(slot->second, entry);
+  }
 }
 
 void LocationTable::AddPosEntry(struct c2cCommonHeader::LongPositionVector vector)
 {
-  bool exist = false;
   struct LocTableEntry entry;
   entry.gnAddr = vector.gnAddr;
   entry.Ts = vector.Ts;
@@ -207,64 +196,24 @@ void LocationTable::AddPosEntry(struct c2cCommonHeader::LongPositionVector vecto
   entry.HeadingAcc = vector.HeadingAcc;
   entry.is_neigh = false;
 
-  if (m_Table.size() != 0)
+  SlotMap::const_iterator slot = m_slots.find(vector.gnAddr);
+  if (slot != m_slots.end())
   {
-    for (Table::iterator i = m_Table.begin(); i != m_Table.end(); i++)
+    NS_LOG_DEBUG("LOCATION_TABLE: Node " << vector.gnAddr << " is in the table");
+    LocTableEntry& current = m_Table[slot->second];
+    if (current.Ts == vector.Ts)
     {
-
-      if (i->gnAddr == vector.gnAddr)
-      {
-        NS_LOG_DEBUG("LOCATION_TABLE: Node " << vector.gnAddr << " is in the table");
-        exist = true;
-        if (i->Ts == vector.Ts)
-        {
-          NS_LOG_DEBUG(
-              "LOCATION_TABLE: Node " << vector.gnAddr
-                  << " is in the table and I last stored it in this TS. I do not store it again      isneigh= "
-                  << i->is_neigh);
-          return;
-        }
-        else
-        {
-          bool was_neigh = i->is_neigh;
-          m_Table.erase(i);
-          if (was_neigh == true)
-          {
-
-            entry.is_neigh = true;
-            NS_LOG_DEBUG(
-                "LOCATION_TABLE: Node " << vector.gnAddr << " was a neigh so I store it as such          isneigh= "
-                    << entry.is_neigh);
-          }
-          else
-          {
-            NS_LOG_DEBUG(
-                "LOCATION_TABLE: Node " << vector.gnAddr
-                    << " was NOT a neigh so I store it as such              isneigh= " << entry.is_neigh);
-          }
-          m_Table.push_back(entry);
-          return;
-        }
-      }
-    }
-    if (exist == false)
-    {
-      if (vector.gnAddr == m_node->GetId())
-      {
-        entry.is_neigh = true;
-        NS_LOG_DEBUG(
-            "LOCATION_TABLE: Node " << vector.gnAddr
-                << " was not in the table. It is the local node. I store it as a neigh             isneigh= "
-                << entry.is_neigh);
-      }
-      else
-      {
-        NS_LOG_DEBUG(
-            "LOCATION_TABLE: Node " << vector.gnAddr
-                << " was not in the table, I store it as not a neigh             isneigh= " << entry.is_neigh);
-      }
-      m_Table.push_back(entry);
+      NS_LOG_DEBUG(
+          "LOCATION_TABLE: Node " << vector.gnAddr
+              << " is in the table and I last stored it in this TS. I do not store it again      isneigh= "
+              << current.is_neigh);
+      return;
     }
+    // A node that was a neighbour is kept as such
+    entry.is_neigh = current.is_neigh;
+    NS_LOG_DEBUG(
+        "LOCATION_TABLE: Node " << vector.gnAddr << " is stored again            isneigh= " << entry.is_neigh);
+    UpdateEntry(slot->second, entry);
   }
   else
   {
@@ -273,17 +222,16 @@ void LocationTable::AddPosEntry(struct c2cCommonHeader::LongPositionVector vecto
       entry.is_neigh = true;
       NS_LOG_DEBUG(
           "LOCATION_TABLE: Node " << vector.gnAddr
-              << " was not in the table. yhe table was empty. It is the local node. I store it as a neigh             isneigh= "
+              << " was not in the table. It is the local node. I store it as a neigh             isneigh= "
               << entry.is_neigh);
     }
     else
     {
       NS_LOG_DEBUG(
           "LOCATION_TABLE: Node " << vector.gnAddr
-              << " was not in the table (table was empty), I store it as not a neigh              isneigh= "
-              << entry.is_neigh);
+              << " was not in the table, I store it as not a neigh             isneigh= " << entry.is_neigh);
     }
-    m_Table.push_back(entry);
+    InsertEntry(entry);
   }
 }
 
@@ -291,28 +239,62 @@ void LocationTable::CleanTable()
 {
   NS_LOG_FUNCTION(this);
   NS_LOG_INFO("Size " << m_Table.size());
-  Time time = Simulator::Now();
-  double interval;
-  if (m_Table.size() != 0)
+  double now = Simulator::Now().GetSeconds();
+  // The oldest entries come first in the expiry index
+  while (!m_expiry.empty() && now - m_expiry.begin()->first >= LOCATION_ENTRY_LIFETIME)
   {
-    for (Table::iterator i = m_Table.begin(); i != m_Table.end();)
-    {
-      interval = (time.GetSeconds()) - (i->Ts);
-      if (interval >= LOCATION_ENTRY_LIFETIME)
-      {
-        i = m_Table.erase(i);
-      }
-      else
-      {
-        ++i;
-      }
-    }
+    RemoveEntry(m_slots[m_expiry.begin()->second]);
   }
 
   m_updateEvent = Simulator::Schedule(Seconds(LocationTable::LOCATION_ENTRY_LIFETIME), &LocationTable::CleanTable,
       this);
 }
 
+void LocationTable::ClearTable()
+{
+  NS_LOG_FUNCTION(this);
+  for (uint32_t slot = m_Table.size(); slot > 0; slot--)
+  {
+    if (m_node == 0 || m_Table[slot - 1].gnAddr != m_node->GetId())
+    {
+      RemoveEntry(slot - 1);
+    }
+  }
+}
+
+void LocationTable::InsertEntry(const LocTableEntry& entry)
+{
+  m_slots[entry.gnAddr] = m_Table.size();
+  m_Table.push_back(entry);
+  m_expiryPos.push_back(m_expiry.insert(std::make_pair(entry.Ts, entry.gnAddr)));
+}
+
+void LocationTable::UpdateEntry(uint32_t slot, const LocTableEntry& entry)
+{
+  if (m_Table[slot].Ts != entry.Ts)
+  {
+    m_expiry.erase(m_expiryPos[slot]);
+    m_expiryPos[slot] = m_expiry.insert(std::make_pair(entry.Ts, entry.gnAddr));
+  }
+  m_Table[slot] = entry;
+}
+
+void LocationTable::RemoveEntry(uint32_t slot)
+{
+  m_slots.erase(m_Table[slot].gnAddr);
+  m_expiry.erase(m_expiryPos[slot]);
+  uint32_t last = m_Table.size() - 1;
+  if (slot != last)
+  {
+    // Fill the hole with the last entry to keep the table compact
+    m_Table[slot] = m_Table[last];
+    m_expiryPos[slot] = m_expiryPos[last];
+    m_slots[m_Table[slot].gnAddr] = slot;
+  }
+  m_Table.pop_back();
+  m_expiryPos.pop_back();
+}
+
 int LocationTable::GetNbNeighs()
 {
   int nb_neigh = 0;
@@ -329,9 +311,19 @@ int LocationTable::GetNbNeighs()
   return nb_neigh - 1;
 }
 
-LocationTable::Table LocationTable::GetTable()
+const LocationTable::Table& LocationTable::GetTable() const
 {
   return m_Table;
 }
 
+const LocationTable::LocTableEntry* LocationTable::GetEntry(uint64_t gnAddr) const
+{
+  SlotMap::const_iterator slot = m_slots.find(gnAddr);
+  if (slot == m_slots.end())
+  {
+    return 0;
+  }
+  return &m_Table[slot->second];
+}
+
 } //namespace ns3
@@ -33,6 +33,8 @@
 #define LOCATION_TABLE_H
 
 #include <vector>
+#include <map>
+#include "ns3/sgi-hashmap.h"
 
 
 #include "ns3/object.h"
@@ -77,7 +79,6 @@ public:
   };
 
   typedef std::vector<struct LocTableEntry> Table;
-  Table m_Table;
 
 /**
 * Add an entry to the location table when receiving a new beacon
@@ -95,7 +96,18 @@ public:
 */
   void CleanTable();
 
-  Table GetTable();
+/**
+* Remove the entries of the neighbours, e.g. when the node is recycled for a new vehicle
+*/
+  void ClearTable();
+
+  const Table& GetTable() const;
+
+/**
+* Return the entry of the node gnAddr, or 0 if the node is not in the table
+*/
+  const LocTableEntry* GetEntry (uint64_t gnAddr) const;
+
   int GetNbNeighs();
   void SetNode (Ptr<Node> node);
   void NotifyNewAggregate ();
@@ -106,6 +118,35 @@ private:
   EventId m_updateEvent;
   Ptr<Node> m_node;
 
+  /*
+   * The entries are kept compact in m_Table, in no particular order. They are located by address
+   * through m_slots and expire in the order of m_expiry, so that updating the table on every received
+   * packet does not scan it.
+   */
+  Table m_Table;
+
+  struct GnAddrHash
+  {
+    size_t operator() (uint64_t gnAddr) const
+    {
+      return static_cast<size_t> (gnAddr ^ (gnAddr >> 32));
+    }
+  };
+
+  typedef sgi::hash_map<uint64_t, uint32_t, GnAddrHash> SlotMap;
+  typedef std::multimap<uint32_t, uint64_t> ExpiryIndex;
+
+  // Position in m_Table of the entry of each address
+  SlotMap m_slots;
+  // Addresses ordered by the timestamp of their entry
+  ExpiryIndex m_expiry;
+  // Position in m_expiry of each entry of m_Table
+  std::vector<ExpiryIndex::iterator> m_expiryPos;
+
+  void InsertEntry (const LocTableEntry& entry);
+  void UpdateEntry (uint32_t slot, const LocTableEntry& entry);
+  void RemoveEntry (uint32_t slot);
+
   void ScheduleCleanTable();
   void ScheduleUpdatePos();
 };
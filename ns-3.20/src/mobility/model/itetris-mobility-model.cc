@@ -119,6 +119,7 @@ void
 ItetrisMobilityModel::DoSetPosition (const float &latitude, const float &longitude)
 {
   m_helper.InitializePosition (latitude, longitude);
+  NotifyCourseChange ();
 }
 
 Vector
@@ -132,6 +133,7 @@ void
 ItetrisMobilityModel::DoSetPosition (const Vector &position)
 {
   m_helper.InitializePosition (position); 
+  NotifyCourseChange ();
 }
 
 Vector
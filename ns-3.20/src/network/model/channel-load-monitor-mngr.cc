@@ -63,6 +63,7 @@ float
 ChannelLoadMonitorMngr::GetChannelLoad (void)
 {
   NS_LOG_INFO ("Obtaining the locally measured channel load");
+  Monitor ();
   //std::cout<<"ChannelLoadMonitorMngr::getChannelLoad node "<<m_netDevice->GetNode()->GetId()<<" device "<<m_netDevice->GetIfIndex()<<" CL "<<m_channelLoad<<std::endl;
   return (m_channelLoad);
 
@@ -72,6 +73,7 @@ std::string
 ChannelLoadMonitorMngr::GetChannelState (void)
 {
   NS_LOG_INFO ("Obtaining the Channel State based on the locally measured channel load");
+  Monitor ();
   return (m_channelState);
 
 }
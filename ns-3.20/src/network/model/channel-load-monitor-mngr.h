@@ -54,7 +54,7 @@ class ChannelLoadMonitorMngr : public Object
 
      virtual void startMonitoring()=0;
      virtual void stopMonitoring()=0;
-     virtual void Monitor()=0;
+     virtual void Monitor()=0; // updates the channel load and state, called when they are queried
 
   protected:
      Ptr<NetDevice> m_netDevice;
@@ -20,7 +20,7 @@ namespace sgi = std;         // GCC 3.0
 namespace sgi = ::__gnu_cxx;       // GCC 3.1 and later
        #endif
      #else  // gcc 4.x and later
-       #if __GNUC_MINOR__ < 3
+       #if __GNUC__ == 4 && __GNUC_MINOR__ < 3
          #ifdef __clang__
            #undef __DEPRECATED
          #endif
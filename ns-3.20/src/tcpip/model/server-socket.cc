@@ -358,27 +358,26 @@ namespace tcpip
 	// ----------------------------------------------------------------------
 	void 
 		ServerSocket::
-		send( std::vector<unsigned char> b) 
+		send( const std::vector<unsigned char> &b) 
 		throw( SocketException )
 	{
-		if( socket_ < 0 ) return;
+		if( socket_ < 0 || b.empty() ) return;
 
-		size_t numbytes = b.size();
-		unsigned char *buf = new unsigned char[numbytes];
-		unsigned char *buf_ = buf;
+		sendBytes( &b[0], b.size() );
+	}
 
-		for(size_t i = 0; i < numbytes; ++i)
-		{
-			buf[i] = b[i];
-		}
 
+	// ----------------------------------------------------------------------
+	void 
+		ServerSocket::
+		sendBytes( const unsigned char *buf, size_t numbytes )
+	{
 		if (verbose_) 
 		{
 			cerr << "Send " << numbytes << " bytes via tcpip::Socket: [";
 			for(size_t i = 0; i < numbytes; ++i)
 			{
-				buf[i] = b[i];
-				cerr << " " << (int)b[i] << " ";
+				cerr << " " << (int)buf[i] << " ";
 			}
 			cerr << "]" << endl;
 		}
@@ -388,7 +387,7 @@ namespace tcpip
 #ifdef WIN32
 			int n = ::send( socket_, (const char*)buf, static_cast<int>(numbytes), 0 );
 #else
-			int n = ::send( socket_, buf, numbytes, 0 );			
+			int n = ::send( socket_, buf, numbytes, 0 );
 #endif
 			if( n<0 )
 				BailOnSocketError( "send failed" );
@@ -396,8 +395,6 @@ namespace tcpip
 			numbytes -= n;
 			buf += n;
 		}
-
-		delete[] buf_;
 	}
 	
 
@@ -409,14 +406,18 @@ namespace tcpip
 		sendExact( const Storage &b)
 		throw( SocketException )
 	{
-		int length = static_cast<int>(b.size());
-				
-		Storage length_storage;
-		length_storage.writeInt(length + 4);
-		vector<unsigned char> msg;
-		msg.insert(msg.end(), length_storage.begin(), length_storage.end());
-		msg.insert(msg.end(), b.begin(), b.end());
-		send(msg);
+		if( socket_ < 0 ) return;
+
+		const int length = static_cast<int>(b.size()) + 4;
+
+		// Header and message go out in one send, the buffer keeps its capacity between messages
+		sendBuffer_.resize(4 + b.size());
+		sendBuffer_[0] = static_cast<unsigned char>(length >> 24);
+		sendBuffer_[1] = static_cast<unsigned char>(length >> 16);
+		sendBuffer_[2] = static_cast<unsigned char>(length >> 8);
+		sendBuffer_[3] = static_cast<unsigned char>(length);
+		std::copy(b.begin(), b.end(), sendBuffer_.begin() + 4);
+		sendBytes( &sendBuffer_[0], sendBuffer_.size() );
 	}
 
 
@@ -435,17 +436,13 @@ namespace tcpip
 		if( !datawaiting( socket_) )
 			return b;
 
-		unsigned char* buf = new unsigned char[bufSize];
-		int a = recv( socket_, (char*)buf, bufSize, 0 );		
+		b.resize(bufSize);
+		int a = recv( socket_, (char*)&b[0], bufSize, 0 );
 		if( a <= 0 )
 			BailOnSocketError
 			( "tcpip::ServerSocket::receive() @ recv" );
 
 		b.resize(a);
-		for(int i = 0; i < a; ++i)
-		{
-			b[i] = buf[i];
-		}
 
 		if (verbose_) 
 		{
@@ -457,56 +454,45 @@ namespace tcpip
 			cerr << "]" << endl;
 		}
 
-		delete[] buf;
 		return b;
 	}
 
 	// ----------------------------------------------------------------------
-	
-
-	bool
+	void
 		ServerSocket::
-		receiveExact( Storage &msg )
-		throw( SocketException )
+		receiveBytes( unsigned char *buf, int numbytes, const char *where )
 	{
-		/* receive length of vector */
-		unsigned char* bufLength = new unsigned char[4];
 		int bytesRead = 0;
-		int readThisTime = 0;				
-		
-		while (bytesRead<4)
+		while (bytesRead<numbytes)
 		{
-			
-			readThisTime = recv( socket_, (char*)(bufLength + bytesRead), 4-bytesRead, 0 );
-		
+			int readThisTime = recv( socket_, (char*)(buf + bytesRead), numbytes-bytesRead, 0 );
 
 			if( readThisTime <= 0 )
-			BailOnSocketError( "tcpip::ServerSocket::receive() 1 @ recv" );
+				BailOnSocketError( where );
 
 			bytesRead += readThisTime;
 		}
+	}
 
-		Storage length_storage(bufLength,4);
-		int NN = length_storage.readInt() - 4;
-						
-		/* receive vector */
-		unsigned char* buf = new unsigned char[NN];
-		bytesRead = 0;
-		readThisTime = 0;
-		
-		while (bytesRead<NN)
-		{
-			readThisTime = recv( socket_, (char*)(buf + bytesRead), NN-bytesRead, 0 );
+	// ----------------------------------------------------------------------
+	
 
-			if( readThisTime <= 0 )
-				BailOnSocketError( "tcpip::ServerSocket::receive() 2 @ recv" );
+	bool
+		ServerSocket::
+		receiveExact( Storage &msg )
+		throw( SocketException )
+	{
+		/* receive length of vector */
+		unsigned char bufLength[4];
+		receiveBytes( bufLength, 4, "tcpip::ServerSocket::receive() 1 @ recv" );
+		const int NN = ((bufLength[0] << 24) | (bufLength[1] << 16) | (bufLength[2] << 8) | bufLength[3]) - 4;
+		if( NN < 0 )
+			throw SocketException( "tcpip::ServerSocket::receive(): invalid message length" );
 
-			bytesRead += readThisTime;
-		}
-		msg.reset();
-		msg.writePacket(buf, NN);
+		/* receive vector directly into the storage, which keeps its memory from the previous message */
+		unsigned char* buf = msg.prepareReceive(NN);
+		receiveBytes( buf, NN, "tcpip::ServerSocket::receive() 2 @ recv" );
 
-		
 		if (verbose_)
 		{
 			cerr << "Rcvd Storage with "  << 4 + NN <<  " bytes via tcpip::Socket: [";
@@ -521,8 +507,6 @@ namespace tcpip
 			cerr << "]" << endl;
 		}
 
-		delete[] buf;
-		delete[] bufLength;
 		return true;
 	}
 	
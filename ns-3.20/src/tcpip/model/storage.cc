@@ -15,6 +15,9 @@
 #ifdef BUILD_TCPIP
 
 #include <iostream>
+#include <sstream>
+#include <cstring>
+#include <stdint.h>
 
 using namespace std;
 
@@ -32,10 +35,8 @@ namespace tcpip
 	{
 		// Length is calculated, if -1, or given
 		if (length == -1) length = sizeof(packet) / sizeof(unsigned char);
-		
-		store.reserve(length);
-		// Get the content
-		for(int i = 0; i < length; ++i) store.push_back(packet[i]);
+
+		store.assign(packet, packet + length);
 
 		init();
 	}
@@ -46,8 +47,6 @@ namespace tcpip
 	{
 		// Initialize local variables
 		pos_=0;
-		iterValid_ = iterEndValid_ = false;
-		valid_pos();
 
         short a = 0x0102;
         unsigned char *p_a = reinterpret_cast<unsigned char*>(&a);
@@ -61,47 +60,92 @@ namespace tcpip
 	// ----------------------------------------------------------------------
 	bool Storage::valid_pos()
 	{
-		if (size() == 0) return false;
+		return pos_ < store.size(); // this implies !store.empty()
+	}
+
+	// ----------------------------------------------------------------------
+	unsigned int Storage::position() const
+	{
+		return pos_;
+	}
+
+	// ----------------------------------------------------------------------
+	void Storage::reset()
+	{
+		// clear() keeps the capacity, a reused storage stops allocating once it has grown
+		store.clear();
+		pos_=0;
+	}
+
+	// ----------------------------------------------------------------------
+	unsigned char* Storage::prepareReceive(unsigned int length)
+	{
+		store.resize(length);
+		pos_=0;
+		return length == 0 ? 0 : &store[0];
+	}
 
-		// Check iterator iterEnd_ for validity
-		if ( !iterEndValid_ )
+	// ----------------------------------------------------------------------
+	void Storage::checkReadSafe(unsigned int num) const
+	{
+		const unsigned int remaining = static_cast<unsigned int>(store.size()) - pos_;
+		if (num > remaining)
 		{
-			iterEnd_ = store.end();
-			iterEndValid_ = true;
+			std::ostringstream msg;
+			msg << "tcpip::Storage::readIsSafe: want to read " << num << " bytes from Storage, "
+				<< "but only " << remaining << " remaining";
+			throw std::invalid_argument(msg.str());
 		}
+	}
 
-		// Check Iterator iter_ for validity
-		if ( !iterValid_ ) 
+	// ----------------------------------------------------------------------
+	void Storage::checkReadArraySafe(unsigned int count, unsigned int size) const
+	{
+		// compared by division, count * size may overflow for a malformed count
+		const unsigned int remaining = static_cast<unsigned int>(store.size()) - pos_;
+		if (count > remaining / size)
 		{
-			iter_ = store.begin();
-			unsigned int i = 0;
-			while ( i < pos_ 
-				&& iter_ != iterEnd_)
-			{
-				++i;
-				++iter_;
-			}
-			iterValid_ = true;
+			std::ostringstream msg;
+			msg << "tcpip::Storage::readIsSafe: want to read " << count << " elements of " << size
+				<< " bytes from Storage, but only " << remaining << " bytes remaining";
+			throw std::invalid_argument(msg.str());
 		}
+	}
 
-		return (iter_ != iterEnd_);
+	// ----------------------------------------------------------------------
+	unsigned char* Storage::grow(unsigned int size)
+	{
+		const StorageType::size_type oldSize = store.size();
+		store.resize(oldSize + size);
+		return &store[oldSize];
 	}
 
 	// ----------------------------------------------------------------------
-	unsigned int Storage::position() const
+	void Storage::writeByEndianess(const unsigned char* begin, unsigned int size)
 	{
-		// pos_ contains everytime the correct position, 
-		// even if iterValid == false
-		return pos_;
+		unsigned char* dst = grow(size);
+		if (bigEndian_)
+		{
+			// network is big endian
+			memcpy(dst, begin, size);
+		} else {
+			for (unsigned int i = 0; i < size; ++i) dst[i] = begin[size - 1 - i];
+		}
 	}
 
 	// ----------------------------------------------------------------------
-	void Storage::reset()
+	void Storage::readByEndianess(unsigned char* array, unsigned int size)
 	{
-		store.clear();
-		pos_=0;
-		iterValid_ = false;
-		iterEndValid_ = false;
+		checkReadSafe(size);
+		const unsigned char* src = &store[pos_];
+		if (bigEndian_)
+		{
+			// network is big endian
+			memcpy(array, src, size);
+		} else {
+			for (unsigned int i = 0; i < size; ++i) array[i] = src[size - 1 - i];
+		}
+		pos_ += size;
 	}
 
 	// ----------------------------------------------------------------------
@@ -115,10 +159,7 @@ namespace tcpip
 		{
 			throw std::invalid_argument("Storage::readChar(): invalid position");
 		}
-		char hb = *iter_;
-		++iter_;
-		++pos_;
-		return hb;
+		return store[pos_++];
 	}
 
 	// ----------------------------------------------------------------------
@@ -185,12 +226,33 @@ namespace tcpip
 	*/
 	std::string Storage::readString() throw(std::invalid_argument)
 	{
-		string tmp;
-		int len = readInt();
-        for (int i = 0; i < len; i++) {
-			tmp += (char) readChar();
-        }
-		return tmp;
+		const char* data;
+		unsigned int len;
+		readStringData(data, len);
+		return std::string(data, len);
+	}
+
+	// -----------------------------------------------------------------------
+	void Storage::readString(std::string& value)
+	{
+		const char* data;
+		unsigned int len;
+		readStringData(data, len);
+		value.assign(data, len);
+	}
+
+	// -----------------------------------------------------------------------
+	void Storage::readStringData(const char*& data, unsigned int& length)
+	{
+		const int len = readInt();
+		if (len < 0)
+		{
+			throw std::invalid_argument("Storage::readString(): negative length");
+		}
+		checkReadSafe(len);
+		data = len == 0 ? "" : reinterpret_cast<const char*>(&store[pos_]);
+		length = static_cast<unsigned int>(len);
+		pos_ += length;
 	}
 
 	// ----------------------------------------------------------------------
@@ -198,12 +260,10 @@ namespace tcpip
 	* Writes a string into the array;
 	* @param s		The string to be written
 	*/
-	void Storage::writeString(std::string s) throw()
+	void Storage::writeString(const std::string& s) throw()
 	{
 		writeInt(static_cast<int>(s.length()));
-        for (string::iterator it = s.begin(); it!=s.end() ; it++) {
-			writeChar(*it);
-        }
+		if (!s.empty()) memcpy(grow(static_cast<unsigned int>(s.length())), s.data(), s.length());
 	}
 
 	// -----------------------------------------------------------------------
@@ -225,13 +285,13 @@ namespace tcpip
 	* Reads a int list form the array
 	* @return The read int list
 	*/
-        std::vector<int> Storage::readIntList() throw(std::invalid_argument)
+	std::vector<int> Storage::readIntList() throw(std::invalid_argument)
 	{
-	std::vector<int> tmp;
-	int len = readInt();
-        for (int i = 0; i < len; i++) {
-            tmp.push_back(readInt());
-        }
+		int len = readInt();
+		if (len < 0) throw std::invalid_argument("Storage::readIntList(): negative length");
+		checkReadArraySafe(len, 4);
+		std::vector<int> tmp(len);
+		if (len > 0) readIntArray(&tmp[0], len);
 		return tmp;
 	}
 
@@ -239,13 +299,13 @@ namespace tcpip
 	* Reads a float list form the array
 	* @return The read float list
 	*/
-        std::vector<float> Storage::readFloatList() throw(std::invalid_argument)
+	std::vector<float> Storage::readFloatList() throw(std::invalid_argument)
 	{
-	std::vector<float> tmp;
-	int len = readInt();
-        for (int i = 0; i < len; i++) {
-            tmp.push_back(readFloat());
-        }
+		int len = readInt();
+		if (len < 0) throw std::invalid_argument("Storage::readFloatList(): negative length");
+		checkReadArraySafe(len, 4);
+		std::vector<float> tmp(len);
+		if (len > 0) readFloatArray(&tmp[0], len);
 		return tmp;
 	}
 
@@ -269,9 +329,7 @@ namespace tcpip
 	void Storage::writeIntList(const std::vector<int> &s) throw()
 	{
 		writeInt(static_cast<int>(s.size()));
-        for (std::vector<int>::const_iterator it = s.begin(); it!=s.end() ; it++) {
-			writeInt(*it);
-        }
+		if (!s.empty()) writeIntArray(&s[0], static_cast<unsigned int>(s.size()));
 	}
 
 	/**
@@ -281,9 +339,7 @@ namespace tcpip
 	void Storage::writeFloatList(const std::vector<float> &s) throw()
 	{
 		writeInt(static_cast<int>(s.size()));
-        for (std::vector<float>::const_iterator it = s.begin(); it!=s.end() ; it++) {
-			writeFloat(*it);
-        }
+		if (!s.empty()) writeFloatArray(&s[0], static_cast<unsigned int>(s.size()));
 	}
 
 	// ----------------------------------------------------------------------
@@ -296,20 +352,10 @@ namespace tcpip
 	*/
 	int Storage::readShort() throw(std::invalid_argument)
 	{
-                short value = 0;
-                unsigned char *p_value = reinterpret_cast<unsigned char*>(&value);
-                if (bigEndian_)
-                {
-                        // network is big endian
-                        p_value[0] = readChar();
-                        p_value[1] = readChar();
-                } else {
-                        // network is big endian
-                        p_value[1] = readChar();
-                        p_value[0] = readChar();
-                }
-                return value;
-        }
+		short value = 0;
+		readByEndianess(reinterpret_cast<unsigned char*>(&value), 2);
+		return value;
+	}
 
 	// ----------------------------------------------------------------------
 	void Storage::writeShort( int value ) throw(std::invalid_argument)
@@ -320,19 +366,7 @@ namespace tcpip
 		}
 
 		short svalue = static_cast<short>(value);
-		//assert(svalue == value);
-
-                unsigned char *p_svalue = reinterpret_cast<unsigned char*>(&svalue);
-                if (bigEndian_)
-                {
-                        // network is big endian
-                        writeChar(p_svalue[0]);
-                        writeChar(p_svalue[1]);
-                } else {
-                       // network is big endian
-                       writeChar(p_svalue[1]);
-                       writeChar(p_svalue[0]);
-                }
+		writeByEndianess(reinterpret_cast<unsigned char*>(&svalue), 2);
 	}
 
 	// ----------------------------------------------------------------------
@@ -346,43 +380,15 @@ namespace tcpip
 	*/
 	int Storage::readInt() throw(std::invalid_argument)
 	{
-                int value = 0;
-                unsigned char *p_value = reinterpret_cast<unsigned char*>(&value);
-                if (bigEndian_)
-                {
-                        // network is big endian
-                        p_value[0] = readChar();
-                        p_value[1] = readChar();
-                        p_value[2] = readChar();
-                        p_value[3] = readChar();
-                } else {
-                        // network is big endian
-                        p_value[3] = readChar();
-                        p_value[2] = readChar();
-                        p_value[1] = readChar();
-                        p_value[0] = readChar();
-                }
-                return value;
+		int value = 0;
+		readByEndianess(reinterpret_cast<unsigned char*>(&value), 4);
+		return value;
 	}
 
 	// ----------------------------------------------------------------------
 	void Storage::writeInt( int value ) throw()
 	{
-                unsigned char *p_value = reinterpret_cast<unsigned char*>(&value);
-                if (bigEndian_)
-                {
-                        // network is big endian
-                        writeChar(p_value[0]);
-                        writeChar(p_value[1]);
-                        writeChar(p_value[2]);
-                        writeChar(p_value[3]);
-                } else {
-                        // network is big endian
-                        writeChar(p_value[3]);
-                        writeChar(p_value[2]);
-                        writeChar(p_value[1]);
-                        writeChar(p_value[0]);
-                }
+		writeByEndianess(reinterpret_cast<unsigned char*>(&value), 4);
 	}
 
 	// ----------------------------------------------------------------------
@@ -396,102 +402,109 @@ namespace tcpip
 	*/
 	float Storage::readFloat() throw(std::invalid_argument)
 	{
-                float value = 0;
-                unsigned char *p_value = reinterpret_cast<unsigned char*>(&value);
-                if (bigEndian_)
-                {
-                        // network is big endian
-                        p_value[0] = readChar();
-                        p_value[1] = readChar();
-                        p_value[2] = readChar();
-                        p_value[3] = readChar();
-                } else {
-                        // network is big endian
-                        p_value[3] = readChar();
-                        p_value[2] = readChar();
-                        p_value[1] = readChar();
-                        p_value[0] = readChar();
-                }
+		float value = 0;
+		readByEndianess(reinterpret_cast<unsigned char*>(&value), 4);
+		return value;
+	}
 
-        return value;
+	// ----------------------------------------------------------------------
+	void Storage::writeFloat( float value ) throw()
+	{
+		writeByEndianess(reinterpret_cast<unsigned char*>(&value), 4);
+	}
 
+	// ----------------------------------------------------------------------
+	void Storage::writeDouble( double value ) throw ()
+	{
+		writeByEndianess(reinterpret_cast<unsigned char*>(&value), 8);
 	}
 
 	// ----------------------------------------------------------------------
-	void Storage::writeFloat( float value ) throw()
+	double Storage::readDouble( ) throw (std::invalid_argument)
 	{
-                unsigned char *p_value = reinterpret_cast<unsigned char*>(&value);
-                if (bigEndian_)
-                {
-                        // network is big endian
-                        writeChar(p_value[0]);
-                        writeChar(p_value[1]);
-                        writeChar(p_value[2]);
-                        writeChar(p_value[3]);
-                } else {
-                        // network is big endian
-                        writeChar(p_value[3]);
-                        writeChar(p_value[2]);
-                        writeChar(p_value[1]);
-                        writeChar(p_value[0]);
-                }
-        }
-        // ----------------------------------------------------------------------
-        void Storage::writeDouble( double value ) throw ()
-	{
-                unsigned char *p_value = reinterpret_cast<unsigned char*>(&value);
-                if (bigEndian_)
-                {
-                        // network is big endian
-                        for (int i=0; i<8; ++i)
-			{
-                                writeChar(p_value[i]);
-                        }
-                } else {
-                        // network is big endian
-                        for (int i=7; i>=0; --i)
-	                {
-                                writeChar(p_value[i]);
-                        }
-                }
-        }
+		double value = 0;
+		readByEndianess(reinterpret_cast<unsigned char*>(&value), 8);
+		return value;
+	}
 
-        // ----------------------------------------------------------------------
-        double Storage::readDouble( ) throw (std::invalid_argument)
-	{
-                double value = 0;
-                unsigned char *p_value = reinterpret_cast<unsigned char*>(&value);
-                if (bigEndian_)
-                {
-                        // network is big endian
-                        for (int i=0; i<8; ++i)
-		        {
-                                p_value[i] = readChar();
-                        }
-                } else {
-                        // network is big endian
-                        for (int i=7; i>=0; --i) {
-                                p_value[i] = readChar();
-                        }
-                }
-                return value;
-        }
+	// ----------------------------------------------------------------------
+	/*
+	* The arrays are converted with shifts on the 32 bit patterns, which gives
+	* the network order of writeInt/writeFloat without a test of the host endianess.
+	*/
+	void Storage::readIntArray(int* values, unsigned int count)
+	{
+		checkReadArraySafe(count, 4);
+		if (count == 0) return;
+		const unsigned char* src = &store[pos_];
+		for (unsigned int i = 0; i < count; ++i, src += 4)
+		{
+			const uint32_t bits = (uint32_t(src[0]) << 24) | (uint32_t(src[1]) << 16) | (uint32_t(src[2]) << 8) | uint32_t(src[3]);
+			memcpy(&values[i], &bits, 4);
+		}
+		pos_ += 4 * count;
+	}
+
+	// ----------------------------------------------------------------------
+	void Storage::writeIntArray(const int* values, unsigned int count)
+	{
+		if (count == 0) return;
+		unsigned char* dst = grow(4 * count);
+		for (unsigned int i = 0; i < count; ++i, dst += 4)
+		{
+			uint32_t bits;
+			memcpy(&bits, &values[i], 4);
+			dst[0] = static_cast<unsigned char>(bits >> 24);
+			dst[1] = static_cast<unsigned char>(bits >> 16);
+			dst[2] = static_cast<unsigned char>(bits >> 8);
+			dst[3] = static_cast<unsigned char>(bits);
+		}
+	}
+
+	// ----------------------------------------------------------------------
+	void Storage::readFloatArray(float* values, unsigned int count)
+	{
+		checkReadArraySafe(count, 4);
+		if (count == 0) return;
+		const unsigned char* src = &store[pos_];
+		for (unsigned int i = 0; i < count; ++i, src += 4)
+		{
+			const uint32_t bits = (uint32_t(src[0]) << 24) | (uint32_t(src[1]) << 16) | (uint32_t(src[2]) << 8) | uint32_t(src[3]);
+			memcpy(&values[i], &bits, 4);
+		}
+		pos_ += 4 * count;
+	}
+
+	// ----------------------------------------------------------------------
+	void Storage::writeFloatArray(const float* values, unsigned int count)
+	{
+		if (count == 0) return;
+		unsigned char* dst = grow(4 * count);
+		for (unsigned int i = 0; i < count; ++i, dst += 4)
+		{
+			uint32_t bits;
+			memcpy(&bits, &values[i], 4);
+			dst[0] = static_cast<unsigned char>(bits >> 24);
+			dst[1] = static_cast<unsigned char>(bits >> 16);
+			dst[2] = static_cast<unsigned char>(bits >> 8);
+			dst[3] = static_cast<unsigned char>(bits);
+		}
+	}
 
         // ----------------------------------------------------------------------
 
 		void Storage::writePacket(unsigned char* packet, int length)
 		{
-			store.reserve(length);
-			for(int i = 0; i < length; ++i) store.push_back(packet[i]);
-			//init();
+			store.insert(store.end(), packet, packet + length);
 		}
 
         // ----------------------------------------------------------------------
 
-		void Storage::writeStorage(tcpip::Storage& store)
+		void Storage::writeStorage(tcpip::Storage& other)
 		{
-			while (store.valid_pos())
-				writeChar( store.readChar() );
+			// takes the unread bytes and leaves other fully read, as the reads did before
+			store.insert(store.end(), other.store.begin() + other.pos_, other.store.end());
+			other.pos_ = static_cast<unsigned int>(other.store.size());
 		}
 }
 
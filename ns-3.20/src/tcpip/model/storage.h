@@ -41,12 +41,8 @@ public:
 private:
 	StorageType store;
 
+	/// Read position, not moved by the writes
 	unsigned int pos_;
-	bool iterValid_;
-	bool iterEndValid_;
-
-	StorageType::const_iterator iter_;
-	StorageType::const_iterator iterEnd_;
 
 	// sortation of bytes forwards or backwards?
 	bool bigEndian_;
@@ -54,6 +50,17 @@ private:
 	/// Used in constructors to initialize local variables
 	void init();
 
+	/// Throws if less than \p num bytes are left to read
+	void checkReadSafe(unsigned int num) const;
+	/// Throws if less than \p count elements of \p size bytes are left to read, without overflowing the byte count
+	void checkReadArraySafe(unsigned int count, unsigned int size) const;
+	/// Appends \p size bytes at the end of the storage and returns where they start
+	unsigned char* grow(unsigned int size);
+	/// Writes \p size bytes of \p begin in network order
+	void writeByEndianess(const unsigned char* begin, unsigned int size);
+	/// Reads \p size bytes in network order into \p array
+	void readByEndianess(unsigned char* array, unsigned int size);
+
 public:
 
 	/// Standard Constructor
@@ -68,7 +75,12 @@ public:
 	virtual bool valid_pos();
 	virtual unsigned int position() const;
 
+	/// Empties the storage. The allocated memory is kept for the next content.
 	void reset();
+	/// Makes room for \p size bytes, so that the following writes do not reallocate
+	void reserve(unsigned int size) { store.reserve(size); }
+	/// Empties the storage and returns a buffer of \p length bytes to be filled directly, e.g. by recv
+	unsigned char* prepareReceive(unsigned int length);
 
 	virtual unsigned char readChar() throw(std::invalid_argument);
 	virtual void writeChar(unsigned char) throw();
@@ -80,7 +92,11 @@ public:
 	virtual void writeUnsignedByte(int) throw(std::invalid_argument);
 
 	virtual std::string readString() throw(std::invalid_argument);
-	virtual void writeString(std::string s) throw();
+	/// Reads a string into \p value, reusing its memory
+	void readString(std::string& value);
+	/// Reads a string without copying it. \p data stays valid until the storage is written or reset.
+	void readStringData(const char*& data, unsigned int& length);
+	virtual void writeString(const std::string& s) throw();
 
 	virtual std::vector<std::string> readStringList() throw(std::invalid_argument);
 	virtual void writeStringList(const std::vector<std::string> &s) throw();
@@ -103,6 +119,12 @@ public:
 	virtual double readDouble() throw(std::invalid_argument);
 	virtual void writeDouble( double ) throw();
 
+	/// Bulk versions of readInt/writeInt and readFloat/writeFloat, without a length prefix
+	void readIntArray(int* values, unsigned int count);
+	void writeIntArray(const int* values, unsigned int count);
+	void readFloatArray(float* values, unsigned int count);
+	void writeFloatArray(const float* values, unsigned int count);
+
 	virtual void writePacket(unsigned char* packet, int length);
 
 	virtual void writeStorage(tcpip::Storage& store);
@@ -112,6 +134,7 @@ public:
 
 	StorageType::const_iterator begin() const { return store.begin(); }
 	StorageType::const_iterator end() const { return store.end(); }
+	const unsigned char* data() const { return store.empty() ? 0 : &store[0]; }
 
 };
 
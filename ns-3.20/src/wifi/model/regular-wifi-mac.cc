@@ -31,6 +31,7 @@
 #include "dcf.h"
 #include "dcf-manager.h"
 #include "wifi-phy.h"
+#include "wifi-mac-queue.h"
 
 #include "msdu-aggregator.h"
 
@@ -389,6 +390,17 @@ RegularWifiMac::GetCompressedBlockAckTimeout (void) const
   return m_low->GetCompressedBlockAckTimeout ();
 }
 
+void
+RegularWifiMac::FlushQueues (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_dca->GetQueue ()->Flush ();
+  for (EdcaQueues::iterator i = m_edca.begin (); i != m_edca.end (); ++i)
+    {
+      i->second->FlushQueue ();
+    }
+}
+
 void
 RegularWifiMac::SetAddress (Mac48Address address)
 {
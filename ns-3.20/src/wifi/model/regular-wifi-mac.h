@@ -230,6 +230,12 @@ public:
   virtual void SetCompressedBlockAckTimeout (Time blockAckTimeout);
   virtual Time GetCompressedBlockAckTimeout (void) const;
 
+  /**
+   * Drop the frames waiting in the DCF and EDCA queues, e.g. when the
+   * node is recycled for a new vehicle.
+   */
+  void FlushQueues (void);
+
 protected:
   virtual void DoInitialize ();
   virtual void DoDispose ();
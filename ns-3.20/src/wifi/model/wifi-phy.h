@@ -1073,7 +1073,7 @@ public:
   virtual void SetChannelBonding (bool channelbonding) = 0 ;
 
   bool IsNodeActivated (void); // Added by Ramon Bauza
-  void SetNodeStatus (bool activated); // Added by Ramon Bauza
+  virtual void SetNodeStatus (bool activated); // Added by Ramon Bauza
 
 private:
   /**
@@ -20,6 +20,8 @@
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
 #include "ns3/mobility-model.h"
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/itetris-mobility-model.h"
 #include "ns3/net-device.h"
 #include "ns3/node.h"
 #include "ns3/log.h"
@@ -29,6 +31,8 @@
 #include "yans-wifi-phy.h"
 #include "ns3/propagation-loss-model.h"
 #include "ns3/propagation-delay-model.h"
+#include <algorithm>
+#include <cmath>
 
 NS_LOG_COMPONENT_DEFINE ("YansWifiChannel");
 
@@ -57,13 +61,17 @@ YansWifiChannel::GetTypeId (void)
 YansWifiChannel::YansWifiChannel ()
 : m_interferenceRangeVehicle (1500), // Originally was 3000 reduced to 1500 to speed up, by A Correa
   m_interferenceRangeCiu (2000), // Originally was 5000 reduced to 2000 to speed up, by A Correa
-  m_PDRDist(true) //Added by Goku
+  m_PDRDist(true), //Added by Goku
+  m_cellSize (2000)
 {
 }
 YansWifiChannel::~YansWifiChannel ()
 {
   NS_LOG_FUNCTION_NOARGS ();
   m_phyList.clear ();
+  m_phyStates.clear ();
+  m_phyIndices.clear ();
+  m_activePhys.clear ();
 }
 
 void
@@ -89,26 +97,44 @@ YansWifiChannel::Send (Ptr<YansWifiPhy> sender, Ptr<const Packet> packet, double
 
 
     NS_ASSERT (senderMobility != 0);
-  uint32_t j = 0;
-  for (PhyList::const_iterator i = m_phyList.begin (); i != m_phyList.end (); i++, j++)
+  std::map<uint16_t, ActivePhys>::const_iterator channelPhys = m_activePhys.find (sender->GetChannelNumber ());
+  if (channelPhys == m_activePhys.end ())
     {
-      if (sender != (*i))
+      return;
+    }
+  Vector senderPosition = senderMobility->GetPosition ();
+  bool senderIsMobile = senderMobility->GetNode ()->IsMobileNode ();
+
+  // Candidate receivers: the active PHYs of the cells around the sender, and the moving ones.
+  // They are visited in the order of the PHY list, as the random variables of the loss model
+  // are drawn in this order.
+  std::vector<uint32_t> candidates (channelPhys->second.moving);
+  Cell cell = GetCell (senderPosition);
+  for (int64_t x = cell.first - 1; x <= cell.first + 1; x++)
+    {
+      for (int64_t y = cell.second - 1; y <= cell.second + 1; y++)
         {
-    	  Ptr<MobilityModel> receiverMobility = (*i)->GetMobility ()->GetObject<MobilityModel> ();
-          // For now don't account for inter channel interference
-          if ((*i)->GetChannelNumber () != sender->GetChannelNumber ())
-              continue;
+          Grid::const_iterator phys = channelPhys->second.grid.find (Cell (x, y));
+          if (phys != channelPhys->second.grid.end ())
+            {
+              candidates.insert (candidates.end (), phys->second.begin (), phys->second.end ());
+            }
+        }
+    }
+  std::sort (candidates.begin (), candidates.end ());
 
-          if (!(*i)->IsNodeActivated())
-		  {
-			  NS_LOG_DEBUG ("   no, it is off");
-			  continue;
-		  }
+  for (std::vector<uint32_t>::const_iterator i = candidates.begin (); i != candidates.end (); i++)
+    {
+      uint32_t j = *i;
+      if (sender != m_phyList[j])
+        {
+    	  Ptr<MobilityModel> receiverMobility = m_phyList[j]->GetMobility ()->GetObject<MobilityModel> ();
+          double distanceTxRx = CalculateDistance (senderPosition, receiverMobility->GetPosition ());//Added by Goku
 
-          if (senderMobility->GetNode()->IsMobileNode() && receiverMobility->GetNode()->IsMobileNode())
+          if (senderIsMobile && receiverMobility->GetNode()->IsMobileNode())
 		  {
 			// Both nodes are vehicles
-			if (senderMobility->GetDistanceFrom(receiverMobility) > m_interferenceRangeVehicle)
+			if (distanceTxRx > m_interferenceRangeVehicle)
 			{
 				NS_LOG_DEBUG ("   no, it is out of the interference range");
 				continue;
@@ -116,20 +142,18 @@ YansWifiChannel::Send (Ptr<YansWifiPhy> sender, Ptr<const Packet> packet, double
 		  }
 		  else
 		  {
-			//std::cout<<"YansWifiChannel::Send 5!!!"<<std::endl;
 			// One of the nodes is a CIU
-			if (senderMobility->GetDistanceFrom(receiverMobility) > m_interferenceRangeCiu)
+			if (distanceTxRx > m_interferenceRangeCiu)
 			{
 				NS_LOG_DEBUG ("   no, it is out of the interference range");
 				continue;
 			}
 		  }
-            double distanceTxRx = senderMobility->GetDistanceFrom(receiverMobility);//Added by Goku
 
           Time delay = m_delay->GetDelay (senderMobility, receiverMobility);
           double rxPowerDbm = m_loss->CalcRxPower (txPowerDbm, senderMobility, receiverMobility);
           NS_LOG_DEBUG ("propagation: txPower=" << txPowerDbm << "dbm, rxPower=" << rxPowerDbm << "dbm, " <<
-                        "distance=" << senderMobility->GetDistanceFrom (receiverMobility) << "m, delay=" << delay);
+                        "distance=" << distanceTxRx << "m, delay=" << delay);
           Ptr<Packet> copy = packet->Copy ();
           Ptr<Object> dstNetDevice = m_phyList[j]->GetDevice ();
           uint32_t dstNode;
@@ -159,9 +183,6 @@ YansWifiChannel::Send (Ptr<YansWifiPhy> sender, Ptr<const Packet> packet, double
                                                 delay, &YansWifiChannel::Receive, this,
                                                 j, copy, rxPowerDbm, txVector, preamble);
             }
-         /* Simulator::ScheduleWithContext (dstNode,
-                                          delay, &YansWifiChannel::Receive, this,
-                                          j, copy, rxPowerDbm, txVector, preamble); */ // Commented by Goku
         }
     }
 }
@@ -197,7 +218,135 @@ YansWifiChannel::GetDevice (uint32_t i) const
 void
 YansWifiChannel::Add (Ptr<YansWifiPhy> phy)
 {
+  uint32_t i = m_phyList.size ();
   m_phyList.push_back (phy);
+  PhyState state;
+  state.active = false;
+  state.channelNumber = 0;
+  state.inGrid = false;
+  state.tracked = false;
+  m_phyStates.push_back (state);
+  m_phyIndices[PeekPointer (phy)] = i;
+  UpdatePhy (i);
+}
+
+void
+YansWifiChannel::UpdatePhy (Ptr<YansWifiPhy> phy)
+{
+  std::map<const YansWifiPhy *, uint32_t>::const_iterator i = m_phyIndices.find (PeekPointer (phy));
+  if (i != m_phyIndices.end ())
+    {
+      UpdatePhy (i->second);
+    }
+}
+
+void
+YansWifiChannel::UpdatePhy (uint32_t i)
+{
+  NS_LOG_FUNCTION (this << i);
+  RemoveActivePhy (i);
+  if (!m_phyList[i]->IsNodeActivated ())
+    {
+      return;
+    }
+
+  PhyState &state = m_phyStates[i];
+  state.active = true;
+  state.channelNumber = m_phyList[i]->GetChannelNumber ();
+  ActivePhys &phys = m_activePhys[state.channelNumber];
+
+  Ptr<Object> object = m_phyList[i]->GetMobility ();
+  Ptr<MobilityModel> mobility = object != 0 ? object->GetObject<MobilityModel> () : 0;
+  // Only the models whose position changes with a course change can be placed in the grid
+  if (mobility != 0
+      && (DynamicCast<ItetrisMobilityModel> (mobility) != 0 || DynamicCast<ConstantPositionMobilityModel> (mobility) != 0))
+    {
+      if (!state.tracked)
+        {
+          mobility->TraceConnectWithoutContext ("CourseChange", MakeCallback (&YansWifiChannel::CourseChanged, this).Bind (i));
+          state.tracked = true;
+        }
+      state.inGrid = true;
+      state.cell = GetCell (mobility->GetPosition ());
+      phys.grid[state.cell].push_back (i);
+    }
+  else
+    {
+      state.inGrid = false;
+      phys.moving.push_back (i);
+    }
+}
+
+void
+YansWifiChannel::CourseChanged (uint32_t i, Ptr<const MobilityModel> mobility)
+{
+  PhyState &state = m_phyStates[i];
+  if (!state.active || !state.inGrid)
+    {
+      return;
+    }
+  Cell cell = GetCell (mobility->GetPosition ());
+  if (cell != state.cell)
+    {
+      RemoveActivePhy (i);
+      state.active = true;
+      state.inGrid = true;
+      state.cell = cell;
+      m_activePhys[state.channelNumber].grid[cell].push_back (i);
+    }
+}
+
+void
+YansWifiChannel::RemoveActivePhy (uint32_t i)
+{
+  PhyState &state = m_phyStates[i];
+  if (!state.active)
+    {
+      return;
+    }
+  state.active = false;
+  ActivePhys &phys = m_activePhys[state.channelNumber];
+  if (state.inGrid)
+    {
+      Grid::iterator cell = phys.grid.find (state.cell);
+      NS_ASSERT (cell != phys.grid.end ());
+      std::vector<uint32_t>::iterator j = std::find (cell->second.begin (), cell->second.end (), i);
+      NS_ASSERT (j != cell->second.end ());
+      *j = cell->second.back ();
+      cell->second.pop_back ();
+      if (cell->second.empty ())
+        {
+          phys.grid.erase (cell);
+        }
+    }
+  else
+    {
+      std::vector<uint32_t>::iterator j = std::find (phys.moving.begin (), phys.moving.end (), i);
+      NS_ASSERT (j != phys.moving.end ());
+      *j = phys.moving.back ();
+      phys.moving.pop_back ();
+    }
+}
+
+void
+YansWifiChannel::RebuildGrid (void)
+{
+  m_cellSize = std::max (m_interferenceRangeVehicle, m_interferenceRangeCiu);
+  m_activePhys.clear ();
+  for (uint32_t i = 0; i < m_phyList.size (); i++)
+    {
+      m_phyStates[i].active = false;
+      UpdatePhy (i);
+    }
+}
+
+YansWifiChannel::Cell
+YansWifiChannel::GetCell (const Vector &position) const
+{
+  // The grid uses x and y only: two PHYs within range along the 3D distance
+  // are also within range along each of these coordinates
+  return Cell (static_cast<int64_t> (std::floor (position.x / m_cellSize)),
+               static_cast<int64_t> (std::floor (position.y / m_cellSize)));
 }
 
 int64_t
@@ -212,12 +361,14 @@ void
 YansWifiChannel::SetInterferenceRangeVehicle (float range)
 {
   m_interferenceRangeVehicle = range;
+  RebuildGrid ();
 }
 
 void
 YansWifiChannel::SetInterferenceRangeCiu (float range)
 {
   m_interferenceRangeCiu = range;
+  RebuildGrid ();
 }
 
 } // namespace ns3
@@ -21,8 +21,10 @@
 #define YANS_WIFI_CHANNEL_H
 
 #include <vector>
+#include <map>
 #include <stdint.h>
 #include "ns3/packet.h"
+#include "ns3/vector.h"
 #include "wifi-channel.h"
 #include "wifi-mode.h"
 #include "wifi-preamble.h"
@@ -31,6 +33,7 @@
 namespace ns3 {
 
 class NetDevice;
+class MobilityModel;
 class PropagationLossModel;
 class PropagationDelayModel;
 class YansWifiPhy;
@@ -76,6 +79,14 @@ public:
    */
   void Add (Ptr<YansWifiPhy> phy);
 
+  /**
+   * Updates the set of the active PHYs after the given YansWifiPhy
+   * has been activated or deactivated or has switched channel
+   *
+   * \param phy the YansWifiPhy that changed
+   */
+  void UpdatePhy (Ptr<YansWifiPhy> phy);
+
   /**
    * \param loss the new propagation loss model.
    */
@@ -121,6 +132,38 @@ private:
    * A vector of pointers to YansWifiPhy.
    */
   typedef std::vector<Ptr<YansWifiPhy> > PhyList;
+  /**
+   * A cell of the grid of the active PHYs, from the x and y coordinates.
+   * The cells are as large as the biggest interference range, so the
+   * receivers of a transmission lie in the 3x3 cells around the sender.
+   */
+  typedef std::pair<int64_t, int64_t> Cell;
+  /**
+   * The indices in the PHY list of the active PHYs, by cell.
+   */
+  typedef std::map<Cell, std::vector<uint32_t> > Grid;
+  /**
+   * The active PHYs of a channel number. PHYs whose mobility model moves
+   * them without notifying a course change cannot be placed in the grid
+   * and are visited by every transmission.
+   */
+  struct ActivePhys
+  {
+    Grid grid;
+    std::vector<uint32_t> moving;
+  };
+  /**
+   * The state of a PHY of the PHY list in the set of the active PHYs.
+   */
+  struct PhyState
+  {
+    bool active;             //!< Whether the PHY is in m_activePhys
+    uint16_t channelNumber;  //!< Channel number under which the PHY is stored
+    bool inGrid;             //!< Whether the PHY is in the grid or in the moving PHYs
+    Cell cell;               //!< Cell of the PHY, if it is in the grid
+    bool tracked;            //!< Whether the course changes of the PHY are tracked
+  };
+
   /**
    * This method is scheduled by Send for each associated YansWifiPhy.
    * The method then calls the corresponding YansWifiPhy that the first
@@ -138,12 +181,22 @@ private:
     //Added by Goku
      void ReceiveV2 (uint32_t i, Ptr<Packet> packet, struct Parameters parameters) const; //Added by Goku
 
+  void UpdatePhy (uint32_t i);
+  void CourseChanged (uint32_t i, Ptr<const MobilityModel> mobility);
+  void RemoveActivePhy (uint32_t i);
+  void RebuildGrid (void);
+  Cell GetCell (const Vector &position) const;
+
   PhyList m_phyList; //!< List of YansWifiPhys connected to this YansWifiChannel
   Ptr<PropagationLossModel> m_loss; //!< Propagation loss model
   Ptr<PropagationDelayModel> m_delay; //!< Propagation delay model
   float m_interferenceRangeVehicle;
   float m_interferenceRangeCiu;
   bool m_PDRDist; //Added by Goku
+  std::vector<PhyState> m_phyStates; //!< State of each PHY of m_phyList
+  std::map<const YansWifiPhy *, uint32_t> m_phyIndices; //!< Index in m_phyList of each PHY
+  std::map<uint16_t, ActivePhys> m_activePhys; //!< Active PHYs, by channel number
+  double m_cellSize; //!< Size of the cells of the grid
 };
 
 } // namespace ns3
@@ -315,6 +315,16 @@ YansWifiPhy::SetMobility (Ptr<Object> mobility)
   m_mobility = mobility;
 }
 
+void
+YansWifiPhy::SetNodeStatus (bool activated)
+{
+  WifiPhy::SetNodeStatus (activated);
+  if (m_channel != 0)
+    {
+      m_channel->UpdatePhy (this);
+    }
+}
+
 double
 YansWifiPhy::GetRxNoiseFigure (void) const
 {
@@ -396,6 +406,10 @@ YansWifiPhy::SetChannelNumber (uint16_t nch)
       NS_LOG_DEBUG ("start at channel " << nch);
       m_channelNumber = nch;
       channelNumberInit=false;
+      if (m_channel != 0)
+        {
+          m_channel->UpdatePhy (this);
+        }
       return;
     }
 
@@ -435,6 +449,10 @@ switchChannel:
    * out the state of the medium after the switching.
    */
   m_channelNumber = nch;
+  if (m_channel != 0)
+    {
+      m_channel->UpdatePhy (this);
+    }
 }
 
 uint16_t
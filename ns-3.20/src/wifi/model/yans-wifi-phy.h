@@ -186,6 +186,12 @@ public:
    * \param mobility the mobility model this PHY is associated with
    */
   void SetMobility (Ptr<Object> mobility);
+  /**
+   * Activates or deactivates the PHY, and updates the active PHYs of the channel.
+   *
+   * \param activated whether the node of this PHY is activated
+   */
+  virtual void SetNodeStatus (bool activated);
   /**
    * Return the RX noise figure (dBm).
    *
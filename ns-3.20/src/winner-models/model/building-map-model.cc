@@ -24,9 +24,16 @@
 #include "ns3/log.h"
 #include <string>
 #include <fstream>
+#include <cmath>
+#include <algorithm>
 
 NS_LOG_COMPONENT_DEFINE ("BuildingMapModel");
 
+// Average number of walls per cell of the wall grid
+#define WALLS_PER_CELL 4
+// Smallest cell size of the wall grid (m)
+#define MIN_CELL_SIZE 1.0
+
 namespace ns3 {
 
 NS_OBJECT_ENSURE_REGISTERED (BuildingMapModel);
@@ -43,12 +50,24 @@ BuildingMapModel::GetTypeId (void)
 
 
 BuildingMapModel::BuildingMapModel ()
+  : m_gridOriginX (0),
+    m_gridOriginY (0),
+    m_gridCellSize (0),
+    m_gridPadding (0),
+    m_gridColumns (0),
+    m_gridRows (0)
 {}
 
 BuildingMapModel::~BuildingMapModel ()
 {}
 
 BuildingMapModel::BuildingMapModel (std::string path)
+  : m_gridOriginX (0),
+    m_gridOriginY (0),
+    m_gridCellSize (0),
+    m_gridPadding (0),
+    m_gridColumns (0),
+    m_gridRows (0)
 {
   m_path = path;
 }
@@ -71,6 +90,122 @@ BuildingMapModel::InitializeVisibilityModel (void)
   m_is->close ();
   delete m_is;
   m_is = 0;
+  BuildWallGrid ();
+}
+
+void
+BuildingMapModel::BuildWallGrid (void)
+{
+  m_cellStart.clear ();
+  m_wallX1.clear ();
+  m_wallY1.clear ();
+  m_wallDx.clear ();
+  m_wallDy.clear ();
+  m_gridColumns = 0;
+  m_gridRows = 0;
+  if (m_buildingList.empty ())
+    {
+      return;
+    }
+
+  double minX = m_buildingList[0].x1;
+  double maxX = minX;
+  double minY = m_buildingList[0].y1;
+  double maxY = minY;
+  for (std::vector<struct BuildingMapModel::Segment>::const_iterator it = m_buildingList.begin(); it != m_buildingList.end(); ++it)
+    {
+      minX = std::min (minX, std::min (it->x1, it->x2));
+      maxX = std::max (maxX, std::max (it->x1, it->x2));
+      minY = std::min (minY, std::min (it->y1, it->y2));
+      maxY = std::max (maxY, std::max (it->y1, it->y2));
+    }
+
+  // The cell size is chosen to hold a few walls per cell on average. The padding enlarges the walls and
+  // the traversed area of the Tx-Rx segment so that rounding errors can never leave out a candidate wall
+  double area = std::max ((maxX - minX) * (maxY - minY), 1.0);
+  m_gridCellSize = std::max (std::sqrt (area * WALLS_PER_CELL / m_buildingList.size ()), MIN_CELL_SIZE);
+  m_gridPadding = 0.01 * m_gridCellSize;
+  m_gridOriginX = minX - m_gridPadding;
+  m_gridOriginY = minY - m_gridPadding;
+  m_gridColumns = (int) std::floor ((maxX - minX + 2 * m_gridPadding) / m_gridCellSize) + 1;
+  m_gridRows = (int) std::floor ((maxY - minY + 2 * m_gridPadding) / m_gridCellSize) + 1;
+
+  // First pass counts the walls of every cell, second pass copies them into their slots
+  uint32_t numCells = m_gridColumns * m_gridRows;
+  m_cellStart.assign (numCells + 1, 0);
+  for (int pass = 0; pass < 2; ++pass)
+    {
+      std::vector<uint32_t> next;
+      if (pass == 1)
+        {
+          for (uint32_t cell = 0; cell < numCells; ++cell)
+            {
+              m_cellStart[cell + 1] += m_cellStart[cell];
+            }
+          next.assign (m_cellStart.begin (), m_cellStart.end () - 1);
+          m_wallX1.resize (m_cellStart[numCells]);
+          m_wallY1.resize (m_cellStart[numCells]);
+          m_wallDx.resize (m_cellStart[numCells]);
+          m_wallDy.resize (m_cellStart[numCells]);
+        }
+      for (std::vector<struct BuildingMapModel::Segment>::const_iterator it = m_buildingList.begin(); it != m_buildingList.end(); ++it)
+        {
+          int firstColumn = GetGridColumn (std::min (it->x1, it->x2) - m_gridPadding);
+          int lastColumn = GetGridColumn (std::max (it->x1, it->x2) + m_gridPadding);
+          int firstRow = GetGridRow (std::min (it->y1, it->y2) - m_gridPadding);
+          int lastRow = GetGridRow (std::max (it->y1, it->y2) + m_gridPadding);
+          for (int row = firstRow; row <= lastRow; ++row)
+            {
+              for (int column = firstColumn; column <= lastColumn; ++column)
+                {
+                  uint32_t cell = row * m_gridColumns + column;
+                  if (pass == 0)
+                    {
+                      m_cellStart[cell + 1]++;
+                    }
+                  else
+                    {
+                      uint32_t slot = next[cell]++;
+                      m_wallX1[slot] = it->x1;
+                      m_wallY1[slot] = it->y1;
+                      m_wallDx[slot] = it->x2 - it->x1;
+                      m_wallDy[slot] = it->y2 - it->y1;
+                    }
+                }
+            }
+        }
+    }
+  NS_LOG_DEBUG ("Wall grid " << m_gridColumns << "x" << m_gridRows << " cells of " << m_gridCellSize << " m, " << m_cellStart[numCells] << " wall entries");
+}
+
+int
+BuildingMapModel::GetGridColumn (double x) const
+{
+  double column = std::floor ((x - m_gridOriginX) / m_gridCellSize);
+  if (column < 0)
+    {
+      return 0;
+    }
+  if (column >= m_gridColumns)
+    {
+      return m_gridColumns - 1;
+    }
+  return (int) column;
+}
+
+int
+BuildingMapModel::GetGridRow (double y) const
+{
+  double row = std::floor ((y - m_gridOriginY) / m_gridCellSize);
+  if (row < 0)
+    {
+      return 0;
+    }
+  if (row >= m_gridRows)
+    {
+      return m_gridRows - 1;
+    }
+  return (int) row;
 }
 
 void
@@ -93,47 +228,112 @@ BuildingMapModel::GetVisibility (Ptr<MobilityModel> a, Ptr<MobilityModel> b) con
   seg.x2 = posB.x;
   seg.y2 = posB.y;
 
-  for (std::vector<struct BuildingMapModel::Segment>::const_iterator it = m_buildingList.begin(); it != m_buildingList.end(); ++it)
-  {
-    if ( DoSegmentsIntersect (seg, *it) )
-      {
-        vis = false;
-        break;
-      }
-  }
+  double minX = std::min (seg.x1, seg.x2);
+  double maxX = std::max (seg.x1, seg.x2);
+  double minY = std::min (seg.y1, seg.y2);
+  double maxY = std::max (seg.y1, seg.y2);
+  if (m_gridColumns == 0
+      || maxX < m_gridOriginX || minX > m_gridOriginX + m_gridColumns * m_gridCellSize
+      || maxY < m_gridOriginY || minY > m_gridOriginY + m_gridRows * m_gridCellSize)
+    {
+      NS_LOG_DEBUG ("Visibility = " << vis);
+      return vis;
+    }
+
+  // Only the cells crossed by the segment are visited. The segment is walked along its major axis, so that
+  // the extent on the other axis is computed with a slope of at most 1
+  if (maxX - minX >= maxY - minY)
+    {
+      double slope = (maxX > minX) ? (seg.y2 - seg.y1) / (seg.x2 - seg.x1) : 0;
+      int firstColumn = GetGridColumn (minX - m_gridPadding);
+      int lastColumn = GetGridColumn (maxX + m_gridPadding);
+      for (int column = firstColumn; column <= lastColumn && vis; ++column)
+        {
+          double cellX = m_gridOriginX + column * m_gridCellSize;
+          double ya = seg.y1 + (std::min (std::max (cellX, minX), maxX) - seg.x1) * slope;
+          double yb = seg.y1 + (std::min (std::max (cellX + m_gridCellSize, minX), maxX) - seg.x1) * slope;
+          int firstRow = GetGridRow (std::min (ya, yb) - m_gridPadding);
+          int lastRow = GetGridRow (std::max (ya, yb) + m_gridPadding);
+          for (int row = firstRow; row <= lastRow; ++row)
+            {
+              if (DoesSegmentIntersectCell (seg, row * m_gridColumns + column))
+                {
+                  vis = false;
+                  break;
+                }
+            }
+        }
+    }
+  else
+    {
+      double slope = (seg.x2 - seg.x1) / (seg.y2 - seg.y1);
+      int firstRow = GetGridRow (minY - m_gridPadding);
+      int lastRow = GetGridRow (maxY + m_gridPadding);
+      for (int row = firstRow; row <= lastRow && vis; ++row)
+        {
+          double cellY = m_gridOriginY + row * m_gridCellSize;
+          double xa = seg.x1 + (std::min (std::max (cellY, minY), maxY) - seg.y1) * slope;
+          double xb = seg.x1 + (std::min (std::max (cellY + m_gridCellSize, minY), maxY) - seg.y1) * slope;
+          int firstColumn = GetGridColumn (std::min (xa, xb) - m_gridPadding);
+          int lastColumn = GetGridColumn (std::max (xa, xb) + m_gridPadding);
+          for (int column = firstColumn; column <= lastColumn; ++column)
+            {
+              if (DoesSegmentIntersectCell (seg, row * m_gridColumns + column))
+                {
+                  vis = false;
+                  break;
+                }
+            }
+        }
+    }
 
   NS_LOG_DEBUG ("Visibility = " << vis);
   return vis;
 
 }
 
-bool 
-BuildingMapModel::DoSegmentsIntersect (BuildingMapModel::Segment seg1, BuildingMapModel::Segment seg2) const
+bool
+BuildingMapModel::DoesSegmentIntersectCell (BuildingMapModel::Segment seg, uint32_t cell) const
 {
   // http://local.wasp.uwa.edu.au/~pbourke/geometry/lineline2d/
+  // The expressions are evaluated exactly as in the wall-by-wall test, seg1 being the Tx-Rx segment and
+  // seg2 the wall, so the result is bit-identical. The loop has no early exit nor branches so that it is
+  // vectorized over the walls of the cell
 
-  bool inter = false;
-  double denom = ((seg2.y2-seg2.y1)*(seg1.x2-seg1.x1))-((seg2.x2-seg2.x1)*(seg1.y2-seg1.y1));
-  double numa = (seg2.x2-seg2.x1)*(seg1.y1-seg2.y1)-(seg2.y2-seg2.y1)*(seg1.x1-seg2.x1);
-  double numb = (seg1.x2-seg1.x1)*(seg1.y1-seg2.y1)-(seg1.y2-seg1.y1)*(seg1.x1-seg2.x1);
-
-  if (denom != 0.0)
+  uint32_t begin = m_cellStart[cell];
+  uint32_t end = m_cellStart[cell + 1];
+  if (begin == end)
+    {
+      return false;
+    }
+  const double *x1 = &m_wallX1[0];
+  const double *y1 = &m_wallY1[0];
+  const double *dx = &m_wallDx[0];
+  const double *dy = &m_wallDy[0];
+  double segDx = seg.x2 - seg.x1;
+  double segDy = seg.y2 - seg.y1;
+  int inter = 0;
+  int collinear = 0;
+  for (uint32_t i = begin; i < end; ++i)
     {
+      double denom = (dy[i]*segDx)-(dx[i]*segDy);
+      double numa = dx[i]*(seg.y1-y1[i])-dy[i]*(seg.x1-x1[i]);
+      double numb = segDx*(seg.y1-y1[i])-segDy*(seg.x1-x1[i]);
       double ua = numa/denom;
       double ub = numb/denom;
-      if ( ua <= 1 && ua >= 0 && ub <= 1 && ub >= 0 ) // Segments intesect each other
-        {
-          inter = true;
-          NS_LOG_DEBUG ("Segments intersecting");
-          NS_LOG_DEBUG ("Seg1=(" <<seg1.x1 << "," <<seg1.y1 << ") ("<<seg1.x2 << "," << seg1.y2 << ")");
-          NS_LOG_DEBUG ("Seg1=(" <<seg2.x1 << "," <<seg2.y1 << ") ("<<seg2.x2 << "," << seg2.y2 << ")");
-        }
+      inter |= (denom != 0.0) & (ua <= 1) & (ua >= 0) & (ub <= 1) & (ub >= 0);
+      collinear |= (denom == 0.0) & (numa == 0.0) & (numb == 0.0);
+    }
+
+  if (collinear)
+    {
+      NS_FATAL_ERROR ("BuildingMapModel::DoesSegmentIntersectCell - Tx and Rx are in the same position as one of the buildings in the scenario");
     }
-  else if ( (numa == 0.0) && (numb == 0.0) )
+  if (inter)
     {
-      NS_FATAL_ERROR ("BuildingMapModel::DoSegmentsIntersect - Tx and Rx are in the same position as one of the buildings in the scenario");
+      NS_LOG_DEBUG ("Segments intersecting");
+      NS_LOG_DEBUG ("Seg1=(" <<seg.x1 << "," <<seg.y1 << ") ("<<seg.x2 << "," << seg.y2 << ")");
     }
-
   return inter;
 
 }
@@ -52,9 +52,30 @@ public:
 
 
 private:
-  bool DoSegmentsIntersect (BuildingMapModel::Segment seg1, BuildingMapModel::Segment seg2) const;
+  void BuildWallGrid (void);
+  int GetGridColumn (double x) const;
+  int GetGridRow (double y) const;
+  bool DoesSegmentIntersectCell (BuildingMapModel::Segment seg, uint32_t cell) const;
   std::vector<struct BuildingMapModel::Segment> m_buildingList;
 
+  /**
+   * Uniform grid over the walls, built by InitializeVisibilityModel. Every wall is registered in the cells
+   * covered by its (slightly enlarged) bounding box. The walls of a cell are stored contiguously in
+   * structure-of-arrays form, m_cellStart[c] to m_cellStart[c+1], so that the test of a cell is a single
+   * branch-free loop the compiler can vectorize
+   */
+  double m_gridOriginX;
+  double m_gridOriginY;
+  double m_gridCellSize;
+  double m_gridPadding;
+  int m_gridColumns;
+  int m_gridRows;
+  std::vector<uint32_t> m_cellStart;
+  std::vector<double> m_wallX1;
+  std::vector<double> m_wallY1;
+  std::vector<double> m_wallDx;
+  std::vector<double> m_wallDy;
+
 };
 
 } // namespace ns3
@@ -23,6 +23,8 @@
 #include "ns3/boolean.h"
 #include "ns3/double.h"
 #include "ns3/string.h"
+#include "ns3/rng-stream.h"
+#include "ns3/rng-seed-manager.h"
 
 
 #include "ns3/enum.h"
@@ -36,6 +38,15 @@
 
 NS_LOG_COMPONENT_DEFINE ("FadingModel");
 
+// Upper bound of the uniformly distributed start offsets of the links
+#define START_OFFSET_MAX 8000.0
+// Number of link start offsets kept before the cache is flushed
+#define MAX_CACHED_LINKS 100000
+// The substreams of an RngStream must stay below 2^51: the link index takes the lower 44 bits
+// (node ids below 2^22), the run the upper 7 ones
+#define LINK_SUBSTREAM_BITS 44
+#define MAX_SUBSTREAM_RUN 128
+
 namespace ns3 {
 
 NS_OBJECT_ENSURE_REGISTERED (FadingModel);
@@ -73,16 +84,17 @@ FadingModel::FadingModel ()
     N = 16384;
     maxVelocity_ = 50;  //// by default set to 50 km/h (urban scenario)
     NLOSK_ = 0.0;
-    nn_ = 10000;  // expected number of nodes in the simulation scenario during the entire simulation
-    m_startvector_uniform_var = UniformVariable(0.0,8000.0);
+    data1 = 0;
+    data2 = 0;
+    m_stream = RngSeedManager::GetNextStreamIndex ();
 }
 
 FadingModel::~FadingModel ()
 {
   NS_LOG_FUNCTION_NOARGS ();
-  delete [] data1;
-  delete [] data2;
-  delete [] start_vector;
+  // data1 and data2 belong to the shared ricean table
+  data1 = 0;
+  data2 = 0;
 }
 
 double 
@@ -136,15 +148,10 @@ FadingModel::CalculateFading (Ptr<MobilityModel> a, Ptr<MobilityModel> b, double
 
     uint32_t maxId = GetMax (a->GetNode()->GetId(),b->GetNode()->GetId());
     uint32_t minId = GetMin (a->GetNode()->GetId(),b->GetNode()->GetId());
-    uint32_t link = maxId + nn_*minId - (minId+1)*(minId+2)/2;
-    if (link >= (nn_*nn_ - nn_*(nn_+1)/2))
-    {
-      NS_FATAL_ERROR (" FADING-MODEL: link number is too high compared to the start_vector capacity, please increase the nn_ variable in the constructor of this class");
-    }
     
-    NS_LOG_DEBUG  ("     FADING: transmission from node "<<a->GetNode()->GetId()<<" to node "<< b->GetNode()->GetId()<< "     link n  "<<link);
+    NS_LOG_DEBUG  ("     FADING: transmission from node "<<a->GetNode()->GetId()<<" to node "<< b->GetNode()->GetId());
 
-    time_index = ( Simulator::Now ().GetSeconds () * fs * fm / fm0) + start_vector[link] ;
+    time_index = ( Simulator::Now ().GetSeconds () * fs * fm / fm0) + GetStartOffset (maxId, minId) ;
 
     time_index = time_index - double(N)*floor(time_index/double(N)); 
 
@@ -210,7 +217,6 @@ FadingModel::Initialize (void)
 {
    NS_LOG_DEBUG  ("     FADING:           ricean file= "<<m_path<<"     max speed = "<< maxVelocity_); 
    ReadRiceanTable ();
-   InitializeStartVector();
    
 }
 
@@ -218,42 +224,72 @@ void
 FadingModel::ReadRiceanTable (void)
 {
 
+   // The table of every file is read once and shared read-only by all the fading models
+   static std::map<std::string, RiceanTable> riceanTables;
+
    FILE *fdstream;
-   float *tmp1, *tmp2;
    if(m_path == "")
    {
       NS_FATAL_ERROR (" FADING-MODEL: No Ricean File to open");
    }
-   else{
-     fdstream = fopen(m_path.c_str (), "r");
-   }
 
-   data1 = new float[N];
-   data2 = new float[N];
+   std::map<std::string, RiceanTable>::iterator table = riceanTables.find (m_path);
+   if (table == riceanTables.end ())
+   {
+     fdstream = fopen(m_path.c_str (), "r");
+     if (fdstream == NULL) {
+         NS_FATAL_ERROR (" FADING-MODEL: Ricean File "<<m_path<<" can not be opened");
+     }
 
-   tmp1 = data1;
-   tmp2 = data2;
+     RiceanTable newTable;
+     newTable.inphase.resize (N);
+     newTable.quadrature.resize (N);
 
-   for(int k=0; k<N; k++) {
-     int ret_val = fscanf(fdstream, "%f %f", tmp1++, tmp2++);
-     if(ret_val != 2) {
-         NS_FATAL_ERROR (" FADING-MODEL: Ricean File is not been reading properly");
+     for(int k=0; k<N; k++) {
+       int ret_val = fscanf(fdstream, "%f %f", &newTable.inphase[k], &newTable.quadrature[k]);
+       if(ret_val != 2) {
+           NS_FATAL_ERROR (" FADING-MODEL: Ricean File is not been reading properly");
+       }
      }
+     fclose(fdstream);
+     table = riceanTables.insert (std::make_pair (m_path, newTable)).first;
    }
 
+   data1 = &table->second.inphase[0];
+   data2 = &table->second.quadrature[0];
+
 //    for(int k=0; k<N; k++) {
 //      NS_LOG_DEBUG  ("     FADING: index= "<<k<<"        DATA1 = "<<data1[k]<<"     DATA2 = "<< data1[k]);
 //      }
 }
 
-void
-FadingModel::InitializeStartVector(void)
+float
+FadingModel::GetStartOffset (uint32_t maxId, uint32_t minId)
 {
-   start_vector = new float[nn_*nn_ - nn_*(nn_+1)/2];
-   for (uint i=0; i<(nn_*nn_ - nn_*(nn_+1)/2);i++) {   // total number of prospected links
-     start_vector[i] = m_startvector_uniform_var.GetValue();
-    // NS_LOG_DEBUG  ("     FADING: startvariable "<<i<<" = "<< start_vector[i]);
+   LinkId linkId = (uint64_t (minId) << 32) | maxId;
+   StartOffsets::iterator it = m_startOffsets.find (linkId);
+   if (it != m_startOffsets.end ()) {
+     return it->second;
+   }
+
+   // The offsets only depend on the link, flushing them just costs their recomputation
+   if (m_startOffsets.size () >= MAX_CACHED_LINKS) {
+     m_startOffsets.clear ();
+   }
+
+   // Every link draws its offset from its own substream of the model's stream, so that the offset does not
+   // depend on the order in which the links become active. The run number occupies the upper bits of the substream
+   uint64_t run = RngSeedManager::GetRun ();
+   if (run >= MAX_SUBSTREAM_RUN) {
+     NS_FATAL_ERROR (" FADING-MODEL: run "<<run<<" out of range, the fading offsets support runs below "<<MAX_SUBSTREAM_RUN);
    }
+   uint64_t link = uint64_t (maxId) * (uint64_t (maxId) + 1) / 2 + minId;
+   NS_ASSERT_MSG (link < (uint64_t (1) << LINK_SUBSTREAM_BITS), " FADING-MODEL: node id "<<maxId<<" out of range");
+   RngStream rng (RngSeedManager::GetSeed (), m_stream, (run << LINK_SUBSTREAM_BITS) + link);
+   float offset = START_OFFSET_MAX * rng.RandU01 ();
+   m_startOffsets.insert (std::make_pair (linkId, offset));
+   NS_LOG_DEBUG  ("     FADING: start offset of link ("<<maxId<<","<<minId<<") = "<< offset);
+   return offset;
 }
 
 
@@ -26,6 +26,9 @@
 #include "ns3/object.h"
 #include "ns3/mobility-model.h"
 #include "ns3/random-variable.h" 
+#include "ns3/sgi-hashmap.h"
+#include <map>
+#include <vector>
 
 namespace ns3 {
 
@@ -43,6 +46,24 @@ public:
 
 private:
 
+  /**
+   * Ricean table read from a fading file, shared read-only by all the models using the same file
+   */
+  typedef struct {
+    std::vector<float> inphase;
+    std::vector<float> quadrature;
+  } RiceanTable;
+
+  typedef uint64_t LinkId; // minId in the upper 32 bits, maxId in the lower ones
+  struct LinkIdHash
+  {
+    size_t operator() (LinkId linkId) const
+    {
+      return static_cast<size_t> (linkId ^ (linkId >> 32));
+    }
+  };
+  typedef sgi::hash_map<LinkId, float, LinkIdHash> StartOffsets;
+
   double CalculateFading (Ptr<MobilityModel> a, Ptr<MobilityModel> b, double K);
 
   double ConvertToDb (double fading) const;
@@ -53,7 +74,7 @@ private:
   void SetmaxVelocity (double velocity);
 
   void ReadRiceanTable (void);  
-  void InitializeStartVector(void);  
+  float GetStartOffset (uint32_t maxId, uint32_t minId);
 
  // void fadingTrace(double dist, double fading, uint isLOS);
 
@@ -64,12 +85,10 @@ private:
   double fs;               /* Sampling rate */
   double  maxVelocity_;   /* Maximum velocity of vehicle/objects in environment (km/h).  Used for computing doppler */
   double NLOSK_;          /* Ricean K factor */
-  float *data1;           /* Data values for inphase and quad phase */
-  float *data2;
-  float *start_vector;    /* vector containing uniformly distributed variables used to calculate the index to get values from the ricean table */
-  uint nn_;                /* max number of nodes estimated to be present in the scenario over the entire simulation*/
-
-  RandomVariable  m_startvector_uniform_var; 
+  const float *data1;     /* Data values for inphase and quad phase */
+  const float *data2;
+  StartOffsets m_startOffsets;  /* uniformly distributed offsets of the active links used to calculate the index to get values from the ricean table */
+  uint64_t m_stream;            /* RNG stream of this model, each link draws its offset from its own substream */
 
   std::string m_path;          /*file containing the ricean table*/
 
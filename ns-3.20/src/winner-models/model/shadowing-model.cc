@@ -22,6 +22,7 @@
 #include "shadowing-model.h"
 #include "ns3/boolean.h"
 #include "ns3/double.h"
+#include "ns3/nstime.h"
 #include "visibility-model.h"
 
 #include "ns3/enum.h"
@@ -51,6 +52,11 @@ ShadowingModel::GetTypeId (void)
                    DoubleValue (3),
                    MakeDoubleAccessor (&ShadowingModel::SetLosStd),
                    MakeDoubleChecker<double> ())
+    .AddAttribute ("LinkTimeout",
+                   "Time after which an idle correlated shadowing link is dropped (0 keeps the links forever)",
+                   TimeValue (Seconds (10)),
+                   MakeTimeAccessor (&ShadowingModel::m_linkTimeout),
+                   MakeTimeChecker ())
     ;
   return tid;
 }
@@ -58,7 +64,9 @@ ShadowingModel::GetTypeId (void)
 ShadowingModel::ShadowingModel ()
   : m_correlatedShadowing(false),
     m_losStd (3),
-    m_nLosStd (4)
+    m_nLosStd (4),
+    m_linkTimeout (Seconds (10)),
+    m_lastExpiry (Seconds (0))
 {
   m_lossShadowing = new NormalVariable (0.0,3*3);
   m_nLossShadowing = new NormalVariable (0.0,4*4);
@@ -78,29 +86,12 @@ ShadowingModel::~ShadowingModel ()
   m_lossShadowing = NULL;
   m_nLossShadowing = NULL;
   m_shadowingHFilt = NULL;
-  while (m_shadowingSpline.size () > 1)
+  for (ShadowingLinks::iterator it = m_shadowingLinks.begin (); it != m_shadowingLinks.end (); ++it)
     {
-      NS_LOG_DEBUG ("m_shadowingSpline.size ()="<<m_shadowingSpline.size ());
-      while (m_shadowingSpline.back()->size () > 0)
-        {
-          NS_LOG_DEBUG ("m_shadowingSpline.back()->size ()="<<m_shadowingSpline.back()->size ());
-          if (m_shadowingSpline.back()->back() != NULL)
-            {
-	      delete m_shadowingSpline.back()->back ();
-            }
-          m_shadowingSpline.back()->back () = NULL;
-          m_shadowingSpline.back()->erase(m_shadowingSpline.back()->end ()-1);
-	}
-      if (m_shadowingSpline.back() != NULL)
-        {
-          delete m_shadowingSpline.back();
-        }
-      m_shadowingSpline.back() = NULL;
-      m_shadowingSpline.erase(m_shadowingSpline.end ()-1);
+      delete it->second.spline;
     }
-  NS_LOG_DEBUG ("m_shadowingSpline.size ()="<<m_shadowingSpline.size ());
-  m_shadowingSpline.back() = NULL;
-  m_shadowingSpline.erase(m_shadowingSpline.end ()-1);
+  m_shadowingLinks.clear ();
+  m_nodeLinks.clear ();
 }
 
 double 
@@ -134,8 +125,7 @@ ShadowingModel::GetNLosCorrelatedShadowing (Ptr<MobilityModel> a, Ptr<MobilityMo
 {
   uint32_t maxId = GetMax (a->GetNode()->GetId(),b->GetNode()->GetId());
   uint32_t minId = GetMin (a->GetNode()->GetId(),b->GetNode()->GetId());
-  UpdateShadowingSpline (maxId,minId);
-  ShadowingSpline* shadowSpline = m_shadowingSpline[maxId]->at(minId);
+  ShadowingSpline* shadowSpline = GetShadowingSpline (maxId,minId);
   
   double speed = 0.0, distmax = 10000.0, std_db = 0.0, PrShadow;
   if (a->GetDistanceFrom(b) < distmax) 
@@ -157,8 +147,7 @@ ShadowingModel::GetLosCorrelatedShadowing (Ptr<MobilityModel> a, Ptr<MobilityMod
 {
   uint32_t maxId = GetMax (a->GetNode()->GetId(),b->GetNode()->GetId());
   uint32_t minId = GetMin (a->GetNode()->GetId(),b->GetNode()->GetId());
-  UpdateShadowingSpline (maxId,minId);
-  ShadowingSpline* shadowSpline = m_shadowingSpline[maxId]->at(minId);
+  ShadowingSpline* shadowSpline = GetShadowingSpline (maxId,minId);
   
   double speed = 0.0, distmax = 10000.0, std_db = 0.0, PrShadow;
   if (a->GetDistanceFrom(b) < distmax) 
@@ -181,38 +170,98 @@ ShadowingModel::CalculateSpeed (Vector speed)
   return sqrt(speed.x*speed.x+speed.y*speed.y+speed.z*speed.z);
 }
 
+ShadowingModel::LinkId
+ShadowingModel::GetLinkId (uint32_t minId, uint32_t maxId)
+{
+  return (uint64_t (minId) << 32) | maxId;
+}
+
+ShadowingSpline*
+ShadowingModel::GetShadowingSpline (uint32_t maxId, uint32_t minId)
+{
+  ExpireIdleLinks ();
+  LinkId linkId = GetLinkId (minId, maxId);
+  ShadowingLinks::iterator link = m_shadowingLinks.find (linkId);
+  if (link == m_shadowingLinks.end ())
+    {
+      NS_LOG_DEBUG ("Creating new link in ShadowingSpline for the pair of nodes = ("<<maxId<<","<<minId<<")");
+      ShadowingLink newLink;
+      newLink.spline = new ShadowingSpline ();
+      link = m_shadowingLinks.insert (std::make_pair (linkId, newLink)).first;
+      m_nodeLinks[minId].insert (maxId);
+      m_nodeLinks[maxId].insert (minId);
+    }
+  link->second.lastAccess = Simulator::Now ();
+  return link->second.spline;
+}
+
 void
-ShadowingModel::UpdateShadowingSpline (uint32_t maxId, uint32_t minId) 
+ShadowingModel::RemoveLink (ShadowingLinks::iterator link)
 {
-  if (maxId + 1 > m_shadowingSpline.size ())
+  uint32_t minId = link->first >> 32;
+  uint32_t maxId = link->first & 0xffffffff;
+  NS_LOG_DEBUG ("Removing link in ShadowingSpline for the pair of nodes = ("<<maxId<<","<<minId<<")");
+  delete link->second.spline;
+  m_shadowingLinks.erase (link);
+  std::map<uint32_t, std::set<uint32_t> >::iterator peers = m_nodeLinks.find (minId);
+  if (peers != m_nodeLinks.end ())
     {
-      NS_LOG_DEBUG ("Creating ShadowingSpline for node ID = "<<maxId);
-      while (maxId + 1 > m_shadowingSpline.size ())
+      peers->second.erase (maxId);
+      if (peers->second.empty ())
         {
-          m_shadowingSpline.push_back (NULL);
+          m_nodeLinks.erase (peers);
         }
-      m_shadowingSpline[maxId] = new ShadowingLinks ();
     }
-  else if (m_shadowingSpline[maxId] == NULL)
+  peers = m_nodeLinks.find (maxId);
+  if (peers != m_nodeLinks.end ())
     {
-      NS_LOG_DEBUG ("Creating ShadowingSpline for node ID = "<<maxId);
-      m_shadowingSpline[maxId] = new ShadowingLinks ();
+      peers->second.erase (minId);
+      if (peers->second.empty ())
+        {
+          m_nodeLinks.erase (peers);
+        }
     }
-  NS_ASSERT_MSG  (m_shadowingSpline[maxId],"maxId="<<maxId<<" m_shadowingSpline.size()="<<m_shadowingSpline.size ());
-  UpdateShadowingLinks (m_shadowingSpline[maxId], maxId, minId);
 }
 
-void 
-ShadowingModel::UpdateShadowingLinks (ShadowingLinks* shadowingLinks, uint32_t maxId, uint32_t minId) 
+void
+ShadowingModel::ExpireIdleLinks (void)
 {
-  while (shadowingLinks->size () != maxId)
+  // The links are swept at most once per timeout period
+  Time now = Simulator::Now ();
+  if (m_linkTimeout.IsZero () || now - m_lastExpiry < m_linkTimeout)
     {
-      shadowingLinks->push_back (NULL);
+      return;
     }
-  if (shadowingLinks->at(minId) == NULL)
+  m_lastExpiry = now;
+  for (ShadowingLinks::iterator it = m_shadowingLinks.begin (); it != m_shadowingLinks.end (); )
     {
-      NS_LOG_DEBUG ("Creating new link in ShadowingSpline for the pair of nodes = ("<<maxId<<","<<minId<<")");
-      shadowingLinks->at(minId) =  new ShadowingSpline ();
+      if (now - it->second.lastAccess > m_linkTimeout)
+        {
+          RemoveLink (it++);
+        }
+      else
+        {
+          ++it;
+        }
+    }
+}
+
+void
+ShadowingModel::RemoveNodeLinks (uint32_t nodeId)
+{
+  std::map<uint32_t, std::set<uint32_t> >::iterator peers = m_nodeLinks.find (nodeId);
+  if (peers == m_nodeLinks.end ())
+    {
+      return;
+    }
+  std::set<uint32_t> peerIds = peers->second;
+  for (std::set<uint32_t>::const_iterator it = peerIds.begin (); it != peerIds.end (); ++it)
+    {
+      ShadowingLinks::iterator link = m_shadowingLinks.find (GetLinkId (std::min (nodeId, *it), std::max (nodeId, *it)));
+      if (link != m_shadowingLinks.end ())
+        {
+          RemoveLink (link);
+        }
     }
 }
 
@@ -26,8 +26,11 @@
 #include "ns3/object.h"
 #include "ns3/random-variable.h"
 #include "ns3/mobility-model.h"
+#include "ns3/nstime.h"
+#include "ns3/sgi-hashmap.h"
 #include "shadowing-spline.h"
 #include <map>
+#include <set>
 
 namespace ns3 {
 
@@ -43,6 +46,10 @@ public:
   void SetNLosStd (double nLosStd);
   void SetIsCorrelatedShadowing (bool correlatedShadowing);
   bool IsCorrelatedShadowing (void);
+  /**
+   * Drop the correlated shadowing links of a node, e.g. when the node is deactivated
+   */
+  void RemoveNodeLinks (uint32_t nodeId);
 
 protected:
   double GetMin (double num1, double num2) const;
@@ -50,8 +57,26 @@ protected:
 
 private:
 
-  typedef std::vector<ShadowingSpline*> ShadowingLinks;
-  std::vector<ShadowingLinks*> m_shadowingSpline;
+  typedef uint64_t LinkId; // minId in the upper 32 bits, maxId in the lower ones
+  struct LinkIdHash
+  {
+    size_t operator() (LinkId linkId) const
+    {
+      return static_cast<size_t> (linkId ^ (linkId >> 32));
+    }
+  };
+  typedef struct {
+    ShadowingSpline* spline;
+    Time lastAccess;
+  } ShadowingLink;
+  typedef sgi::hash_map<LinkId, ShadowingLink, LinkIdHash> ShadowingLinks;
+
+  /**
+   * Correlated shadowing of the pairs of nodes that have exchanged packets. Links idle for more than
+   * m_linkTimeout are dropped, m_nodeLinks keeps the peers of every node to drop its links at once
+   */
+  ShadowingLinks m_shadowingLinks;
+  std::map<uint32_t, std::set<uint32_t> > m_nodeLinks;
 
   ShadowingModel (const ShadowingModel &o);
   ShadowingModel & operator = (const ShadowingModel &o);
@@ -61,13 +86,17 @@ private:
   double ConvertToDb (double shadow) const;
   double GetLosCorrelatedShadowing (Ptr<MobilityModel> a, Ptr<MobilityModel> b);
   double GetNLosCorrelatedShadowing (Ptr<MobilityModel> a, Ptr<MobilityModel> b);
-  void UpdateShadowingSpline (uint32_t maxId, uint32_t minId);
-  void UpdateShadowingLinks (ShadowingLinks* shadowingLinks, uint32_t maxId, uint32_t minId);
+  static LinkId GetLinkId (uint32_t minId, uint32_t maxId);
+  ShadowingSpline* GetShadowingSpline (uint32_t maxId, uint32_t minId);
+  void RemoveLink (ShadowingLinks::iterator link);
+  void ExpireIdleLinks (void);
   double CalculateSpeed (Vector speed);
 
   bool m_correlatedShadowing;
   double m_losStd;
   double m_nLosStd;
+  Time m_linkTimeout;
+  Time m_lastExpiry;
   float *m_shadowingHFilt; // Filter coefficients
 
   RandomVariable* m_lossShadowing;
@@ -50,7 +50,11 @@ void ShadowingSpline::Reset()
 
 ShadowingSpline::~ShadowingSpline()
 {
-
+	// Release the samples of an active link
+	if (initSh_ && shadowingStepTime_ > 0.0001) {
+		delete[] shadowingX_filt_;
+		DeleteSpline();
+	}
 }
 
 float ShadowingSpline::GetSample(double std_db, double speed, float *shadowingH_filt_, float current_t, RandomVariable *ranVar)
@@ -141,6 +145,8 @@ void ShadowingSpline::Init(double speed, float *shadowingH_filt_, float current_
 	      	}
 	
 	   InitSpline(x,y,shadowingW_filt_); // this will make init = 1.0 (spline.cc)
+	   delete[] x;
+	   delete[] y;
 
 }
 